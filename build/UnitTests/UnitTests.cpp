@@ -2,6 +2,12 @@
 #include "CppUnitTest.h"
 #include "../../src/Game/engine/Math.h"
 #include "../../src/Game/engine/Spatial.h"
+#include "../../src/Game/engine/SpatialBatch.h"
+#include "../../src/Game/engine/CollisionMatrix.h"
+#include "../../src/Game/engine/FixedTimestep.h"
+
+#include <random>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Engine;
@@ -265,4 +271,282 @@ namespace UnitTests
 			Assert::AreEqual(false, a != b);
 		}
 	};
+
+	TEST_CLASS(TestRectSweep)
+	{
+	public:
+		TEST_METHOD(RectFirstOverlapStepAhead)
+		{
+			const Recti a = Recti(0, 0, 10, 10);
+			const Recti wall = Recti(15, 0, 5, 10);
+			// Touching at 5, overlapping from 6
+			Assert::AreEqual(6, a.firstOverlapStep(wall, Vec2i(1, 0), 20));
+			Assert::AreEqual(0, a.firstOverlapStep(wall, Vec2i(1, 0), 5));
+			Assert::AreEqual(0, a.firstOverlapStep(wall, Vec2i(-1, 0), 20));
+		}
+
+		TEST_METHOD(RectFirstOverlapStepBehind)
+		{
+			const Recti a = Recti(0, 0, 10, 10);
+			const Recti wall = Recti(-8, 4, 4, 20);
+			Assert::AreEqual(5, a.firstOverlapStep(wall, Vec2i(-1, 0), 20));
+			Assert::AreEqual(0, a.firstOverlapStep(wall, Vec2i(0, 1), 20));
+		}
+
+		TEST_METHOD(RectFirstOverlapStepNoOverlapOnOtherAxis)
+		{
+			const Recti a = Recti(0, 0, 10, 10);
+			// Right beside the path, only touching
+			const Recti wall = Recti(20, 10, 5, 5);
+			Assert::AreEqual(0, a.firstOverlapStep(wall, Vec2i(1, 0), 100));
+		}
+
+		TEST_METHOD(RectFirstOverlapStepAlreadyOverlapping)
+		{
+			const Recti a = Recti(0, 0, 10, 10);
+			const Recti wall = Recti(5, 5, 20, 20);
+			Assert::AreEqual(1, a.firstOverlapStep(wall, Vec2i(0, 1), 3));
+			Assert::AreEqual(1, a.firstOverlapStep(wall, Vec2i(0, -1), 3));
+		}
+	};
+
+	// Batched rect and line tests have to give exactly what the scalar templates do, item for item
+	TEST_CLASS(TestSpatialBatch)
+	{
+		// Small coordinates, so plenty of rects touch, share edges and lines run along them
+		static RectBatch randomRects(std::mt19937 &random, int rectCount)
+		{
+			std::uniform_int_distribution<int> pos(-40, 40);
+			std::uniform_int_distribution<int> size(0, 30);
+
+			RectBatch rects;
+			for (int i = 0; i < rectCount; i++)
+			{
+				rects.push(Recti(pos(random), pos(random), size(random), size(random)));
+			}
+			return rects;
+		}
+
+		static Linei randomLine(std::mt19937 &random)
+		{
+			std::uniform_int_distribution<int> pos(-50, 50);
+			return Linei(Vec2i(pos(random), pos(random)), Vec2i(pos(random), pos(random)));
+		}
+
+		// One more than a multiple of every lane width, so the leftovers go through the scalar tail
+		static constexpr int itemCount = 8 * 16 + 1;
+
+	public:
+		TEST_METHOD(OverlapsMatchScalar)
+		{
+			std::mt19937 random(1);
+			std::vector<uint64_t> mask;
+			std::vector<uint64_t> scalarMask;
+
+			for (int run = 0; run < 50; run++)
+			{
+				const RectBatch rects = randomRects(random, itemCount);
+				const Recti rect = randomRects(random, 1).get(0);
+
+				size_t hits = SpatialBatch::overlaps(rect, rects, mask);
+				size_t scalarHits = SpatialBatch::overlaps<SpatialBatch::ScalarLanes>(rect, rects, scalarMask);
+
+				size_t expected = 0;
+				for (int i = 0; i < itemCount; i++)
+				{
+					const bool overlaps = rect.overlaps(rects.get(i));
+					expected += overlaps ? 1 : 0;
+					Assert::AreEqual(overlaps, SpatialBatch::maskTest(mask, i));
+				}
+				Assert::AreEqual(expected, hits);
+				Assert::AreEqual(expected, scalarHits);
+				Assert::IsTrue(mask == scalarMask);
+			}
+		}
+
+		TEST_METHOD(LineIntersectsLineMatchScalar)
+		{
+			std::mt19937 random(2);
+			std::vector<uint64_t> mask;
+			std::vector<uint64_t> scalarMask;
+
+			for (int run = 0; run < 50; run++)
+			{
+				LineBatch lines;
+				for (int i = 0; i < itemCount; i++)
+				{
+					lines.push(randomLine(random));
+				}
+				// Collinear, overlapping, touching at an end and a single point
+				lines.push(Linei(Vec2i(-10, 0), Vec2i(10, 0)));
+				lines.push(Linei(Vec2i(10, 0), Vec2i(20, 0)));
+				lines.push(Linei(Vec2i(0, 0), Vec2i(0, 0)));
+
+				const Linei line = run == 0 ? Linei(Vec2i(0, 0), Vec2i(10, 0)) : randomLine(random);
+
+				SpatialBatch::intersects(line, lines, mask);
+				SpatialBatch::intersects<SpatialBatch::ScalarLanes>(line, lines, scalarMask);
+
+				for (size_t i = 0; i < lines.size(); i++)
+				{
+					Assert::AreEqual(line.intersects(lines.get(i)), SpatialBatch::maskTest(mask, i));
+				}
+				Assert::IsTrue(mask == scalarMask);
+			}
+		}
+
+		TEST_METHOD(LineIntersectsRectMatchScalar)
+		{
+			std::mt19937 random(3);
+			std::vector<uint64_t> mask;
+			std::vector<uint64_t> scalarMask;
+
+			for (int run = 0; run < 50; run++)
+			{
+				const RectBatch rects = randomRects(random, itemCount);
+				const Linei line = randomLine(random);
+
+				SpatialBatch::intersects(line, rects, mask);
+				SpatialBatch::intersects<SpatialBatch::ScalarLanes>(line, rects, scalarMask);
+
+				for (int i = 0; i < itemCount; i++)
+				{
+					Assert::AreEqual(line.intersects(rects.get(i)), SpatialBatch::maskTest(mask, i));
+				}
+				Assert::IsTrue(mask == scalarMask);
+			}
+		}
+
+		TEST_METHOD(IntersectsClosestMatchesScalarLoop)
+		{
+			std::mt19937 random(4);
+			std::vector<uint64_t> mask;
+
+			for (int run = 0; run < 50; run++)
+			{
+				const RectBatch rects = randomRects(random, itemCount);
+				const Linei line = randomLine(random);
+				const Vec2i pos = line.a;
+
+				// How UpdatePlayer picked its grapple target
+				int expected = -1;
+				float closestLength = -1;
+				Vec2i expectedPoint;
+				for (int i = 0; i < itemCount; i++)
+				{
+					Vec2i point;
+					if (line.intersectsClosest(pos, rects.get(i), &point))
+					{
+						float length = (pos - point).lengthSquared();
+						if (closestLength < 0 || length < closestLength)
+						{
+							closestLength = length;
+							expectedPoint = point;
+							expected = i;
+						}
+					}
+				}
+
+				Vec2i point;
+				Assert::AreEqual(expected, SpatialBatch::intersectsClosest(line, pos, rects, mask, &point));
+				if (expected >= 0)
+				{
+					Assert::IsTrue(point == expectedPoint);
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(TestCollisionMatrix)
+	{
+	public:
+		TEST_METHOD(EverythingInteractsByDefault)
+		{
+			CollisionMatrix matrix;
+			Assert::IsTrue(matrix.interacts(0, 0));
+			Assert::IsTrue(matrix.interacts(3, 31));
+			Assert::AreEqual(UINT32_MAX, matrix.mask(7));
+		}
+
+		TEST_METHOD(SetGoesBothWays)
+		{
+			CollisionMatrix matrix;
+			matrix.clearAll();
+			matrix.set(2, 5, true);
+
+			Assert::IsTrue(matrix.interacts(2, 5));
+			Assert::IsTrue(matrix.interacts(5, 2));
+			Assert::IsFalse(matrix.interacts(2, 2));
+			Assert::AreEqual(CollisionMatrix::bit(5), matrix.mask(2));
+
+			matrix.set(5, 2, false);
+			Assert::IsFalse(matrix.interacts(2, 5));
+			Assert::AreEqual(0u, matrix.mask(5));
+		}
+
+		TEST_METHOD(ClearOneLayer)
+		{
+			CollisionMatrix matrix;
+			matrix.clear(4);
+
+			Assert::AreEqual(0u, matrix.mask(4));
+			Assert::IsFalse(matrix.interacts(0, 4));
+			Assert::IsTrue(matrix.interacts(0, 3));
+		}
+	};
+
+	TEST_CLASS(TestFixedTimestep)
+	{
+	public:
+		TEST_METHOD(FramesAddUpToTicks)
+		{
+			// Ticks of a quarter second, so every value here is exact
+			FixedTimestep timestep(4.0f, 4);
+
+			Assert::AreEqual(0, timestep.advance(0.125f));
+			Assert::AreEqual(0.5f, timestep.interpolation());
+
+			Assert::AreEqual(1, timestep.advance(0.125f));
+			Assert::AreEqual(0.0f, timestep.interpolation());
+
+			Assert::AreEqual(2, timestep.advance(0.625f));
+			Assert::AreEqual(0.5f, timestep.interpolation());
+		}
+
+		TEST_METHOD(SlowFramesAreCapped)
+		{
+			FixedTimestep timestep(4.0f, 2);
+
+			// Five ticks' worth, only two run and everything past the leftover is dropped
+			Assert::AreEqual(2, timestep.advance(1.375f));
+			Assert::AreEqual(0.5f, timestep.interpolation());
+			Assert::AreEqual(0.75f, timestep.droppedSeconds());
+
+			// Back to normal on the next frame
+			Assert::AreEqual(1, timestep.advance(0.125f));
+		}
+
+		TEST_METHOD(SameTicksWhateverTheFrameRate)
+		{
+			FixedTimestep steady(4.0f, 4);
+			FixedTimestep jittery(4.0f, 4);
+
+			int steadyTicks = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				steadyTicks += steady.advance(0.25f);
+			}
+
+			const float frames[] = { 0.125f, 0.5f, 0.0625f, 0.8125f, 0.25f, 0.75f, 0.625f, 0.875f };
+			int jitteryTicks = 0;
+			for (float frame : frames)
+			{
+				jitteryTicks += jittery.advance(frame);
+			}
+
+			Assert::AreEqual(16, steadyTicks);
+			Assert::AreEqual(steadyTicks, jitteryTicks);
+			Assert::AreEqual(0.0f, jittery.droppedSeconds());
+		}
+	};
 }
@@ -13,27 +13,45 @@ using namespace GS;
 
 Entity Factory::solid(Scene *scene, const Vec2i &pos, const Vec2i &shape)
 {
-	Entity ent = scene->createEntity();
-	Solid solid;
-	Transform2D transform;
-	Collider2D collider;
+	using SolidPrefab = Prefab<Solid, Collider2D, Transform2D>;
+	static const SolidPrefab prefab = []()
+		{
+			SolidPrefab prefab;
+			prefab.get<Collider2D>().layer = Layer::Wall;
+			return prefab;
+		}();
 
-	transform.pos = pos;
-	collider.rect = Recti(pos, shape);
+	return scene->spawn(prefab, [&](Entity, SolidPrefab &solid)
+		{
+			solid.get<Transform2D>().pos = pos;
+			solid.get<Collider2D>().rect = Recti(pos, shape);
+		});
+}
 
-	scene->addComponent(ent, solid);
-	scene->addComponent(ent, collider);
-	scene->addComponent(ent, transform);
+Entity Factory::solidGrapplable(Scene *scene, const Vec2i &pos, const Vec2i &shape)
+{
+	using SolidGrapplablePrefab = Prefab<Solid, Collider2D, Transform2D, Grapplable>;
+	static const SolidGrapplablePrefab prefab = []()
+		{
+			SolidGrapplablePrefab prefab;
+			prefab.get<Collider2D>().layer = Layer::Wall;
+			return prefab;
+		}();
 
-	return ent;
+	return scene->spawn(prefab, [&](Entity, SolidGrapplablePrefab &solid)
+		{
+			solid.get<Transform2D>().pos = pos;
+			solid.get<Collider2D>().rect = Recti(pos, shape);
+		});
 }
 
-Entity Factory::solidGrapplable(Scene *scene, const Vec2i &pos, const Vec2i &shape)
+Entity Factory::tilemap(Scene *scene, const Vec2i &origin, int tileSize, const Vec2i &cells)
 {
-	Entity ent = solid(scene, pos, shape);
+	Entity ent = scene->createEntity();
 
-	Grapplable grapplable;
-	scene->addComponent(ent, grapplable);
+	Tilemap tilemap;
+	TilemapCommon::resize(tilemap, origin, tileSize, cells.x, cells.y);
+	scene->addComponent(ent, std::move(tilemap));
 
 	return ent;
 }
@@ -41,44 +59,34 @@ Entity Factory::solidGrapplable(Scene *scene, const Vec2i &pos, const Vec2i &sha
 Entity Factory::player(Scene *scene, const Vec2i &pos)
 {
 	constexpr Vec2i spriteOrigin = Vec2i(11, 28);
-	Entity ent = scene->createEntity();
-
-	Mover2D mover;
-	UID uid;
-	Player player;
-	Solid solid;
-	Animator animator;
-	Transform2D transform;
-	Collider2D collider;
-	Shadow shadow;
-	Gravity gravity;
-
-	animator.sprite = &Content::sprPlayer;
-	animator.lerpOffset = true;
-	animator.lerpOffsetFac = 0.4;
-	AnimatorCommon::setOrigin(animator, spriteOrigin);
-
-	transform.pos = pos;
 
-	float colliderHeight = animator.sprite->GetHeight() * 0.6f;
-	collider.rect = Recti(
-		pos.x - spriteOrigin.x,
-		pos.y - spriteOrigin.y + (animator.sprite->GetHeight() - colliderHeight),
-		animator.sprite->GetWidth(), colliderHeight);
+	using PlayerPrefab = Prefab<Transform2D, Collider2D, Animator, Mover2D, UID, Player, Solid, Shadow, Gravity>;
+	static const PlayerPrefab prefab = [&]()
+		{
+			PlayerPrefab prefab;
 
-	shadow.offset = Vec2i(11, 33);
+			Animator &animator = prefab.get<Animator>();
+			animator.sprite = &Content::sprPlayer;
+			animator.lerpOffset = true;
+			animator.lerpOffsetFac = 0.4;
+			AnimatorCommon::setOrigin(animator, spriteOrigin);
 
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, collider);
-	scene->addComponent(ent, animator);
-	scene->addComponent(ent, mover);
-	scene->addComponent(ent, uid);
-	scene->addComponent(ent, player);
-	scene->addComponent(ent, solid);
-	scene->addComponent(ent, shadow);
-	scene->addComponent(ent, gravity);
+			prefab.get<Shadow>().offset = Vec2i(11, 33);
+			prefab.get<Collider2D>().layer = Layer::Player;
+			return prefab;
+		}();
 
-	return ent;
+	return scene->spawn(prefab, [&](Entity, PlayerPrefab &player)
+		{
+			player.get<Transform2D>().pos = pos;
+
+			Sprite *sprite = player.get<Animator>().sprite;
+			float colliderHeight = sprite->GetHeight() * 0.6f;
+			player.get<Collider2D>().rect = Recti(
+				pos.x - spriteOrigin.x,
+				pos.y - spriteOrigin.y + (sprite->GetHeight() - colliderHeight),
+				sprite->GetWidth(), colliderHeight);
+		});
 }
 
 Engine::Entity GS::Factory::cameraController(Engine::Scene *scene, const Engine::Vec2i &pos, const Vec2i &screenBounds)
@@ -99,112 +107,72 @@ Engine::Entity GS::Factory::cameraController(Engine::Scene *scene, const Engine:
 
 Engine::Entity GS::Factory::coin(Engine::Scene *scene, const Engine::Vec2i &pos)
 {
-	Entity ent = scene->createEntity();
-
-	Shadow shadow;
-
-	Coin coin;
-	coin.animOffset = Time::seconds;
-
-	Transform2D transform;
-	transform.pos = pos;
-
-	Animator animator;
-	animator.sprite = &Content::sprCoin;
-	AnimatorCommon::setOrigin(animator, Sprite::Origin::BottomMiddle);
+	using CoinPrefab = Prefab<Shadow, Coin, Animator, Transform2D, Collider2D, Mover2D, Gravity, Activity>;
+	static const CoinPrefab prefab = []()
+		{
+			CoinPrefab prefab;
 
-	Collider2D collider;
-	collider.rect = Recti(
-		pos - animator.sprite->GetSize() / 2,
-		animator.sprite->GetSize());
+			Animator &animator = prefab.get<Animator>();
+			animator.sprite = &Content::sprCoin;
+			AnimatorCommon::setOrigin(animator, Sprite::Origin::BottomMiddle);
 
-	Gravity gravity;
-	gravity.zVelocity = -15.0f;
-	gravity.peakVelocity = gravity.zVelocity;
+			Gravity &gravity = prefab.get<Gravity>();
+			gravity.zVelocity = -15.0f;
+			gravity.peakVelocity = gravity.zVelocity;
 
-	Mover2D mover;
-	float spd = 5.0f;
-	mover.velocity = Vec2f(
-		Math::randRange(-spd, spd),
-		Math::randRange(-spd, spd));
+			prefab.get<Collider2D>().layer = Layer::Coin;
+			return prefab;
+		}();
 
-	// Bounce on collision
-	auto xCallback = [ent, scene](Entity collidingEntity)
-		{
-			auto &coin = scene->getComponent<Coin>(ent);
-			
-			// Pickup coins
-			if (scene->hasComponent<Player>(collidingEntity) && coin.destroytimer > 200)
-			{
-				scene->queueDestroy(ent);
-			}
-
-			auto &mover = scene->getComponent<Mover2D>(ent);
-			mover.velocity.x = mover.velocityBeforeCollision.x * -1;
-		};
-	auto yCallback = [ent, scene](Entity collidingEntity)
+	return scene->spawn(prefab, [&](Entity, CoinPrefab &coin)
 		{
-			auto &coin = scene->getComponent<Coin>(ent);
-
-			// Pickup coins
-			if (scene->hasComponent<Player>(collidingEntity) && coin.destroytimer > 200)
-			{
-				scene->queueDestroy(ent);
-			}
-
-			auto &mover = scene->getComponent<Mover2D>(ent);
-			mover.velocity.y = mover.velocityBeforeCollision.y * -1;
-		};
-	Mover2DCommon::setOnCollideX(mover, xCallback);
-	Mover2DCommon::setOnCollideY(mover, yCallback);
-
-	scene->addComponent(ent, shadow);
-	scene->addComponent(ent, coin);
-	scene->addComponent(ent, animator);
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, collider);
-	scene->addComponent(ent, mover);
-	scene->addComponent(ent, gravity);
-
-	return ent;
+			coin.get<Coin>().animOffset = Time::seconds;
+			coin.get<Transform2D>().pos = pos;
+
+			Sprite *sprite = coin.get<Animator>().sprite;
+			coin.get<Collider2D>().rect = Recti(
+				pos - sprite->GetSize() / 2,
+				sprite->GetSize());
+
+			Mover2D &mover = coin.get<Mover2D>();
+			float spd = 5.0f;
+			mover.velocity = Vec2f(
+				Math::randRange(-spd, spd),
+				Math::randRange(-spd, spd));
+		});
 }
 
 Engine::Entity GS::Factory::ceilingHook(Engine::Scene *scene, const Engine::Vec2i &pos, int z, bool intro)
 {
-	Entity ent = scene->createEntity();
-
-	CeilingHook ceilHook;
-	Transform2D transform;
-	Collider2D collider;
-	Animator animator;
-	Grapplable grapplable;
-	Shadow shadow;
-	UID uid;
-
-	ceilHook.intro = intro;
+	using CeilingHookPrefab = Prefab<CeilingHook, Transform2D, Collider2D, Animator, Grapplable, Shadow, UID>;
+	static const CeilingHookPrefab prefab = []()
+		{
+			CeilingHookPrefab prefab;
 
-	animator.sprite = &Content::sprCeilingHook;
-	AnimatorCommon::setOrigin(animator, Sprite::Origin::BottomMiddle);
+			Animator &animator = prefab.get<Animator>();
+			animator.sprite = &Content::sprCeilingHook;
+			AnimatorCommon::setOrigin(animator, Sprite::Origin::BottomMiddle);
 
-	animator.lerpOffset = true;
-	animator.lerpOffsetFac = 0.4;
+			animator.lerpOffset = true;
+			animator.lerpOffsetFac = 0.4;
 
-	transform.pos = pos;
-	transform.z = z;
+			prefab.get<Collider2D>().layer = Layer::Hook;
+			return prefab;
+		}();
 
-	collider.rect = Recti(
-		pos - Vec2i(animator.sprite->GetWidth() / 2, animator.sprite->GetHeight() + transform.z),
-		animator.sprite->GetSize());
+	return scene->spawn(prefab, [&](Entity, CeilingHookPrefab &ceilHook)
+		{
+			ceilHook.get<CeilingHook>().intro = intro;
 
-	scene->addComponent(ent, ceilHook);
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, collider);
-	scene->addComponent(ent, animator);
-	scene->addComponent(ent, grapplable);
-	scene->addComponent(ent, shadow);
-	scene->addComponent(ent, uid);
+			Transform2D &transform = ceilHook.get<Transform2D>();
+			transform.pos = pos;
+			transform.z = z;
 
-	return ent;
+			Sprite *sprite = ceilHook.get<Animator>().sprite;
+			ceilHook.get<Collider2D>().rect = Recti(
+				pos - Vec2i(sprite->GetWidth() / 2, sprite->GetHeight() + transform.z),
+				sprite->GetSize());
+		});
 }
 
 Engine::Entity GS::Factory::transition(Engine::Scene *scene, int type, std::function<void(void)> callback)
@@ -222,32 +190,33 @@ Engine::Entity GS::Factory::transition(Engine::Scene *scene, int type, std::func
 
 Engine::Entity GS::Factory::enemy(Engine::Scene *scene, const Engine::Vec2i &pos)
 {
-	Entity ent = scene->createEntity();
+	using EnemyPrefab = Prefab<Enemy, Animator, Collider2D, Transform2D, Grapplable, Shadow, Activity>;
+	static const EnemyPrefab prefab = []()
+		{
+			EnemyPrefab prefab;
 
-	Enemy enemy;
-	Animator animator;
-	Collider2D collider;
-	Transform2D transform;
-	Grapplable grapplable;
-	Shadow shadow;
+			// Off screen enemies still have to close in on the player, just less often
+			prefab.get<Activity>().deepest = Activity::Level::Slow;
 
-	enemy.spawnTime = Time::seconds;
-	enemy.moveSpd = Math::randRange(2.0f, 5.5f);
+			Animator &animator = prefab.get<Animator>();
+			animator.sprite = &Content::sprSkull;
+			AnimatorCommon::setOrigin(animator, Sprite::Origin::BottomMiddle);
 
-	transform.pos = pos;
+			prefab.get<Collider2D>().layer = Layer::Enemy;
+			return prefab;
+		}();
 
-	animator.sprite = &Content::sprSkull;
-	AnimatorCommon::setOrigin(animator, Sprite::Origin::BottomMiddle);
+	Entity ent = scene->spawn(prefab, [&](Entity, EnemyPrefab &enemy)
+		{
+			enemy.get<Enemy>().spawnTime = Time::seconds;
+			enemy.get<Enemy>().moveSpd = Math::randRange(2.0f, 5.5f);
 
-	collider.rect = Recti(pos - Vec2i(animator.sprite->GetWidth() / 2, animator.sprite->GetHeight()),
-		animator.sprite->GetSize());
+			enemy.get<Transform2D>().pos = pos;
 
-	scene->addComponent(ent, enemy);
-	scene->addComponent(ent, animator);
-	scene->addComponent(ent, collider);
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, grapplable);
-	scene->addComponent(ent, shadow);
+			Sprite *sprite = enemy.get<Animator>().sprite;
+			enemy.get<Collider2D>().rect = Recti(pos - Vec2i(sprite->GetWidth() / 2, sprite->GetHeight()),
+				sprite->GetSize());
+		});
 
 	Factory::smokeExplosion(scene, pos, 5);
 
@@ -265,121 +234,132 @@ Engine::Entity GS::Factory::enemyGen(Engine::Scene *scene)
 
 Entity Factory::smokeExplosion(Scene *scene, const Vec2i &pos, int particleCount)
 {
-	Entity ent = scene->createEntity();
-
-	Transform2D transform;
-	transform.pos = pos;
-
-	Particles2D pSystem;
-	pSystem.spritePool = {
-		&Content::sprSmoke1,
-		&Content::sprSmoke2 };
+	using EffectPrefab = Prefab<Transform2D, Particles2D, Activity>;
+	static const EffectPrefab prefab = []()
+		{
+			EffectPrefab prefab;
 
-	pSystem.particleCount = particleCount;
+			// Effects keep running out off screen, so they still get destroyed
+			prefab.get<Activity>().deepest = Activity::Level::Slow;
 
-	pSystem.particleLifeTimeMin = 20.0f / 60.0f;
-	pSystem.particleLifeTimeMax = 50.0f / 60.0f;
+			Particles2D &pSystem = prefab.get<Particles2D>();
+			pSystem.spritePool = {
+				&Content::sprSmoke1,
+				&Content::sprSmoke2 };
 
-	pSystem.velocityMin = Vec2f(-3, 0);
-	pSystem.velocityMax = Vec2f(3, 3);
+			pSystem.particleLifeTimeMin = 20.0f / 60.0f;
+			pSystem.particleLifeTimeMax = 50.0f / 60.0f;
 
-	pSystem.gravity = 0.1f;
-	pSystem.gravityDir = Vec2f(0.0, -1.0f);
+			pSystem.velocityMin = Vec2f(-3, 0);
+			pSystem.velocityMax = Vec2f(3, 3);
 
-	pSystem.rotationSpeedMin = -10.0f;
-	pSystem.rotationSpeedMax = 10.0f;
+			pSystem.gravity = 0.1f;
+			pSystem.gravityDir = Vec2f(0.0, -1.0f);
 
-	pSystem.scaleStartMin = 0.9f;
-	pSystem.scaleEndMin = 0.9f;
+			pSystem.rotationSpeedMin = -10.0f;
+			pSystem.rotationSpeedMax = 10.0f;
 
-	pSystem.scaleStartMax = 1.4f;
-	pSystem.scaleEndMax = 1.4f;
+			pSystem.scaleStartMin = 0.9f;
+			pSystem.scaleEndMin = 0.9f;
 
-	pSystem.colorEnd = Color::white;
-	pSystem.colorEnd.a = 0;
+			pSystem.scaleStartMax = 1.4f;
+			pSystem.scaleEndMax = 1.4f;
 
-	pSystem.oneShot = true;
+			pSystem.colorEnd = Color::white;
+			pSystem.colorEnd.a = 0;
 
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, pSystem);
+			pSystem.oneShot = true;
+			return prefab;
+		}();
 
-	return ent;
+	// Effects are often spawned mid-update, let the scene add them at the next sync point
+	return scene->queueSpawn(prefab, [&](Entity, EffectPrefab &effect)
+		{
+			effect.get<Transform2D>().pos = pos;
+			effect.get<Particles2D>().particleCount = particleCount;
+		});
 }
 
 Entity Factory::hookEffect(Scene *scene, const Vec2i &pos)
 {
-	Entity ent = scene->createEntity();
-
-	Transform2D transform;
-	transform.pos = pos;
-
-	Particles2D pSystem;
-	pSystem.spritePool = {
-		&Content::sprCeilingHookEffect };
+	using EffectPrefab = Prefab<Transform2D, Particles2D, Activity>;
+	static const EffectPrefab prefab = []()
+		{
+			EffectPrefab prefab;
+			prefab.get<Activity>().deepest = Activity::Level::Slow;
 
-	pSystem.particleCount = 1;
+			Particles2D &pSystem = prefab.get<Particles2D>();
+			pSystem.spritePool = {
+				&Content::sprCeilingHookEffect };
 
-	pSystem.particleLifeTimeMin = 0.25f;
-	pSystem.particleLifeTimeMax = pSystem.particleLifeTimeMin;
+			pSystem.particleCount = 1;
 
-	pSystem.gravity = 0.0f;
+			pSystem.particleLifeTimeMin = 0.25f;
+			pSystem.particleLifeTimeMax = pSystem.particleLifeTimeMin;
 
-	pSystem.rotationSpeedMin = 15.0f;
-	pSystem.rotationSpeedMax = pSystem.rotationSpeedMin;
+			pSystem.gravity = 0.0f;
 
-	pSystem.scaleStartMin = 1.0f;
-	pSystem.scaleStartMax = pSystem.scaleStartMin;
+			pSystem.rotationSpeedMin = 15.0f;
+			pSystem.rotationSpeedMax = pSystem.rotationSpeedMin;
 
-	pSystem.scaleEndMin = 6.0f;
-	pSystem.scaleEndMax = pSystem.scaleEndMin;
+			pSystem.scaleStartMin = 1.0f;
+			pSystem.scaleStartMax = pSystem.scaleStartMin;
 
-	pSystem.colorEnd = Color::white;
-	pSystem.colorEnd.a = 0;
+			pSystem.scaleEndMin = 6.0f;
+			pSystem.scaleEndMax = pSystem.scaleEndMin;
 
-	pSystem.oneShot = true;
+			pSystem.colorEnd = Color::white;
+			pSystem.colorEnd.a = 0;
 
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, pSystem);
+			pSystem.oneShot = true;
+			return prefab;
+		}();
 
-	return ent;
+	// Effects are often spawned mid-update, let the scene add them at the next sync point
+	return scene->queueSpawn(prefab, [&](Entity, EffectPrefab &effect)
+		{
+			effect.get<Transform2D>().pos = pos;
+		});
 }
 
 Engine::Entity GS::Factory::shockwaveEffect(Engine::Scene *scene, const Engine::Vec2i &pos)
 {
-	Entity ent = scene->createEntity();
-
-	Transform2D transform;
-	transform.pos = pos;
-
-	Particles2D pSystem;
-	pSystem.spritePool = {
-		&Content::sprCursorOuter };
-
-	pSystem.particleCount = 1;
+	using EffectPrefab = Prefab<Transform2D, Particles2D, Activity>;
+	static const EffectPrefab prefab = []()
+		{
+			EffectPrefab prefab;
+			prefab.get<Activity>().deepest = Activity::Level::Slow;
 
-	pSystem.particleLifeTimeMin = 0.2f;
-	pSystem.particleLifeTimeMax = pSystem.particleLifeTimeMin;
+			Particles2D &pSystem = prefab.get<Particles2D>();
+			pSystem.spritePool = {
+				&Content::sprCursorOuter };
 
-	pSystem.gravity = 0.0f;
+			pSystem.particleCount = 1;
 
-	pSystem.rotationSpeedMin = 15.0f;
-	pSystem.rotationSpeedMax = pSystem.rotationSpeedMin;
+			pSystem.particleLifeTimeMin = 0.2f;
+			pSystem.particleLifeTimeMax = pSystem.particleLifeTimeMin;
 
-	pSystem.scaleStartMin = 1.0f;
-	pSystem.scaleStartMax = pSystem.scaleStartMin;
+			pSystem.gravity = 0.0f;
 
-	pSystem.scaleEndMin = 8.0f;
-	pSystem.scaleEndMax = pSystem.scaleEndMin;
+			pSystem.rotationSpeedMin = 15.0f;
+			pSystem.rotationSpeedMax = pSystem.rotationSpeedMin;
 
-	pSystem.colorEnd = Color::white;
-	pSystem.colorEnd.a = 0;
+			pSystem.scaleStartMin = 1.0f;
+			pSystem.scaleStartMax = pSystem.scaleStartMin;
 
-	pSystem.oneShot = true;
+			pSystem.scaleEndMin = 8.0f;
+			pSystem.scaleEndMax = pSystem.scaleEndMin;
 
-	scene->addComponent(ent, transform);
-	scene->addComponent(ent, pSystem);
+			pSystem.colorEnd = Color::white;
+			pSystem.colorEnd.a = 0;
 
-	return ent;
+			pSystem.oneShot = true;
+			return prefab;
+		}();
 
-	return Engine::Entity();
+	// Effects are often spawned mid-update, let the scene add them at the next sync point
+	return scene->queueSpawn(prefab, [&](Entity, EffectPrefab &effect)
+		{
+			effect.get<Transform2D>().pos = pos;
+		});
 }
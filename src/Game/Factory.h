@@ -11,6 +11,8 @@ namespace GS
     {
         Engine::Entity solid(Engine::Scene *scene, const Engine::Vec2i &pos, const Engine::Vec2i &shape);
         Engine::Entity solidGrapplable(Engine::Scene *scene, const Engine::Vec2i &pos, const Engine::Vec2i &shape);
+        // Empty tilemap 'cells' wide and high, fill it in with TilemapCommon
+        Engine::Entity tilemap(Engine::Scene *scene, const Engine::Vec2i &origin, int tileSize, const Engine::Vec2i &cells);
 
         // Objects
         Engine::Entity player(Engine::Scene *scene, const Engine::Vec2i &pos);
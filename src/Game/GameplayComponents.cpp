@@ -3,7 +3,7 @@
 using namespace Engine;
 using namespace GS;
 
-void GS::registerGameplayComponents(Scene *scene)
+void GS::registerGameplayComponentTypes(Scene *scene)
 {
     // -- Components -- 
     scene->registerComponent<Animator>();
@@ -23,26 +23,18 @@ void GS::registerGameplayComponents(Scene *scene)
     scene->registerComponent<Transition>();
     scene->registerComponent<Enemy>();
     scene->registerComponent<EnemyGen>();
+    scene->registerComponent<Tilemap>();
+    scene->registerComponent<Activity>();
+
+    CollisionsCommon::setupLayers(scene->m_collisionMatrix);
+}
+
+void GS::registerGameplayComponents(Scene *scene)
+{
+    registerGameplayComponentTypes(scene);
 
     // -- Systems --
-    scene->registerSystem<UpdateAndDrawAnimator>();
-    scene->registerSystem<UpdateMoveAndCollide2D>();
-    scene->registerSystem<UpdateSolids>();
-    scene->registerSystem<UpdateUID>();
-    scene->registerSystem<UpdatePlayer>();
-    scene->registerSystem<UpdateGrapplable>();
-    scene->registerSystem<UpdateParticles2D>();
-    scene->registerSystem<UpdateCameraController>();
-    scene->registerSystem<UpdateCoin>();
-    scene->registerSystem<UpdateGravity>();
-    scene->registerSystem<UpdateCeilingHook>();
-    scene->registerSystem<UpdateEnemy>();
-    scene->registerSystem<UpdateEnemyGen>();
-    
-    scene->registerSystem<DrawPlayer>();
-    scene->registerSystem<DrawParticles2D>();
-    scene->registerSystem<DrawShadow>();
-    scene->registerSystem<DrawTransition>();
+    GamePipeline::registerSystems(scene);
 
     // DEBUG
     //scene->registerSystem<DrawCollider2D>();
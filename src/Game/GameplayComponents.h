@@ -18,11 +18,46 @@
 #include <components/Transition.h>
 #include <components/Enemy.h>
 #include <components/EnemyGen.h>
+#include <components/Tilemap.h>
+#include <components/Collisions.h>
+#include <components/Activity.h>
 
 #include <engine/ecs/Scene.h>
+#include <engine/ecs/SystemPipeline.h>
 
 namespace GS
 {
+    // Every gameplay system, in update order
+    using GamePipeline = Engine::SystemPipeline<
+        Engine::Phase<Engine::System::Type::PreUpdate,
+            UpdateTransformHistory,
+            UpdateActivity,
+            UpdateUID>,
+        Engine::Phase<Engine::System::Type::Update,
+            UpdateTilemap,
+            UpdateMoveAndCollide2D,
+            UpdateSolids,
+            UpdateGrapplable,
+            UpdateCollisions,
+            UpdatePlayer,
+            UpdateParticles2D,
+            UpdateCameraController,
+            UpdateCoin,
+            UpdateGravity,
+            UpdateCeilingHook,
+            UpdateEnemy,
+            UpdateEnemyGen>,
+        Engine::Phase<Engine::System::Type::Draw,
+            DrawTilemap,
+            DrawShadow,
+            UpdateAndDrawAnimator,
+            DrawPlayer,
+            DrawParticles2D,
+            DrawTransition>>;
+
+    // Register components only, for scenes running GamePipeline
+    void registerGameplayComponentTypes(Engine::Scene *scene);
+
     // Register components and systems
     void registerGameplayComponents(Engine::Scene *scene);
 }
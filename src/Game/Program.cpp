@@ -12,6 +12,7 @@
 #include "test/MoverTest.h"
 #include "test/PlayerTestScene.h"
 #include "test/ExampleScene.h"
+#include "test/BenchmarkScene.h"
 #include "scenes/GameScene.h"
 #include "scenes/TitleScene.h"
 
@@ -43,6 +44,7 @@ void Init()
 	// game.pushScene<SineTestScene>();
 	// game.pushScene<SpriteTestScene>();
 	// game.pushScene<MoverTestScene>();
+	// game.pushScene<BenchmarkScene>();
 
 	// game.pushScene<PlayerTestScene>();
 	game.pushScene<TitleScene>();
@@ -0,0 +1,22 @@
+#include "Activity.h"
+
+using namespace Engine;
+using namespace GS;
+
+const Activity *GS::ActivityCommon::find(Scene *scene, Entity ent)
+{
+    if (!scene->isRegistered<Activity>() || !scene->hasComponent<Activity>(ent))
+    {
+        return nullptr;
+    }
+    return &scene->readComponent<Activity>(ent);
+}
+
+int GS::ActivityCommon::ticks(Scene *scene, const Activity *activity)
+{
+    if (!activity || !scene->hasSystem<UpdateActivity>())
+    {
+        return 1;
+    }
+    return scene->getSystem<UpdateActivity>()->ticksFor(*activity);
+}
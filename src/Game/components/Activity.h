@@ -0,0 +1,199 @@
+#ifndef _ACTIVITY_H
+#define _ACTIVITY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <engine/ecs/System.h>
+#include <engine/ecs/Scene.h>
+#include <engine/ecs/EntitySet.h>
+#include <engine/Spatial.h>
+#include <engine/Time.h>
+
+namespace GS
+{
+    // How much of an entity is simulated, by how far it is from what the camera sees.
+    // Only meaningful with UpdateActivity in the scene, without it everything is awake every tick.
+    struct Activity
+    {
+        enum class Level : uint8_t
+        {
+            // On screen or close to it, updated every tick
+            Awake,
+            // Off screen, updated every few ticks with the time it missed
+            Slow,
+            // Far away, not updated and its time doesn't pass
+            Asleep,
+        };
+
+        // As of the last time UpdateActivity looked at it
+        Level level = Level::Awake;
+
+        // How far down it's allowed to go, things that have to keep going off screen use Slow
+        Level deepest = Level::Asleep;
+
+        // Past the slow margin, but not allowed to sleep
+        bool far = false;
+
+        // Which tick of every m_slowInterval it's checked on while it isn't awake, picked when it stops being awake
+        uint8_t slice = 0;
+
+        // Ticks of time its update covers, only valid on the tick it's due
+        uint8_t ticks = 1;
+
+        // Stays awake for this many more ticks wherever it is, see UpdateActivity::wake
+        uint16_t wakeTicks = 0;
+
+        // UpdateActivity's tick it last updated (or slept) on, and the tick it's due
+        uint32_t lastTick = 0;
+        uint32_t dueTick = 0;
+    };
+
+    // Sorts entities into awake, slow and asleep around the camera rect, and lists the ones due an update this tick.
+    // Runs in PreUpdate on the camera from the end of the last tick.
+    //
+    // Awake entities are checked every tick. The rest are only checked a slice at a time, each one every
+    // m_slowInterval ticks, so entities far from the camera cost next to nothing. That's also when slow ones
+    // update, with every tick since their last update. Slow ones past the slow margin (ones that can't sleep)
+    // only update every m_farInterval ticks. The awake margin covers how far the camera can move before an
+    // entity's next check, and a camera that jumps further than that has everything checked at once.
+    //
+    // Something awake touching a slow or sleeping entity (a collision Enter event) wakes it for a while.
+    class UpdateActivity : public Engine::System
+    {
+    public:
+        struct Counts
+        {
+            uint32_t awake = 0;
+            uint32_t resting = 0;
+            // Resting entities looked at this tick
+            uint32_t checked = 0;
+            uint32_t due = 0;
+        };
+
+        // Past the camera rect, in world pixels
+        int m_awakeMargin = 128;
+        int m_slowMargin = 640;
+
+        // A resting entity is checked (and a slow one updates) once every this many ticks
+        int m_slowInterval = 4;
+        // How often slow entities past the slow margin update, rounded up to a whole number of slow intervals
+        // Together with the slow interval it has to fit in Activity::ticks.
+        int m_farInterval = 16;
+
+        // How long a collision with something awake keeps an entity awake
+        int m_wakeTicks = 120;
+
+        // Last update's counts, for the debug console and benchmarks
+        Counts m_counts;
+
+        void init() override;
+        void update() override;
+        void entityAdded(Engine::Entity const &ent) override;
+        void entityRemoved(Engine::Entity const &ent) override;
+        void restored() override;
+
+        // Keep an entity awake for 'ticks' ticks from the next one
+        // Changes which list it's in, so not from systems running in parallel (ones that call setupAccess).
+        void wake(Engine::Entity ent, int ticks);
+
+        // Ticks an entity's update covers this tick, 0 if it isn't due
+        int ticksFor(const Activity &activity) const
+        {
+            return activity.dueTick == m_tick ? activity.ticks : 0;
+        }
+
+        // Calls func(Entity, const Activity &) for every entity in 'entities' due an update this tick
+        template <class F>
+        void forEachDue(const Engine::EntitySet &entities, F &&func)
+        {
+            for (Engine::Entity ent : m_due)
+            {
+                if (entities.contains(ent))
+                {
+                    // Whatever has this ID now may have been added after the list was made
+                    const Activity &activity = m_scene->readComponent<Activity>(ent);
+                    if (activity.dueTick == m_tick)
+                    {
+                        func(ent, activity);
+                    }
+                }
+            }
+        }
+
+        std::string report() const;
+
+    private:
+        // Checked every tick, and everything else by slice. An entity keeps its slice while it rests,
+        // so it's checked every m_slowInterval ticks however the others come and go.
+        Engine::EntitySet m_awake;
+        std::vector<Engine::EntitySet> m_resting;
+        uint32_t m_nextSlice = 0;
+
+        // Due this tick
+        std::vector<Engine::Entity> m_due;
+
+        // Entities changing set, moved after going through the sets
+        std::vector<Engine::Entity> m_moving;
+
+        class UpdateCollisions *m_updateCollisions = nullptr;
+        bool m_lookedUp = false;
+
+        uint32_t m_tick = 0;
+
+        // Where the camera was last update, to spot it jumping
+        Engine::Vec2i m_lastCameraPos;
+        // Check every entity next update
+        bool m_checkAll = true;
+
+        Engine::Recti m_awakeRect;
+        Engine::Recti m_slowRect;
+
+        Activity::Level levelOf(Activity &activity, const Engine::Vec2i &pos) const;
+        void makeDue(Engine::Entity ent, Activity &activity);
+        void rest(Engine::Entity ent, Activity &activity);
+        void resizeSlices();
+        void wakeFromCollisions();
+    };
+
+    namespace ActivityCommon
+    {
+        // The entity's activity, null if it doesn't have one (so it's always awake)
+        const Activity *find(Engine::Scene *scene, Engine::Entity ent);
+
+        // Ticks this tick's update of an entity covers, 0 to skip it. For systems that also update entities
+        // without an activity (null is always 1), ones where every entity has one can use forEachDue.
+        int ticks(Engine::Scene *scene, const Activity *activity);
+
+        // Calls func(Entity, const Activity &) for the entities of a system due an update this tick
+        // Every entity in 'entities' needs an Activity. Without UpdateActivity that's all of them.
+        template <class F>
+        void forEachDue(Engine::Scene *scene, const Engine::EntitySet &entities, F &&func)
+        {
+            if (scene->hasSystem<UpdateActivity>())
+            {
+                scene->getSystem<UpdateActivity>()->forEachDue(entities, func);
+                return;
+            }
+
+            for (Engine::Entity ent : entities)
+            {
+                func(ent, scene->readComponent<Activity>(ent));
+            }
+        }
+
+        // Time::delta and Time::deltaSeconds for the ticks its update covers
+        inline float delta(const Activity &activity)
+        {
+            return Time::delta * activity.ticks;
+        }
+
+        inline float deltaSeconds(const Activity &activity)
+        {
+            return Time::deltaSeconds * activity.ticks;
+        }
+    }
+}
+
+#endif // _ACTIVITY_H
@@ -12,7 +12,7 @@ namespace GS
 	struct CameraController
 	{
 		// Reference to player entity
-		uint32_t playerId = -1;
+		Engine::EntityHandle player;
 
 		Engine::Vec2i screenBounds;
 	};
@@ -21,7 +21,6 @@ namespace GS
 	class UpdateCameraController : public Engine::System
 	{
 	private:
-		UpdateUID *m_uidSys = nullptr;
 		UpdatePlayer *m_playerSys = nullptr;
 	public:
 		void init() override;
@@ -15,6 +15,8 @@ namespace GS
 	class UpdateCoin : public Engine::System
 	{
 	public:
+		class UpdateMoveAndCollide2D *m_updateMoveAndCollide = nullptr;
+
 		void init() override;
 		void update() override;
 	};
@@ -0,0 +1,198 @@
+#ifndef _COLLISIONS_H
+#define _COLLISIONS_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <engine/ecs/System.h>
+#include <engine/ecs/Scene.h>
+#include <engine/SpatialGrid.h>
+#include <engine/CollisionMatrix.h>
+#include <engine/EventBuffer.h>
+
+namespace GS
+{
+    // Collider2D::layer values for the game, see CollisionsCommon::setupLayers for what hits what
+    namespace Layer
+    {
+        enum : uint8_t
+        {
+            // Collides with everything, for colliders nobody gave a layer
+            Default = 0,
+            Wall,
+            Player,
+            Enemy,
+            Coin,
+            Projectile,
+            // Ceiling hooks are only ever grappled
+            Hook,
+
+            Count,
+        };
+    }
+
+    // Two colliders that overlap
+    struct Contact
+    {
+        Engine::Entity ent = Engine::NULL_ENTITY;
+        Engine::Entity other = Engine::NULL_ENTITY;
+        // Bit of the other collider's layer, it may be gone by the time anyone asks
+        uint32_t otherLayerBit = 0;
+
+        bool operator<(const Contact &rhs) const
+        {
+            return ent < rhs.ent || (ent == rhs.ent && other < rhs.other);
+        }
+    };
+
+    // A pair of colliders starting, carrying on or stopping overlapping, from one side of the pair
+    struct CollisionEvent
+    {
+        enum class Type : uint8_t
+        {
+            // Weren't overlapping last pass
+            Enter,
+            // Still overlapping
+            Stay,
+            // Overlapped last pass but not anymore, or one of them is gone
+            Exit,
+        };
+
+        Type type = Type::Stay;
+        Engine::Entity ent = Engine::NULL_ENTITY;
+        Engine::Entity other = Engine::NULL_ENTITY;
+        uint32_t otherLayerBit = 0;
+    };
+
+    // One overlap pass over every collider in the scene, instead of each system scanning for the pairs it cares about.
+    // Only pairs whose layers interact (Scene::m_collisionMatrix) are tested.
+    //
+    // The overlapping pairs are kept from one pass to the next. A pair where neither collider has been written to
+    // since the last pass can't have changed, so only colliders that changed are tested again.
+    // Comparing the pairs with last pass's gives the Enter/Stay/Exit events in m_events.
+    class UpdateCollisions : public Engine::System
+    {
+    public:
+        enum class PassMode
+        {
+            // Test every collider every pass
+            Full,
+            // Only test colliders that changed since the last pass, keep the rest of the pairs
+            Incremental,
+        };
+
+        // Tests the pass did last update, by the layer of the collider that did them
+        struct LayerStats
+        {
+            // Rect tests against colliders on layers this one interacts with
+            uint32_t tests = 0;
+            // Candidates on other layers, skipped without touching their rects
+            uint32_t rejected = 0;
+            uint32_t contacts = 0;
+            // Contacts kept from the last pass without a test, neither collider changed
+            uint32_t kept = 0;
+        };
+
+        PassMode m_passMode = PassMode::Incremental;
+
+        // Every collider, with its layer's bit
+        Engine::SpatialGrid m_grid;
+
+        // Enter/Stay/Exit for every pair of the last pass, each pair twice (once from each side), sorted by entity
+        Engine::EventBuffer<CollisionEvent> m_events;
+
+        std::array<LayerStats, Engine::CollisionMatrix::MAX_LAYERS> m_layerStats{};
+
+        void init() override;
+        void update() override;
+        void entityAdded(Engine::Entity const &ent) override;
+        void entityRemoved(Engine::Entity const &ent) override;
+        void restored() override;
+
+        // Calls func(Entity other) for everything overlapping 'ent' at the last pass, on one of the layers in 'layerMask'
+        template <class F>
+        void forEachContact(Engine::Entity ent, uint32_t layerMask, F &&func) const
+        {
+            auto it = std::lower_bound(m_contacts.begin(), m_contacts.end(), Contact{ ent, 0 });
+            for (; it != m_contacts.end() && it->ent == ent; ++it)
+            {
+                if (layerMask & it->otherLayerBit)
+                {
+                    func(it->other);
+                }
+            }
+        }
+
+        // Same, appended to 'out'
+        void collectContacts(Engine::Entity ent, uint32_t layerMask, std::vector<Engine::Entity> &out) const;
+
+        // Calls func(const CollisionEvent &) for every event of 'ent' from the last pass, with colliders on one of the layers in 'layerMask'
+        template <class F>
+        void forEachEvent(Engine::Entity ent, uint32_t layerMask, F &&func) const
+        {
+            auto it = std::lower_bound(m_events.begin(), m_events.end(), ent,
+                [](const CollisionEvent &event, Engine::Entity ent) { return event.ent < ent; });
+            for (; it != m_events.end() && it->ent == ent; ++it)
+            {
+                if (layerMask & it->otherLayerBit)
+                {
+                    func(*it);
+                }
+            }
+        }
+
+        // Every contact of the last pass, each pair twice (once from each side), sorted by entity
+        const std::vector<Contact> &contacts() const
+        {
+            return m_contacts;
+        }
+
+        // Per-layer counters of the last pass, for the debug console
+        std::string report() const;
+
+    private:
+        // What's happened to an entity since the last pass
+        enum EntityFlags : uint8_t
+        {
+            Changed = 1 << 0,
+            Removed = 1 << 1,
+        };
+
+        std::vector<Contact> m_contacts;
+        std::vector<Contact> m_lastContacts;
+
+        // Flags by entity ID, and every entity with any set so they can be cleared after the pass
+        std::vector<uint8_t> m_flags;
+        std::vector<Engine::Entity> m_flagged;
+        // Colliders written to since the last pass
+        std::vector<Engine::Entity> m_changed;
+
+        // The matrix the kept pairs were found with, every pair is tested again when it changes
+        Engine::CollisionMatrix m_matrix;
+        bool m_fullPass = true;
+
+        void insert(Engine::Entity ent);
+        void flag(Engine::Entity ent, uint8_t flags);
+        uint8_t flagsOf(Engine::Entity ent) const;
+
+        // Tests 'ent' against everything near it, 'skip' says which candidates another test handles
+        template <class Skip>
+        void testCollider(Engine::Entity ent, const Engine::Recti &rect, uint8_t layer, Skip &&skip);
+
+        // Compares m_contacts with m_lastContacts into m_events
+        void emitEvents();
+    };
+
+    namespace CollisionsCommon
+    {
+        // What the game's layers collide with
+        void setupLayers(Engine::CollisionMatrix &matrix);
+
+        const char *layerName(uint8_t layer);
+    }
+}
+
+#endif // _COLLISIONS_H
@@ -2,6 +2,7 @@
 #define _GRAPPLABLE_H
 
 #include <engine/ecs/System.h>
+#include <engine/AabbTree.h>
 
 namespace GS
 {
@@ -12,8 +13,14 @@ namespace GS
     class UpdateGrapplable : public Engine::System
     {
     public:
+        // Every grapplable's collider, cast rays against it instead of going through m_entities
+        Engine::AabbTree m_tree;
+
         void init() override;
         void update() override;
+        void entityAdded(Engine::Entity const &ent) override;
+        void entityRemoved(Engine::Entity const &ent) override;
+        void restored() override;
     };
 }
 
@@ -21,18 +21,14 @@ void Mover2DCommon::stop(Mover2DCommon::MoverEntity *self)
 	stopY(self);
 }
 
-void Mover2DCommon::setOnCollide(Mover2D &mover, Mover2D::CollideCallback callback)
+void Mover2DCommon::bounce(Mover2D &mover, const MoverHit &hit)
 {
-	setOnCollideX(mover, callback);
-	setOnCollideY(mover, callback);
-}
-
-void Mover2DCommon::setOnCollideX(Mover2D &mover, Mover2D::CollideCallback callback)
-{
-	mover.onCollideX = callback;
-}
-
-void Mover2DCommon::setOnCollideY(Mover2D &mover, Mover2D::CollideCallback callback)
-{
-	mover.onCollideY = callback;
+	if (hit.dir.x != 0)
+	{
+		mover.velocity.x = hit.velocity.x * -1;
+	}
+	else
+	{
+		mover.velocity.y = hit.velocity.y * -1;
+	}
 }
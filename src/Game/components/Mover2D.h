@@ -1,10 +1,9 @@
 #ifndef _MOVER_2D_H
 #define _MOVER_2D_H
 
-#include <functional>
-
 #include <engine/ecs/System.h>
 #include <engine/Spatial.h>
+#include <engine/EventBuffer.h>
 
 #include <engine/components/Collider2D.h>
 #include <engine/components/Transform2D.h>
@@ -26,19 +25,41 @@ namespace GS
 
         // Set when a collision happens
         Engine::Vec2f velocityBeforeCollision;
+    };
 
-        // Passes in the entity we collided with
-        using CollideCallback = std::function<void(Engine::Entity ent)>;
-        
-        CollideCallback onCollideX;
-        CollideCallback onCollideY;
+    // A mover running into something, see UpdateMoveAndCollide2D::m_hits
+    struct MoverHit
+    {
+        Engine::Entity ent = Engine::NULL_ENTITY;
+        // What it ran into
+        Engine::Entity other = Engine::NULL_ENTITY;
+        // Which way it was moving, along one axis
+        Engine::Vec2i dir;
+        // Its velocity right before it was stopped
+        Engine::Vec2f velocity;
     };
 
     // Update mover with collider
     class UpdateMoveAndCollide2D : public Engine::System
     {
     public:
+        // How movers find what they run into. Both end up in the same place with the same hits.
+        enum class MoveMode
+        {
+            // Step one pixel at a time, checking for collisions at every step
+            Pixel,
+            // Work out the distance to the first solid in the way in one query, then jump there
+            Swept,
+        };
+
+        MoveMode m_moveMode = MoveMode::Swept;
+
         class UpdateSolids *m_updateSolids = nullptr;
+        class UpdateTilemap *m_updateTilemap = nullptr;
+
+        // Everything movers ran into this update, in the order they did.
+        // Whatever has to react to a collision (bouncing, pickups...) reads these after this system has run.
+        Engine::EventBuffer<MoverHit> m_hits;
 
         void init() override;
         void update() override;
@@ -49,6 +70,9 @@ namespace GS
 
         // Check if any collider in the scene is colliding with this
         bool checkCollision(struct Mover2DCommon::MoverEntity *self, Engine::Vec2i offset, Engine::Entity *collidingEntity = nullptr);
+
+        // How many pixels (up to 'steps') this can move along 'dir' before the next one would collide
+        int sweepDistance(struct Mover2DCommon::MoverEntity *self, Engine::Vec2i dir, int steps);
     };
 
     // Update mover without collider
@@ -76,9 +100,8 @@ namespace GS
 
         void stop(struct Mover2DCommon::MoverEntity *self);
 
-        void setOnCollide(Mover2D &mover, Mover2D::CollideCallback callback);
-        void setOnCollideX(Mover2D &mover, Mover2D::CollideCallback callback);
-        void setOnCollideY(Mover2D &mover, Mover2D::CollideCallback callback);
+        // Send the mover back the way it came along the axis it hit on
+        void bounce(Mover2D &mover, const MoverHit &hit);
     }
 }
 
@@ -38,8 +38,6 @@ void PlayerCommon::switchState(Scene *scene, PlayerEntity &self, Player::State n
 		break;
 
 	case Player::State::GrappleReeling:
-		// Reset function callback
-		Mover2DCommon::setOnCollide(*self.mover, nullptr);
 		Audio::stop(Content::sndGrappleReel);
 
 		// Turn gravity back on
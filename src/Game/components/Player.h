@@ -1,6 +1,8 @@
 #ifndef _PLAYER_H
 #define _PLAYER_H
 
+#include <vector>
+
 #include <engine/ecs/System.h>
 #include <engine/ecs/Scene.h>
 
@@ -62,7 +64,7 @@ namespace GS
 		float cursorScale = 1.0f;
 
 		// Ceiling hook
-		uint32_t ceilingHookUid;
+		Engine::EntityHandle ceilingHook;
 
 		int enemiesKilled = 0;
 		float timeSurvived = 0.0f;
@@ -73,7 +75,17 @@ namespace GS
 	class UpdatePlayer : public Engine::System
 	{
 	private:
-		std::set<Engine::Entity> *m_grapplableEntities = nullptr;
+		// Owns the tree of grapplable colliders the grapple aims at
+		class UpdateGrapplable *m_updateGrapplable = nullptr;
+		// Grapplable walls baked into tilemaps
+		class UpdateTilemap *m_updateTilemap = nullptr;
+		// Finds the enemies touching the player
+		class UpdateCollisions *m_updateCollisions = nullptr;
+		// What the player's mover ran into
+		class UpdateMoveAndCollide2D *m_updateMoveAndCollide = nullptr;
+
+		// Enemies that started touching the player this frame, kept around so it doesn't allocate
+		std::vector<Engine::Entity> m_touchedEnemies;
 
 	public:
 		void init() override;
@@ -103,6 +115,8 @@ namespace GS
 		void checkImpactCollision(struct PlayerCommon::PlayerEntity &self, Engine::Entity collidingEnt);
 		// Called every frame of reeling state
 		bool checkReelingCollision(struct PlayerCommon::PlayerEntity &self);
+		// Whatever the mover ran into while reeling this frame
+		void checkReelingHits(struct PlayerCommon::PlayerEntity &self);
 		
 		Engine::Vec3f calcGrappleNormal(struct PlayerCommon::PlayerEntity &self);
 
@@ -2,6 +2,7 @@
 #define _SOLID_H
 
 #include <engine/ecs/System.h>
+#include <engine/SpatialGrid.h>
 
 namespace GS
 {
@@ -12,8 +13,31 @@ namespace GS
     class UpdateSolids : public Engine::System
     {
     public:
+        // Every solid's collider and its layer bit, query it instead of going through m_entities
+        Engine::SpatialGrid m_grid;
+
         void init() override;
-        // void update() override;
+        void update() override;
+        void entityAdded(Engine::Entity const &ent) override;
+        void entityRemoved(Engine::Entity const &ent) override;
+        void restored() override;
+
+        // A solid's collider was moved during an update, keep the grid in step right away
+        // (otherwise it only catches up on UpdateSolids' next update)
+        void moved(Engine::Entity ent, const Engine::Recti &rect)
+        {
+            m_grid.update(ent, rect);
+        }
+
+        // Re-insert colliders written since the last catch up by anything that didn't call moved()
+        // UpdateMoveAndCollide2D calls this before moving anything, so it never queries last tick's rects.
+        void catchUp();
+
+    private:
+        // Colliders written after this tick haven't been caught up on yet
+        Engine::Tick m_caughtUp = 0;
+
+        void insert(Engine::Entity ent);
     };
 }
 
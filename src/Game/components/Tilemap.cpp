@@ -0,0 +1,385 @@
+#include "Tilemap.h"
+
+#include <engine/DebugConsole.h>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // Rounds toward negative infinity, so points left of and above the origin land in negative cells
+    int floorDiv(int value, int divisor)
+    {
+        int quotient = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+    }
+
+    Tilemap::Chunk &chunkOf(Tilemap &tilemap, int cellX, int cellY)
+    {
+        return tilemap.chunks[(cellY / Tilemap::chunkCells) * tilemap.chunksX + cellX / Tilemap::chunkCells];
+    }
+
+    const Tilemap::Chunk &chunkOf(const Tilemap &tilemap, int cellX, int cellY)
+    {
+        return tilemap.chunks[(cellY / Tilemap::chunkCells) * tilemap.chunksX + cellX / Tilemap::chunkCells];
+    }
+
+    int indexInChunk(int cellX, int cellY)
+    {
+        return (cellY % Tilemap::chunkCells) * Tilemap::chunkCells + cellX % Tilemap::chunkCells;
+    }
+
+    bool inBounds(const Tilemap &tilemap, int cellX, int cellY)
+    {
+        return cellX >= 0 && cellY >= 0 && cellX < tilemap.width && cellY < tilemap.height;
+    }
+}
+
+void TilemapCommon::resize(Tilemap &tilemap, const Vec2i &origin, int tileSize, int width, int height)
+{
+    LB_ASSERT(tileSize > 0, "Tilemap cells need a size.");
+
+    tilemap.origin = origin;
+    tilemap.tileSize = tileSize;
+    tilemap.width = Math::Max(width, 0);
+    tilemap.height = Math::Max(height, 0);
+    tilemap.chunksX = (tilemap.width + Tilemap::chunkCells - 1) / Tilemap::chunkCells;
+    tilemap.chunksY = (tilemap.height + Tilemap::chunkCells - 1) / Tilemap::chunkCells;
+
+    tilemap.chunks.clear();
+    tilemap.chunks.resize(static_cast<size_t>(tilemap.chunksX) * tilemap.chunksY);
+}
+
+uint8_t TilemapCommon::cell(const Tilemap &tilemap, int cellX, int cellY)
+{
+    if (!inBounds(tilemap, cellX, cellY))
+    {
+        return Tilemap::Empty;
+    }
+    return chunkOf(tilemap, cellX, cellY).cells[indexInChunk(cellX, cellY)];
+}
+
+void TilemapCommon::setCell(Tilemap &tilemap, int cellX, int cellY, uint8_t flags)
+{
+    LB_ASSERT(inBounds(tilemap, cellX, cellY), "Cell is outside the tilemap.");
+
+    Tilemap::Chunk &chunk = chunkOf(tilemap, cellX, cellY);
+    uint8_t &cell = chunk.cells[indexInChunk(cellX, cellY)];
+    if (cell == flags)
+    {
+        return;
+    }
+
+    chunk.filled += (flags != Tilemap::Empty) - (cell != Tilemap::Empty);
+    cell = flags;
+    chunk.dirty = true;
+}
+
+void TilemapCommon::fillRect(Tilemap &tilemap, const Recti &rect, uint8_t flags)
+{
+    const Vec2i local = rect.position() - tilemap.origin;
+    LB_ASSERT(local.x % tilemap.tileSize == 0 && local.y % tilemap.tileSize == 0 &&
+        rect.w % tilemap.tileSize == 0 && rect.h % tilemap.tileSize == 0, "Rect doesn't line up with the tilemap's cells.");
+
+    const Vec2i first = cellAt(tilemap, rect.topLeft());
+    for (int cellY = first.y; cellY < first.y + rect.h / tilemap.tileSize; cellY++)
+    {
+        for (int cellX = first.x; cellX < first.x + rect.w / tilemap.tileSize; cellX++)
+        {
+            setCell(tilemap, cellX, cellY, flags);
+        }
+    }
+}
+
+Vec2i TilemapCommon::cellAt(const Tilemap &tilemap, const Vec2i &point)
+{
+    return Vec2i(
+        floorDiv(point.x - tilemap.origin.x, tilemap.tileSize),
+        floorDiv(point.y - tilemap.origin.y, tilemap.tileSize));
+}
+
+Recti TilemapCommon::cellRect(const Tilemap &tilemap, int cellX, int cellY)
+{
+    return Recti(
+        tilemap.origin.x + cellX * tilemap.tileSize,
+        tilemap.origin.y + cellY * tilemap.tileSize,
+        tilemap.tileSize, tilemap.tileSize);
+}
+
+uint8_t TilemapCommon::flagsAt(const Tilemap &tilemap, const Vec2i &point)
+{
+    const Vec2i cellPos = cellAt(tilemap, point);
+    return cell(tilemap, cellPos.x, cellPos.y);
+}
+
+bool TilemapCommon::overlaps(const Tilemap &tilemap, const Recti &rect, uint8_t flags)
+{
+    bool found = false;
+    forEachCell(tilemap, rect, flags, [&](int, int)
+        {
+            found = true;
+        });
+    return found;
+}
+
+bool TilemapCommon::raycast(const Tilemap &tilemap, const Linei &ray, const Vec2i &pos, uint8_t flags, Vec2i *point)
+{
+    if (tilemap.width == 0 || tilemap.height == 0)
+    {
+        return false;
+    }
+
+    const int64_t size = tilemap.tileSize;
+
+    // In the map's space
+    const int64_t startX = ray.a.x - tilemap.origin.x;
+    const int64_t startY = ray.a.y - tilemap.origin.y;
+    const int64_t dirX = ray.b.x - ray.a.x;
+    const int64_t dirY = ray.b.y - ray.a.y;
+    const int64_t absX = dirX < 0 ? -dirX : dirX;
+    const int64_t absY = dirY < 0 ? -dirY : dirY;
+    const int stepX = dirX > 0 ? 1 : (dirX < 0 ? -1 : 0);
+    const int stepY = dirY > 0 ? 1 : (dirY < 0 ? -1 : 0);
+
+    // Cells are closed rects to Line::intersectsClosest, so a ray on a grid line touches the cells on both sides
+    const bool onGridX = startX % size == 0;
+    const bool onGridY = startY % size == 0;
+
+    // Hit points are measured from 'pos', which needn't be on the ray, so the first cell hit along the ray
+    // isn't always the closest. Keep walking until nothing further along can beat the best hit.
+    const float startToPos = (ray.a - pos).length();
+    const float rayLength = (ray.b - ray.a).length();
+    bool found = false;
+    float best = 0.0f;
+    Vec2i bestCell;
+
+    auto test = [&](int cellX, int cellY)
+    {
+        if (!(cell(tilemap, cellX, cellY) & flags))
+        {
+            return;
+        }
+
+        Vec2i hit;
+        if (!ray.intersectsClosest(pos, cellRect(tilemap, cellX, cellY), &hit))
+        {
+            return;
+        }
+
+        // Ties go to the first cell in row order, like the lowest entity in AabbTree
+        float distance = (pos - hit).lengthSquared();
+        if (!found || distance < best || (distance == best && (cellY < bestCell.y || (cellY == bestCell.y && cellX < bestCell.x))))
+        {
+            found = true;
+            best = distance;
+            bestCell = Vec2i(cellX, cellY);
+            *point = hit;
+        }
+    };
+
+    const Vec2i start = cellAt(tilemap, ray.a);
+    int cellX = start.x;
+    int cellY = start.y;
+
+    // Every cell the start point is on the edge of
+    test(cellX, cellY);
+    if (onGridX)
+    {
+        test(cellX - 1, cellY);
+    }
+    if (onGridY)
+    {
+        test(cellX, cellY - 1);
+    }
+    if (onGridX && onGridY)
+    {
+        test(cellX - 1, cellY - 1);
+    }
+
+    while (stepX != 0 || stepY != 0)
+    {
+        // Distance along the ray to the next cell edge on each axis, as fractions 'num / abs' of the ray.
+        // Compared by cross multiplying so corners are found exactly.
+        const int64_t edgeX = (cellX + (stepX > 0 ? 1 : 0)) * size;
+        const int64_t edgeY = (cellY + (stepY > 0 ? 1 : 0)) * size;
+        const int64_t numX = stepX != 0 ? (edgeX - startX) * stepX : 0;
+        const int64_t numY = stepY != 0 ? (edgeY - startY) * stepY : 0;
+
+        const bool crossX = stepX != 0 && (stepY == 0 || numX * absY <= numY * absX);
+        const bool crossY = stepY != 0 && (stepX == 0 || numY * absX <= numX * absY);
+
+        // Past the end of the ray
+        if (crossX ? numX > absX : numY > absY)
+        {
+            break;
+        }
+
+        // Stop once everything further along is further from 'pos' than the best hit, with a pixel or two to
+        // spare for hit points being rounded
+        if (found)
+        {
+            const float along = crossX ? static_cast<float>(numX) / absX : static_cast<float>(numY) / absY;
+            const float nearest = along * rayLength - startToPos - 2.0f;
+            if (nearest > 0.0f && nearest * nearest > best)
+            {
+                break;
+            }
+        }
+
+        if (crossX && crossY)
+        {
+            // Through a corner, touching both cells beside it
+            test(cellX + stepX, cellY);
+            test(cellX, cellY + stepY);
+            cellX += stepX;
+            cellY += stepY;
+        }
+        else if (crossX)
+        {
+            cellX += stepX;
+        }
+        else
+        {
+            cellY += stepY;
+        }
+
+        test(cellX, cellY);
+
+        // Running along a grid line
+        if (stepY == 0 && onGridY)
+        {
+            test(cellX, cellY - 1);
+        }
+        if (stepX == 0 && onGridX)
+        {
+            test(cellX - 1, cellY);
+        }
+    }
+    return found;
+}
+
+void TilemapCommon::rebuildGeometry(const Tilemap &tilemap, Tilemap::Chunk &chunk, int chunkX, int chunkY)
+{
+    chunk.geometry.clear();
+    chunk.dirty = false;
+    if (chunk.filled == 0)
+    {
+        return;
+    }
+
+    // Runs of filled cells along each row, grown downwards while the row below has the exact same run
+    const int baseX = chunkX * Tilemap::chunkCells;
+    const int baseY = chunkY * Tilemap::chunkCells;
+
+    // Rects that reach the bottom of the previous row, and of this one
+    std::vector<size_t> open;
+    std::vector<size_t> nextOpen;
+    for (int y = 0; y < Tilemap::chunkCells; y++)
+    {
+        nextOpen.clear();
+
+        int x = 0;
+        while (x < Tilemap::chunkCells)
+        {
+            if (chunk.cells[y * Tilemap::chunkCells + x] == Tilemap::Empty)
+            {
+                x++;
+                continue;
+            }
+
+            const int runStart = x;
+            while (x < Tilemap::chunkCells && chunk.cells[y * Tilemap::chunkCells + x] != Tilemap::Empty)
+            {
+                x++;
+            }
+
+            const Recti run = cellRect(tilemap, baseX + runStart, baseY + y);
+            const int runWidth = (x - runStart) * tilemap.tileSize;
+
+            size_t index = chunk.geometry.size();
+            for (size_t i : open)
+            {
+                if (chunk.geometry[i].x == run.x && chunk.geometry[i].w == runWidth)
+                {
+                    index = i;
+                    break;
+                }
+            }
+
+            if (index < chunk.geometry.size())
+            {
+                chunk.geometry[index].h += tilemap.tileSize;
+            }
+            else
+            {
+                chunk.geometry.push_back(Recti(run.x, run.y, runWidth, tilemap.tileSize));
+            }
+            nextOpen.push_back(index);
+        }
+        std::swap(open, nextOpen);
+    }
+}
+
+void TilemapCommon::load(Tilemap &tilemap, const std::string &text, const Vec2i &origin, int tileSize)
+{
+    std::vector<std::string> rows;
+    std::istringstream stream(text);
+    std::string line;
+    size_t width = 0;
+    while (std::getline(stream, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        width = Math::Max(width, line.size());
+        rows.push_back(line);
+    }
+
+    resize(tilemap, origin, tileSize, static_cast<int>(width), static_cast<int>(rows.size()));
+
+    for (size_t y = 0; y < rows.size(); y++)
+    {
+        for (size_t x = 0; x < rows[y].size(); x++)
+        {
+            uint8_t flags = Tilemap::Empty;
+            switch (rows[y][x])
+            {
+            case '#':
+                flags = Tilemap::CellSolid | Tilemap::CellGrapplable;
+                break;
+            case 's':
+                flags = Tilemap::CellSolid;
+                break;
+            case 'g':
+                flags = Tilemap::CellGrapplable;
+                break;
+            default:
+                break;
+            }
+
+            if (flags != Tilemap::Empty)
+            {
+                setCell(tilemap, static_cast<int>(x), static_cast<int>(y), flags);
+            }
+        }
+    }
+}
+
+bool TilemapCommon::loadFile(Tilemap &tilemap, const std::string &path, const Vec2i &origin, int tileSize)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::stringstream text;
+    text << file.rdbuf();
+    load(tilemap, text.str(), origin, tileSize);
+    return true;
+}
@@ -0,0 +1,170 @@
+#ifndef _TILEMAP_H
+#define _TILEMAP_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <engine/ecs/System.h>
+#include <engine/ecs/Scene.h>
+#include <engine/Spatial.h>
+#include <engine/Graphics.h>
+#include <engine/AabbTree.h>
+
+#include <components/Collisions.h>
+
+namespace GS
+{
+    // Static level geometry as a grid of cells, instead of an entity per wall.
+    // Cells are grouped into square chunks so empty parts of a level cost nothing to skip,
+    // and each chunk caches the rects its cells merge into for drawing.
+    struct Tilemap
+    {
+        // What a cell is, as bit flags
+        enum CellFlags : uint8_t
+        {
+            Empty = 0,
+            // Movers collide with it
+            CellSolid = 1 << 0,
+            // The grapple can hook onto it
+            CellGrapplable = 1 << 1,
+        };
+
+        // Cells along each side of a chunk
+        static constexpr int chunkCells = 16;
+
+        struct Chunk
+        {
+            std::array<uint8_t, chunkCells * chunkCells> cells{};
+            // Cells that aren't empty, so empty chunks can be skipped
+            int filled = 0;
+
+            // Cells merged into rects (world space), rebuilt by DrawTilemap when dirty
+            std::vector<Engine::Recti> geometry;
+            bool dirty = true;
+        };
+
+        // Collision layer of every cell, see Collider2D::layer
+        uint8_t layer = Layer::Wall;
+
+        // World position of cell (0, 0)
+        Engine::Vec2i origin;
+        int tileSize = 8;
+
+        // Size in cells and in chunks
+        int width = 0;
+        int height = 0;
+        int chunksX = 0;
+        int chunksY = 0;
+        std::vector<Chunk> chunks;
+
+        // Levels drawn by their background art leave this off
+        bool visible = false;
+        Engine::Color color = Engine::Color(40, 40, 60);
+    };
+
+    // Collision against every tilemap in the scene, for other systems to query
+    class UpdateTilemap : public Engine::System
+    {
+    public:
+        void init() override;
+        void update() override;
+
+        // Does 'rect' overlap a solid cell of a tilemap on one of the layers in 'layerMask'?
+        // 'hitEnt' is set to the tilemap if it does.
+        bool overlapsSolid(const Engine::Recti &rect, uint32_t layerMask, Engine::Entity *hitEnt = nullptr);
+        // Same for grapplable cells
+        bool overlapsGrapplable(const Engine::Recti &rect, Engine::Entity *hitEnt = nullptr);
+
+        // Like Rect::firstOverlapStep against every solid cell: the first step (1 to maxSteps) along 'dir'
+        // at which 'rect' would overlap one, or 0 if it doesn't
+        int firstOverlapStep(const Engine::Recti &rect, const Engine::Vec2i &dir, int maxSteps, uint32_t layerMask);
+
+        // First grapplable cell along 'ray', with the point Line::intersectsClosest finds on it
+        bool raycastGrapplable(const Engine::Linei &ray, const Engine::Vec2i &pos, Engine::RayHit *hit);
+    };
+
+    // Draws visible tilemaps a chunk at a time, from each chunk's cached rects
+    class DrawTilemap : public Engine::System
+    {
+    public:
+        void init() override;
+        void update() override;
+    };
+
+    namespace TilemapCommon
+    {
+        // Clear and size a tilemap to 'width' by 'height' cells
+        void resize(Tilemap &tilemap, const Engine::Vec2i &origin, int tileSize, int width, int height);
+
+        uint8_t cell(const Tilemap &tilemap, int cellX, int cellY);
+        void setCell(Tilemap &tilemap, int cellX, int cellY, uint8_t flags);
+
+        // Set every cell inside a world rect, which has to line up with the cells
+        void fillRect(Tilemap &tilemap, const Engine::Recti &rect, uint8_t flags);
+
+        // Cell a world point is in, may be outside the map
+        Engine::Vec2i cellAt(const Tilemap &tilemap, const Engine::Vec2i &point);
+        Engine::Recti cellRect(const Tilemap &tilemap, int cellX, int cellY);
+
+        // Flags of the cell under a world point, Empty outside the map
+        uint8_t flagsAt(const Tilemap &tilemap, const Engine::Vec2i &point);
+
+        // Does a world rect overlap (see Rect::overlaps) any cell with one of 'flags'?
+        bool overlaps(const Tilemap &tilemap, const Engine::Recti &rect, uint8_t flags);
+
+        // Calls func(cellX, cellY) for every cell with one of 'flags' that a world rect overlaps
+        template <class F>
+        void forEachCell(const Tilemap &tilemap, const Engine::Recti &rect, uint8_t flags, F &&func)
+        {
+            if (rect.w <= 0 || rect.h <= 0)
+            {
+                return;
+            }
+
+            // Rects include their left/top edge but not their right/bottom one
+            const Engine::Vec2i first = cellAt(tilemap, rect.topLeft());
+            const Engine::Vec2i last = cellAt(tilemap, rect.bottomRight() - Engine::Vec2i(1, 1));
+            const int x0 = Engine::Math::Max(first.x, 0);
+            const int y0 = Engine::Math::Max(first.y, 0);
+            const int x1 = Engine::Math::Min(last.x, tilemap.width - 1);
+            const int y1 = Engine::Math::Min(last.y, tilemap.height - 1);
+
+            for (int cellY = y0; cellY <= y1; cellY++)
+            {
+                for (int cellX = x0; cellX <= x1; cellX++)
+                {
+                    const Tilemap::Chunk &chunk = tilemap.chunks[(cellY / Tilemap::chunkCells) * tilemap.chunksX + cellX / Tilemap::chunkCells];
+                    if (chunk.filled == 0)
+                    {
+                        // Nothing in the rest of this chunk's row
+                        cellX = (cellX / Tilemap::chunkCells + 1) * Tilemap::chunkCells - 1;
+                        continue;
+                    }
+
+                    if (chunk.cells[(cellY % Tilemap::chunkCells) * Tilemap::chunkCells + cellX % Tilemap::chunkCells] & flags)
+                    {
+                        func(cellX, cellY);
+                    }
+                }
+            }
+        }
+
+        // Walk the cells along 'ray' in order (DDA) and find the hit on a cell with one of 'flags' closest to
+        // 'pos', the same hit Line::intersectsClosest against every one of those cells would find
+        bool raycast(const Tilemap &tilemap, const Engine::Linei &ray, const Engine::Vec2i &pos, uint8_t flags, Engine::Vec2i *point);
+
+        // Merge a chunk's cells into rects for drawing
+        void rebuildGeometry(const Tilemap &tilemap, Tilemap::Chunk &chunk, int chunkX, int chunkY);
+
+        // Load cells from text, one line per row:
+        //     '#' solid and grapplable, 's' solid only, 'g' grapplable only, anything else empty
+        // The map is sized to the longest line.
+        void load(Tilemap &tilemap, const std::string &text, const Engine::Vec2i &origin, int tileSize);
+        // Same from a file, returns false if it couldn't be read
+        bool loadFile(Tilemap &tilemap, const std::string &path, const Engine::Vec2i &origin, int tileSize);
+    }
+}
+
+#endif // _TILEMAP_H
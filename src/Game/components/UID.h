@@ -23,6 +23,7 @@ namespace GS
         void init() override;
         void entityAdded(Engine::Entity const &ent) override;
         void entityRemoved(Engine::Entity const &ent) override;
+        void restored() override;
 
         bool entityExists(const uint32_t uid);
         Engine::Entity getEntity(const uint32_t uid);
@@ -18,9 +18,8 @@ void DrawParticles2D::init()
 
 void DrawParticles2D::update()
 {
-	for (auto const &ent : m_entities)
+	for (auto [ent, pSystem, transform] : m_scene->view<const Particles2D, const Transform2D>())
 	{
-		auto &pSystem = m_scene->getComponent<Particles2D>(ent);
 		auto &particles = pSystem.particles;
 
 		for (auto const &p : particles)
@@ -39,8 +39,9 @@ void DrawPlayer::update()
 	{
 		PlayerEntity self = getComponents(m_scene, ent);
 
-		std::string surviveStr = "Time survived: " + std::to_string(self.player->timeSurvived) + " seconds"; 
-		std::string enemiesKilledStr = "Enemies killed: " + std::to_string(self.player->enemiesKilled);
+		FrameArena &arena = m_scene->frameArena();
+		const char *surviveStr = arena.format("Time survived: %f seconds", self.player->timeSurvived);
+		const char *enemiesKilledStr = arena.format("Enemies killed: %d", self.player->enemiesKilled);
 			
 		
 		switch (self.player->state)
@@ -21,12 +21,10 @@ void DrawShadow::init()
 
 void DrawShadow::update()
 {
-	for (auto const &ent : m_entities)
+	for (auto [ent, transform, shadow] : m_scene->view<const Transform2D, const Shadow>())
 	{
-		auto &transform = m_scene->getComponent<Transform2D>(ent);
-		auto &shadow = m_scene->getComponent<Shadow>(ent);
 
 		Content::sprShadow.SetOrigin(Sprite::Origin::Middle);
-		Content::sprShadow.DrawExCam(transform.pos + shadow.offset);
+		Content::sprShadow.DrawExCam(TransformCommon::drawPos(transform) + shadow.offset);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include <components/Tilemap.h>
+
+#include <engine/Ecs.h>
+#include <engine/Graphics.h>
+
+using namespace Engine;
+using namespace GS;
+
+void DrawTilemap::init()
+{
+    Signature sig;
+
+    sig.set(m_scene->getComponentType<Tilemap>());
+
+    // Behind shadows and everything standing on the floor
+    setup(-2, Type::Draw, sig);
+}
+
+void DrawTilemap::update()
+{
+    const Recti view = m_scene->m_camera.getRect();
+
+    for (auto [ent, tilemap] : m_scene->view<Tilemap>())
+    {
+        if (!tilemap.visible)
+        {
+            continue;
+        }
+
+        // Only chunks under the camera
+        const Vec2i first = TilemapCommon::cellAt(tilemap, view.topLeft()) / Tilemap::chunkCells;
+        const Vec2i last = TilemapCommon::cellAt(tilemap, view.bottomRight()) / Tilemap::chunkCells;
+
+        for (int chunkY = Math::Max(first.y, 0); chunkY <= Math::Min(last.y, tilemap.chunksY - 1); chunkY++)
+        {
+            for (int chunkX = Math::Max(first.x, 0); chunkX <= Math::Min(last.x, tilemap.chunksX - 1); chunkX++)
+            {
+                Tilemap::Chunk &chunk = tilemap.chunks[chunkY * tilemap.chunksX + chunkX];
+                if (chunk.dirty)
+                {
+                    TilemapCommon::rebuildGeometry(tilemap, chunk, chunkX, chunkY);
+                }
+
+                for (const Recti &rect : chunk.geometry)
+                {
+                    Graphics::drawRectFilledCam(m_scene, rect, tilemap.color);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,287 @@
+#include <components/Activity.h>
+
+#include <engine/Ecs.h>
+#include <engine/Math.h>
+
+#include <engine/components/Transform2D.h>
+#include <components/Collisions.h>
+
+#include <cstdio>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    Recti grow(const Recti &rect, int margin)
+    {
+        return Recti(rect.x - margin, rect.y - margin, rect.w + margin * 2, rect.h + margin * 2);
+    }
+}
+
+void UpdateActivity::init()
+{
+    Signature sig;
+    sig.set(m_scene->getComponentType<Activity>());
+    sig.set(m_scene->getComponentType<Transform2D>());
+
+    // After the transform history, before anything that checks it this tick
+    setup(-5, Type::PreUpdate, sig);
+}
+
+void UpdateActivity::update()
+{
+    LB_ASSERT(m_slowInterval > 0 && m_farInterval + m_slowInterval <= UINT8_MAX, "Intervals have to fit in Activity::ticks.");
+
+    // Not every scene collides things, the ones that do have it registered before the first update
+    if (!m_lookedUp)
+    {
+        m_updateCollisions = m_scene->hasSystem<UpdateCollisions>() ? m_scene->getSystem<UpdateCollisions>() : nullptr;
+        m_lookedUp = true;
+    }
+
+    const Camera &camera = m_scene->m_camera;
+    m_awakeRect = grow(camera.getRect(), m_awakeMargin);
+    m_slowRect = grow(camera.getRect(), m_slowMargin);
+
+    // Moving further in a tick than the slices keep up with, something could be on screen before it's checked
+    const Vec2i moved = camera.m_pos - m_lastCameraPos;
+    const int maxMove = m_awakeMargin / m_slowInterval;
+    if (Math::abs(moved.x) > maxMove || Math::abs(moved.y) > maxMove)
+    {
+        m_checkAll = true;
+    }
+    m_lastCameraPos = camera.m_pos;
+
+    if (m_resting.size() != static_cast<size_t>(m_slowInterval))
+    {
+        resizeSlices();
+    }
+
+    m_tick++;
+    m_due.clear();
+    m_counts = Counts();
+
+    if (m_updateCollisions)
+    {
+        wakeFromCollisions();
+    }
+
+    // Awake entities every tick, the ones that aren't anymore wait for their slice
+    m_moving.clear();
+    for (Entity ent : m_awake)
+    {
+        Activity &activity = m_scene->getComponent<Activity>(ent);
+        activity.level = levelOf(activity, m_scene->readComponent<Transform2D>(ent).pos);
+
+        if (activity.level == Activity::Level::Awake)
+        {
+            makeDue(ent, activity);
+        }
+        else
+        {
+            m_moving.push_back(ent);
+        }
+    }
+    for (Entity ent : m_moving)
+    {
+        m_awake.erase(ent);
+        rest(ent, m_scene->getComponent<Activity>(ent));
+    }
+
+    // This tick's slice of the rest
+    m_moving.clear();
+    const uint32_t current = m_tick % m_slowInterval;
+    for (uint32_t slice = 0; slice < m_resting.size(); slice++)
+    {
+        if (!m_checkAll && slice != current)
+        {
+            continue;
+        }
+
+        for (Entity ent : m_resting[slice])
+        {
+            Activity &activity = m_scene->getComponent<Activity>(ent);
+            activity.level = levelOf(activity, m_scene->readComponent<Transform2D>(ent).pos);
+            m_counts.checked++;
+
+            switch (activity.level)
+            {
+            case Activity::Level::Awake:
+                makeDue(ent, activity);
+                m_moving.push_back(ent);
+                break;
+
+            case Activity::Level::Slow:
+                if (!activity.far || m_tick - activity.lastTick >= static_cast<uint32_t>(m_farInterval))
+                {
+                    makeDue(ent, activity);
+                }
+                break;
+
+            case Activity::Level::Asleep:
+                // Time stops for it, there's nothing to catch up on when it wakes
+                activity.lastTick = m_tick;
+                break;
+            }
+        }
+    }
+    for (Entity ent : m_moving)
+    {
+        m_resting[m_scene->readComponent<Activity>(ent).slice].erase(ent);
+        m_awake.insert(ent);
+    }
+
+    m_checkAll = false;
+
+    m_counts.awake = static_cast<uint32_t>(m_awake.size());
+    for (const EntitySet &resting : m_resting)
+    {
+        m_counts.resting += static_cast<uint32_t>(resting.size());
+    }
+    m_counts.due = static_cast<uint32_t>(m_due.size());
+}
+
+void UpdateActivity::entityAdded(Entity const &ent)
+{
+    // Checked on the next tick like anything awake, it owes nothing from before it existed
+    Activity &activity = m_scene->getComponent<Activity>(ent);
+    activity.lastTick = m_tick;
+    activity.dueTick = 0;
+
+    m_awake.insert(ent);
+}
+
+void UpdateActivity::entityRemoved(Entity const &ent)
+{
+    m_awake.erase(ent);
+    for (EntitySet &resting : m_resting)
+    {
+        resting.erase(ent);
+    }
+}
+
+void UpdateActivity::restored()
+{
+    // The snapshot's ticks were counted by a different run of this system
+    m_awake.clear();
+    for (EntitySet &resting : m_resting)
+    {
+        resting.clear();
+    }
+    m_due.clear();
+    for (Entity ent : m_entities)
+    {
+        Activity &activity = m_scene->getComponent<Activity>(ent);
+        activity.lastTick = m_tick;
+        activity.dueTick = 0;
+        m_awake.insert(ent);
+    }
+    m_checkAll = true;
+}
+
+void UpdateActivity::wake(Entity ent, int ticks)
+{
+    LB_ASSERT(m_entities.contains(ent), "Waking an entity without an activity.");
+
+    // Never shortens a wake that's already longer
+    Activity &activity = m_scene->getComponent<Activity>(ent);
+    const int longest = Math::Max(ticks, static_cast<int>(activity.wakeTicks));
+    activity.wakeTicks = static_cast<uint16_t>(Math::Min(longest, static_cast<int>(UINT16_MAX)));
+
+    if (activity.slice < m_resting.size() && m_resting[activity.slice].erase(ent))
+    {
+        m_awake.insert(ent);
+    }
+}
+
+Activity::Level UpdateActivity::levelOf(Activity &activity, const Vec2i &pos) const
+{
+    if (activity.wakeTicks > 0)
+    {
+        activity.wakeTicks--;
+        return Activity::Level::Awake;
+    }
+
+    Activity::Level level = Activity::Level::Asleep;
+    if (m_awakeRect.contains(pos))
+    {
+        level = Activity::Level::Awake;
+    }
+    else if (m_slowRect.contains(pos))
+    {
+        level = Activity::Level::Slow;
+    }
+
+    // Levels go Awake, Slow, Asleep
+    activity.far = level > activity.deepest;
+    return activity.far ? activity.deepest : level;
+}
+
+void UpdateActivity::makeDue(Entity ent, Activity &activity)
+{
+    // Every tick since it last updated, a catch-up bigger than fits is cut short
+    const uint32_t owed = m_tick - activity.lastTick;
+    activity.ticks = static_cast<uint8_t>(Math::Min(owed, static_cast<uint32_t>(UINT8_MAX)));
+    activity.lastTick = m_tick;
+    activity.dueTick = m_tick;
+    m_due.push_back(ent);
+}
+
+void UpdateActivity::rest(Entity ent, Activity &activity)
+{
+    // Handed out in turn, so entities that stop being awake together are spread over the slices
+    activity.slice = static_cast<uint8_t>(m_nextSlice++ % m_resting.size());
+    m_resting[activity.slice].insert(ent);
+}
+
+void UpdateActivity::resizeSlices()
+{
+    // The interval changed, deal the resting entities out again and check them all this tick
+    std::vector<Entity> resting;
+    for (const EntitySet &slice : m_resting)
+    {
+        for (Entity ent : slice)
+        {
+            resting.push_back(ent);
+        }
+    }
+
+    m_resting.assign(m_slowInterval, EntitySet());
+    for (Entity ent : resting)
+    {
+        rest(ent, m_scene->getComponent<Activity>(ent));
+    }
+    m_checkAll = true;
+}
+
+void UpdateActivity::wakeFromCollisions()
+{
+    // Last tick's events, anything awake that ran into something not awake wakes it up
+    for (const CollisionEvent &event : m_updateCollisions->m_events)
+    {
+        if (event.type != CollisionEvent::Type::Enter || !m_entities.contains(event.ent) || !m_scene->isAlive(event.other))
+        {
+            continue;
+        }
+
+        // Colliders without an activity (the player, walls) count as awake where things around them are
+        const Activity *other = ActivityCommon::find(m_scene, event.other);
+        const bool otherAwake = other
+            ? other->level == Activity::Level::Awake
+            : m_scene->hasComponent<Transform2D>(event.other) && m_awakeRect.contains(m_scene->readComponent<Transform2D>(event.other).pos);
+
+        if (otherAwake)
+        {
+            wake(event.ent, m_wakeTicks);
+        }
+    }
+}
+
+std::string UpdateActivity::report() const
+{
+    char line[160];
+    snprintf(line, sizeof(line), "-- Activity --\n    %u awake, %u resting (%u checked), %u due\n",
+        m_counts.awake, m_counts.resting, m_counts.checked, m_counts.due);
+    return line;
+}
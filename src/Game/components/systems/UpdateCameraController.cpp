@@ -25,8 +25,10 @@ void UpdateCameraController::init()
 
 void UpdateCameraController::update()
 {
-	m_uidSys = m_scene->getSystem<UpdateUID>();
-	m_playerSys = m_scene->getSystem<UpdatePlayer>();
+	if (!m_playerSys)
+	{
+		m_playerSys = m_scene->getSystem<UpdatePlayer>();
+	}
 
 	for (auto const &ent : m_entities)
 	{
@@ -35,13 +37,12 @@ void UpdateCameraController::update()
 
 		auto &camera = m_scene->m_camera;
 		
-		if (!m_uidSys->entityExists(camController.playerId))
+		if (!m_scene->isAlive(camController.player))
 		{
 			// Find a new player
 			if (m_playerSys->m_entities.size() > 0)
 			{
-				auto player = PlayerCommon::getComponents(m_scene, *m_playerSys->m_entities.begin());
-				camController.playerId = player.uid->id;
+				camController.player = m_scene->getHandle(*m_playerSys->m_entities.begin());
 			}
 			else
 			{
@@ -50,7 +51,7 @@ void UpdateCameraController::update()
 			}
 		}
 
-		Entity playerEnt = m_uidSys->getEntity(camController.playerId);
+		Entity playerEnt = camController.player.entity;
 		auto player = PlayerCommon::getComponents(m_scene, playerEnt);
 
 		// Get direction from our position to mouse
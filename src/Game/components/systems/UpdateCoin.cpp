@@ -8,6 +8,8 @@
 #include <engine/components/Animator.h>
 #include <components/Mover2D.h>
 #include <components/Gravity.h>
+#include <components/Player.h>
+#include <components/Activity.h>
 
 using namespace Engine;
 using namespace GS;
@@ -27,22 +29,57 @@ void UpdateCoin::init()
 	sig.set(m_scene->getComponentType<Mover2D>());
 	sig.set(m_scene->getComponentType<Animator>());
 	sig.set(m_scene->getComponentType<Gravity>());
+	sig.set(m_scene->getComponentType<Activity>());
 
 	setup(0, Type::Update, sig);
+
+	// Coins are destroyed with queueDestroy, so this can run alongside other systems.
+	// The hits it reads come from UpdateMoveAndCollide2D, which runs on its own before this.
+	Signature reads;
+	reads.set(m_scene->getComponentType<Collider2D>());
+	reads.set(m_scene->getComponentType<Gravity>());
+	reads.set(m_scene->getComponentType<Activity>());
+	// Only checked on the entities coins hit
+	reads.set(m_scene->getComponentType<Player>());
+
+	Signature writes;
+	writes.set(m_scene->getComponentType<Coin>());
+	writes.set(m_scene->getComponentType<Mover2D>());
+	writes.set(m_scene->getComponentType<Transform2D>());
+	writes.set(m_scene->getComponentType<Animator>());
+
+	setupAccess(reads, writes);
 }
 
 void UpdateCoin::update()
 {
-	for (auto const &ent : m_entities)
+	if (!m_updateMoveAndCollide)
 	{
-		auto &coin = m_scene->getComponent<Coin>(ent);
-		auto &transform = m_scene->getComponent<Transform2D>(ent);
-		auto &collider = m_scene->getComponent<Collider2D>(ent);
-		auto &mover = m_scene->getComponent<Mover2D>(ent);
-		auto &gravity = m_scene->getComponent<Gravity>(ent);
-		auto &animator = m_scene->getComponent<Animator>(ent);
+		m_updateMoveAndCollide = m_scene->getSystem<UpdateMoveAndCollide2D>();
+	}
 
-		coin.destroytimer -= Time::delta;
+	// Bounce off whatever coins ran into this frame
+	for (const MoverHit &hit : m_updateMoveAndCollide->m_hits)
+	{
+		if (!m_scene->hasComponent<Coin>(hit.ent))
+		{
+			continue;
+		}
+
+		// Pickup coins
+		if (m_scene->hasComponent<Player>(hit.other) && m_scene->readComponent<Coin>(hit.ent).destroytimer > 200)
+		{
+			m_scene->queueDestroy(hit.ent);
+		}
+
+		Mover2DCommon::bounce(m_scene->getComponent<Mover2D>(hit.ent), hit);
+	}
+
+	// A coin nobody's near doesn't run out
+	ActivityCommon::forEachDue(m_scene, m_entities, [&](Entity ent, const Activity &activity)
+	{
+		Coin &coin = m_scene->getComponent<Coin>(ent);
+		coin.destroytimer -= ActivityCommon::delta(activity);
 
 		if (coin.destroytimer <= 0.0f)
 		{
@@ -52,6 +89,7 @@ void UpdateCoin::update()
 
 		if (coin.destroytimer < flashThreshold && Time::onInterval(0.05))
 		{
+			Animator &animator = m_scene->getComponent<Animator>(ent);
 			if (animator.color.a > 0)
 			{
 				animator.color.a = 0;
@@ -63,6 +101,6 @@ void UpdateCoin::update()
 		}
 
 		// Animate scale
-		transform.scale.x = Math::sin((Time::seconds - coin.animOffset) * 10.0f);
-	}
+		m_scene->getComponent<Transform2D>(ent).scale.x = Math::sin((Time::seconds - coin.animOffset) * 10.0f);
+	});
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+#include <components/Collisions.h>
+
+#include <engine/Ecs.h>
+
+#include <engine/components/Collider2D.h>
+
+#include <cstdio>
+
+using namespace Engine;
+using namespace GS;
+
+void UpdateCollisions::init()
+{
+    Signature sig;
+
+    sig.set(m_scene->getComponentType<Collider2D>());
+
+    setup(0, Type::Update, sig);
+
+    Signature reads;
+    reads.set(m_scene->getComponentType<Collider2D>());
+    setupAccess(reads, Signature());
+}
+
+template <class Skip>
+void UpdateCollisions::testCollider(Entity ent, const Recti &rect, uint8_t layer, Skip &&skip)
+{
+    const uint32_t mask = m_matrix.mask(layer);
+    if (mask == 0)
+    {
+        return;
+    }
+
+    LayerStats &stats = m_layerStats[layer];
+    const uint32_t bit = CollisionMatrix::bit(layer);
+
+    m_grid.forEachCandidate(rect, SpatialGrid::ALL_LAYERS, [&](Entity other, const Recti &otherRect)
+        {
+            if (skip(other))
+            {
+                return true;
+            }
+
+            const uint32_t otherBit = m_grid.layerBitsOf(other);
+            if (!(mask & otherBit))
+            {
+                stats.rejected++;
+                return true;
+            }
+
+            stats.tests++;
+            if (rect.overlaps(otherRect))
+            {
+                m_contacts.push_back(Contact{ ent, other, otherBit });
+                m_contacts.push_back(Contact{ other, ent, bit });
+            }
+            return true;
+        });
+}
+
+// Finds every overlapping pair of colliders whose layers interact, once a frame
+void UpdateCollisions::update()
+{
+    m_changed.clear();
+    m_scene->forEachChanged<Collider2D>(lastRunTick(), [this](Entity ent)
+        {
+            if (m_entities.contains(ent))
+            {
+                insert(ent);
+                flag(ent, Changed);
+                m_changed.push_back(ent);
+            }
+        });
+
+    // Pairs found with a different matrix may not interact anymore
+    if (m_scene->m_collisionMatrix != m_matrix)
+    {
+        m_matrix = m_scene->m_collisionMatrix;
+        m_fullPass = true;
+    }
+
+    std::swap(m_contacts, m_lastContacts);
+    m_contacts.clear();
+    m_layerStats.fill(LayerStats());
+
+    if (m_fullPass || m_passMode == PassMode::Full)
+    {
+        for (auto [ent, collider] : m_scene->view<const Collider2D>())
+        {
+            // Every pair is seen from both sides, only test it from the lower entity's
+            testCollider(ent, collider.rect, collider.layer, [ent](Entity other)
+                {
+                    return other <= ent;
+                });
+        }
+    }
+    else
+    {
+        // Neither collider moved or changed layer, so they still overlap
+        for (const Contact &contact : m_lastContacts)
+        {
+            if (flagsOf(contact.ent) == 0 && flagsOf(contact.other) == 0)
+            {
+                m_contacts.push_back(contact);
+                m_layerStats[m_scene->readComponent<Collider2D>(contact.ent).layer].kept++;
+            }
+        }
+
+        for (Entity ent : m_changed)
+        {
+            const Collider2D &collider = m_scene->readComponent<Collider2D>(ent);
+
+            // Pairs of two changed colliders are tested from the lower one
+            testCollider(ent, collider.rect, collider.layer, [this, ent](Entity other)
+                {
+                    return other == ent || (other < ent && (flagsOf(other) & Changed));
+                });
+        }
+    }
+
+    std::sort(m_contacts.begin(), m_contacts.end());
+
+    for (const Contact &contact : m_contacts)
+    {
+        m_layerStats[m_scene->readComponent<Collider2D>(contact.ent).layer].contacts++;
+    }
+
+    emitEvents();
+
+    for (Entity ent : m_flagged)
+    {
+        m_flags[ent] = 0;
+    }
+    m_flagged.clear();
+    m_fullPass = false;
+}
+
+void UpdateCollisions::emitEvents()
+{
+    m_events.clear();
+
+    // Both lists are sorted, walk them side by side
+    size_t last = 0;
+    size_t now = 0;
+    while (last < m_lastContacts.size() || now < m_contacts.size())
+    {
+        if (now == m_contacts.size() || (last < m_lastContacts.size() && m_lastContacts[last] < m_contacts[now]))
+        {
+            const Contact &contact = m_lastContacts[last++];
+            m_events.push(CollisionEvent{ CollisionEvent::Type::Exit, contact.ent, contact.other, contact.otherLayerBit });
+        }
+        else if (last == m_lastContacts.size() || m_contacts[now] < m_lastContacts[last])
+        {
+            const Contact &contact = m_contacts[now++];
+            m_events.push(CollisionEvent{ CollisionEvent::Type::Enter, contact.ent, contact.other, contact.otherLayerBit });
+        }
+        else
+        {
+            const Contact &contact = m_contacts[now++];
+            last++;
+
+            // An ID that was destroyed and reused since the last pass is a different entity
+            if ((flagsOf(contact.ent) | flagsOf(contact.other)) & Removed)
+            {
+                m_events.push(CollisionEvent{ CollisionEvent::Type::Exit, contact.ent, contact.other, contact.otherLayerBit });
+                m_events.push(CollisionEvent{ CollisionEvent::Type::Enter, contact.ent, contact.other, contact.otherLayerBit });
+            }
+            else
+            {
+                m_events.push(CollisionEvent{ CollisionEvent::Type::Stay, contact.ent, contact.other, contact.otherLayerBit });
+            }
+        }
+    }
+}
+
+void UpdateCollisions::entityAdded(Entity const &ent)
+{
+    insert(ent);
+}
+
+void UpdateCollisions::entityRemoved(Entity const &ent)
+{
+    m_grid.remove(ent);
+
+    // Its pairs are dropped on the next pass
+    flag(ent, Removed);
+}
+
+void UpdateCollisions::restored()
+{
+    // Nothing from before the restore can be trusted, the next pass starts over and everything touching enters
+    m_grid.clear();
+    m_contacts.clear();
+    m_lastContacts.clear();
+    m_events.clear();
+    for (Entity ent : m_flagged)
+    {
+        m_flags[ent] = 0;
+    }
+    m_flagged.clear();
+    m_fullPass = true;
+    for (Entity ent : m_entities)
+    {
+        insert(ent);
+    }
+}
+
+void UpdateCollisions::collectContacts(Entity ent, uint32_t layerMask, std::vector<Entity> &out) const
+{
+    forEachContact(ent, layerMask, [&](Entity other)
+        {
+            out.push_back(other);
+        });
+}
+
+std::string UpdateCollisions::report() const
+{
+    std::string str = "-- Collision layers (last pass) --\n";
+
+    char line[128];
+    for (int layer = 0; layer < CollisionMatrix::MAX_LAYERS; layer++)
+    {
+        const LayerStats &stats = m_layerStats[layer];
+        if (stats.tests == 0 && stats.rejected == 0 && stats.contacts == 0 && stats.kept == 0)
+        {
+            continue;
+        }
+
+        snprintf(line, sizeof(line), "    %-10s %6u tests, %6u rejected by layer, %4u contacts (%4u kept)\n",
+            CollisionsCommon::layerName(static_cast<uint8_t>(layer)), stats.tests, stats.rejected, stats.contacts, stats.kept);
+        str += line;
+    }
+    return str;
+}
+
+void UpdateCollisions::insert(Entity ent)
+{
+    const Collider2D &collider = m_scene->readComponent<Collider2D>(ent);
+    m_grid.insert(ent, collider.rect, CollisionMatrix::bit(collider.layer));
+}
+
+void UpdateCollisions::flag(Entity ent, uint8_t flags)
+{
+    if (ent >= m_flags.size())
+    {
+        m_flags.resize(ent + 1, 0);
+    }
+    if (m_flags[ent] == 0)
+    {
+        m_flagged.push_back(ent);
+    }
+    m_flags[ent] |= flags;
+}
+
+uint8_t UpdateCollisions::flagsOf(Entity ent) const
+{
+    return ent < m_flags.size() ? m_flags[ent] : 0;
+}
+
+void CollisionsCommon::setupLayers(CollisionMatrix &matrix)
+{
+    // Default keeps colliding with everything
+    matrix.clearAll();
+    for (uint8_t layer = 0; layer < Layer::Count; layer++)
+    {
+        matrix.set(Layer::Default, layer, true);
+    }
+
+    matrix.set(Layer::Wall, Layer::Player, true);
+    matrix.set(Layer::Wall, Layer::Coin, true);
+    matrix.set(Layer::Wall, Layer::Projectile, true);
+
+    // Coins bump into the player like any solid
+    matrix.set(Layer::Player, Layer::Enemy, true);
+    matrix.set(Layer::Player, Layer::Coin, true);
+
+    matrix.set(Layer::Projectile, Layer::Enemy, true);
+}
+
+const char *CollisionsCommon::layerName(uint8_t layer)
+{
+    switch (layer)
+    {
+    case Layer::Default:
+        return "Default";
+    case Layer::Wall:
+        return "Wall";
+    case Layer::Player:
+        return "Player";
+    case Layer::Enemy:
+        return "Enemy";
+    case Layer::Coin:
+        return "Coin";
+    case Layer::Projectile:
+        return "Projectile";
+    case Layer::Hook:
+        return "Hook";
+    default:
+        return "?";
+    }
+}
@@ -24,50 +24,67 @@ void UpdateEnemy::init()
 	//sig.set(m_scene->getComponentType<Solid>());
 	sig.set(m_scene->getComponentType<Grapplable>());
 	sig.set(m_scene->getComponentType<Shadow>());
+	sig.set(m_scene->getComponentType<Activity>());
 
 	setup(0, Type::Update, sig);
+
+	Signature reads;
+	reads.set(m_scene->getComponentType<Enemy>());
+	reads.set(m_scene->getComponentType<Grapplable>());
+	reads.set(m_scene->getComponentType<Shadow>());
+	reads.set(m_scene->getComponentType<Activity>());
+
+	Signature writes;
+	writes.set(m_scene->getComponentType<Animator>());
+	writes.set(m_scene->getComponentType<Collider2D>());
+	// Includes reading the player's transform
+	writes.set(m_scene->getComponentType<Transform2D>());
+
+	setupAccess(reads, writes);
 }
 
 void UpdateEnemy::update()
 {
 	UpdatePlayer *playerSys = m_scene->getSystem<UpdatePlayer>();
 
-	for (auto const &ent : m_entities)
+	// Only the enemies due this tick, ones far off screen are only due every few ticks
+	ActivityCommon::forEachDue(m_scene, m_entities, [&](Entity ent, const Activity &activity)
 	{
-		auto &enemy = m_scene->getComponent<Enemy>(ent);
-		auto &animator = m_scene->getComponent<Animator>(ent);
-		auto &collider = m_scene->getComponent<Collider2D>(ent);
-		auto &transform = m_scene->getComponent<Transform2D>(ent);
-		auto &grapplable = m_scene->getComponent<Grapplable>(ent);
-		auto &shadow = m_scene->getComponent<Shadow>(ent);
+		const Enemy &enemy = m_scene->readComponent<Enemy>(ent);
+		Animator &animator = m_scene->getComponent<Animator>(ent);
+		Transform2D &transform = m_scene->getComponent<Transform2D>(ent);
+
+		const float delta = ActivityCommon::delta(activity);
+		const float deltaSeconds = ActivityCommon::deltaSeconds(activity);
 
 		animator.offset.y = Math::sin((Time::seconds * 8.0f) -enemy.spawnTime) * 8.0;
 		animator.depth = transform.pos.y;
 
 		if (playerSys->m_entities.size() <= 0)
 		{
-			continue;
+			return;
 		}
 
 		Entity playerEnt = *playerSys->m_entities.begin();
-		auto &playerTransform = m_scene->getComponent<Transform2D>(playerEnt);
+		auto &playerTransform = m_scene->readComponent<Transform2D>(playerEnt);
 
 		// Move toward the player
 		Vec2f nrm = (playerTransform.pos - transform.pos).normalized();
 		//transform.pos += nrm * enemy.moveSpd * Time::delta;
-		transform.pos.x += nrm.x * enemy.moveSpd * Time::delta;
-		transform.pos.y += nrm.y * enemy.moveSpd * Time::delta;
+		transform.pos.x += nrm.x * enemy.moveSpd * delta;
+		transform.pos.y += nrm.y * enemy.moveSpd * delta;
 
-		collider.rect.x += nrm.x * enemy.moveSpd * Time::delta;
-		collider.rect.y += nrm.y * enemy.moveSpd * Time::delta;
+		Collider2D &collider = m_scene->getComponent<Collider2D>(ent);
+		collider.rect.x += nrm.x * enemy.moveSpd * delta;
+		collider.rect.y += nrm.y * enemy.moveSpd * delta;
 
 		if (nrm.x < 0)
 		{
-			transform.scale.x = Math::damp(transform.scale.x, -1, turnSpd, Time::deltaSeconds * 10.0f);
+			transform.scale.x = Math::damp(transform.scale.x, -1, turnSpd, deltaSeconds * 10.0f);
 		}
 		else
 		{
-			transform.scale.x = Math::damp(transform.scale.x, 1, turnSpd, Time::deltaSeconds * 10.0f);
+			transform.scale.x = Math::damp(transform.scale.x, 1, turnSpd, deltaSeconds * 10.0f);
 		}
-	}
-}
\ No newline at end of file
+	});
+}
@@ -37,8 +37,8 @@ void GS::UpdateEnemyGen::update()
     }
 
     Entity playerEnt = *playerSys->m_entities.begin();
-    auto &pTransform = m_scene->getComponent<Transform2D>(playerEnt);
-    auto &pCol = m_scene->getComponent<Collider2D>(playerEnt);
+    auto &pTransform = m_scene->readComponent<Transform2D>(playerEnt);
+    auto &pCol = m_scene->readComponent<Collider2D>(playerEnt);
     
     for (auto const &ent : m_entities)
     {
@@ -15,7 +15,40 @@ void UpdateGrapplable::init()
     sig.set(m_scene->getComponentType<Collider2D>());
 
     setup(0, Type::Update, sig);
+
+    Signature reads;
+    reads.set(m_scene->getComponentType<Collider2D>());
+    setupAccess(reads, Signature());
 }
 
+// Keeps a tree of grapplable colliders for the player's line of sight checks
 void UpdateGrapplable::update()
-{}
\ No newline at end of file
+{
+    // Enemies move after the player, catch them up before it aims again
+    m_scene->forEachChanged<Collider2D>(lastRunTick(), [this](Entity ent)
+        {
+            if (m_entities.contains(ent))
+            {
+                m_tree.update(ent, m_scene->readComponent<Collider2D>(ent).rect);
+            }
+        });
+}
+
+void UpdateGrapplable::entityAdded(Entity const &ent)
+{
+    m_tree.insert(ent, m_scene->readComponent<Collider2D>(ent).rect);
+}
+
+void UpdateGrapplable::entityRemoved(Entity const &ent)
+{
+    m_tree.remove(ent);
+}
+
+void UpdateGrapplable::restored()
+{
+    m_tree.clear();
+    for (Entity ent : m_entities)
+    {
+        m_tree.insert(ent, m_scene->readComponent<Collider2D>(ent).rect);
+    }
+}
\ No newline at end of file
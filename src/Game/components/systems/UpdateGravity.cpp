@@ -4,6 +4,7 @@
 #include <engine/Time.h>
 
 #include <engine/components/Transform2D.h>
+#include <components/Activity.h>
 
 #include <Factory.h>
 
@@ -22,37 +23,62 @@ void UpdateGravity::init()
 
 void UpdateGravity::update()
 {
-	for (auto const &ent : m_entities)
+	// Read as const, so only what actually changes is marked changed (and skipped entities aren't at all)
+	for (auto [ent, gravity, transform] : m_scene->view<const Gravity, const Transform2D>())
 	{
-		auto &gravity = m_scene->getComponent<Gravity>(ent);
-		auto &transform = m_scene->getComponent <Transform2D>(ent);
+		// The player has no activity and always falls
+		const Activity *activity = ActivityCommon::find(m_scene, ent);
+		const int ticks = ActivityCommon::ticks(m_scene, activity);
+		if (ticks == 0)
+		{
+			continue;
+		}
+		const float delta = Time::delta * ticks;
 
-		float total = gravity.remainder + gravity.zVelocity * Time::delta;
+		float total = gravity.remainder + gravity.zVelocity * delta;
 		int toMove = static_cast<int>(total);
 
+		float zVelocity = gravity.zVelocity;
 		if (gravity.apply)
 		{
-			gravity.zVelocity += gravity.intensity * Time::delta;
+			zVelocity += gravity.intensity * delta;
 		}
-		
-		gravity.remainder = total - toMove;
-		transform.z -= toMove;
+
+		const float remainder = total - toMove;
 		// transform.z = Math::approach(transform.z, 0.0f, toMove);
+		const int z = Math::Max(transform.z - toMove, 0);
 
-		transform.z = Math::Max(transform.z, 0);
-		
 		// Bounce
-		if (transform.z <= 0.0f && Math::abs(gravity.peakVelocity) > 2.0f)
+		const bool bounce = z <= 0.0f && Math::abs(gravity.peakVelocity) > 2.0f;
+
+		if (bounce || zVelocity != gravity.zVelocity || remainder != gravity.remainder)
+		{
+			Gravity &falling = m_scene->getComponent<Gravity>(ent);
+			falling.zVelocity = zVelocity;
+			falling.remainder = remainder;
+
+			if (bounce)
+			{
+				falling.peakVelocity *= falling.bounciness;
+				falling.zVelocity = falling.peakVelocity;
+			}
+		}
+
+		// Something lying on the ground keeps the same transform
+		if (z != transform.z)
 		{
-			gravity.peakVelocity *= gravity.bounciness;
-			gravity.zVelocity = gravity.peakVelocity;
+			m_scene->getComponent<Transform2D>(ent).z = z;
+		}
 
+		if (bounce)
+		{
 			if (gravity.onBounce)
 			{
 				gravity.onBounce();
 			}
-			else
+			else if (!activity || activity->level == Activity::Level::Awake)
 			{
+				// Nobody would see the smoke off screen
 				Factory::smokeExplosion(m_scene, transform.pos, Math::randRangei(1, 2));
 			}
 		}
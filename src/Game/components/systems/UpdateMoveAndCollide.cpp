@@ -6,6 +6,8 @@
 #include <engine/components/Transform2D.h>
 #include <engine/components/Collider2D.h>
 #include <components/Solid.h>
+#include <components/Tilemap.h>
+#include <components/Activity.h>
 
 using namespace Engine;
 using namespace GS;
@@ -21,23 +23,56 @@ void UpdateMoveAndCollide2D::init()
 
 void UpdateMoveAndCollide2D::update()
 {
-	m_updateSolids = m_scene->getSystem<UpdateSolids>();
+	if (!m_updateSolids)
+	{
+		m_updateSolids = m_scene->getSystem<UpdateSolids>();
+		m_updateTilemap = m_scene->getSystem<UpdateTilemap>();
+	}
+
+	m_hits.clear();
+
+	// Solids written since UpdateSolids last ran (e.g. hooks snapped by the player) have to be where they are now
+	m_updateSolids->catchUp();
 
-	for (const auto &ent : m_entities)
+	// Read as const, so skipped and standing movers aren't marked changed for the systems that follow changes
+	for (auto [ent, transform, collider, mover] : m_scene->view<const Transform2D, const Collider2D, const Mover2D>())
 	{
+		// Movers with an activity (coins) stay put while they're skipped, and move further when they aren't
+		const int ticks = ActivityCommon::ticks(m_scene, ActivityCommon::find(m_scene, ent));
+		if (ticks == 0)
+		{
+			continue;
+		}
+		const float delta = Time::delta * ticks;
+
+		Vec2f total = mover.remainder + (mover.velocity * Graphics::resMult) * delta;
+		Vec2i toMove = Vec2i(static_cast<int>(total.x), static_cast<int>(total.y));
+
+		if (toMove == Vec2i(0, 0))
+		{
+			if (total != mover.remainder)
+			{
+				m_scene->getComponent<Mover2D>(ent).remainder = total;
+			}
+			continue;
+		}
+
 		Mover2DCommon::MoverEntity self;
 		self.ent = ent;
 		self.transform = &m_scene->getComponent<Transform2D>(ent);
 		self.collider = &m_scene->getComponent<Collider2D>(ent);
 		self.mover = &m_scene->getComponent<Mover2D>(ent);
 
-		Vec2f total = self.mover->remainder + (self.mover->velocity * Graphics::resMult) * Time::delta;
-		Vec2i toMove = Vec2i(static_cast<int>(total.x), static_cast<int>(total.y));
-
 		self.mover->remainder = total - toMove;
 
 		moveAndCollideX(&self, toMove.x);
 		moveAndCollideY(&self, toMove.y);
+
+		// Movers after this one have to collide with where it is now
+		if (m_updateSolids->m_grid.contains(ent))
+		{
+			m_updateSolids->moved(ent, self.collider->rect);
+		}
 	}
 }
 
@@ -45,17 +80,23 @@ void UpdateMoveAndCollide2D::moveAndCollideX(Mover2DCommon::MoverEntity *self, i
 {
 	int sign = Math::sign(amt);
 	Entity collidingEnt;
+
+	// Jump to the last free pixel, the loop below then only has the collision itself to find
+	if (m_moveMode == MoveMode::Swept && amt != 0)
+	{
+		int free = sweepDistance(self, Vec2i(sign, 0), amt * sign) * sign;
+		amt -= free;
+		self->transform->pos.x += free;
+		self->collider->rect.x += free;
+	}
+
 	while (amt != 0)
 	{
 		if (checkCollision(self, Vec2i(sign, 0), &collidingEnt))
 		{
 			self->mover->velocityBeforeCollision = self->mover->velocity;
+			m_hits.push(MoverHit{ self->ent, collidingEnt, Vec2i(sign, 0), self->mover->velocity });
 			Mover2DCommon::stopX(self);
-
-			if (self->mover->onCollideX)
-			{
-				self->mover->onCollideX(collidingEnt);
-			}
 			return;
 		}
 
@@ -69,17 +110,22 @@ void UpdateMoveAndCollide2D::moveAndCollideY(Mover2DCommon::MoverEntity *self, i
 {
 	int sign = Math::sign(amt);
 	Entity collidingEnt;
+
+	if (m_moveMode == MoveMode::Swept && amt != 0)
+	{
+		int free = sweepDistance(self, Vec2i(0, sign), amt * sign) * sign;
+		amt -= free;
+		self->transform->pos.y += free;
+		self->collider->rect.y += free;
+	}
+
 	while (amt != 0)
 	{
 		if (checkCollision(self, Vec2i(0, sign), &collidingEnt))
 		{
 			self->mover->velocityBeforeCollision = self->mover->velocity;
+			m_hits.push(MoverHit{ self->ent, collidingEnt, Vec2i(0, sign), self->mover->velocity });
 			Mover2DCommon::stopY(self);
-
-			if (self->mover->onCollideY)
-			{
-				self->mover->onCollideY(collidingEnt);
-			}
 			return;
 		}
 
@@ -95,23 +141,63 @@ bool UpdateMoveAndCollide2D::checkCollision(Mover2DCommon::MoverEntity *self, Ve
 	offsetCollider.x += offset.x;
 	offsetCollider.y += offset.y;
 
-	for (const auto &otherEnt : m_updateSolids->m_entities)
-	{
-		if (otherEnt == self->ent)
+	// Only solids near the offset collider on layers this one collides with, the grid holds their rects
+	const uint32_t layerMask = m_scene->m_collisionMatrix.mask(self->collider->layer);
+	bool hit = false;
+	m_updateSolids->m_grid.query(offsetCollider, layerMask, [&](Entity otherEnt)
 		{
-			continue;
-		}
+			if (otherEnt == self->ent)
+			{
+				return true;
+			}
 
-		auto &otherCollider = m_scene->getComponent<Collider2D>(otherEnt);
-		if (offsetCollider.overlaps(otherCollider.rect))
-		{
 			if (collidingEntity)
 			{
 				*collidingEntity = otherEnt;
 			}
+			hit = true;
+			return false;
+		});
+
+	// Static level geometry baked into tilemaps
+	if (!hit)
+	{
+		hit = m_updateTilemap->overlapsSolid(offsetCollider, layerMask, collidingEntity);
+	}
+
+	return hit;
+}
+
+int UpdateMoveAndCollide2D::sweepDistance(Mover2DCommon::MoverEntity *self, Vec2i dir, int steps)
+{
+	const Recti rect = self->collider->rect;
+
+	// Everywhere the collider passes through on the way
+	Recti swept = dir.x != 0
+		? Recti(dir.x > 0 ? rect.x + 1 : rect.x - steps, rect.y, rect.w + steps - 1, rect.h)
+		: Recti(rect.x, dir.y > 0 ? rect.y + 1 : rect.y - steps, rect.w, rect.h + steps - 1);
+
+	// Closest step any solid in the way would be hit at
+	const uint32_t layerMask = m_scene->m_collisionMatrix.mask(self->collider->layer);
+	int firstHit = steps + 1;
+	m_updateSolids->m_grid.query(swept, layerMask, [&](Entity otherEnt)
+		{
+			if (otherEnt != self->ent)
+			{
+				int step = rect.firstOverlapStep(m_updateSolids->m_grid.rectOf(otherEnt), dir, steps);
+				if (step != 0 && step < firstHit)
+				{
+					firstHit = step;
+				}
+			}
 			return true;
-		}
+		});
+
+	int tileStep = m_updateTilemap->firstOverlapStep(rect, dir, steps, layerMask);
+	if (tileStep != 0 && tileStep < firstHit)
+	{
+		firstHit = tileStep;
 	}
 
-	return false;
-}
\ No newline at end of file
+	return firstHit - 1;
+}
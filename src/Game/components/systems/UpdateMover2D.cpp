@@ -15,14 +15,17 @@ void UpdateMover2D::init()
 	sig.set(m_scene->getComponentType<Transform2D>());
 	sig.set(m_scene->getComponentType<Mover2D>());
 	setup(0, Type::Update, sig);
+
+	Signature writes;
+	writes.set(m_scene->getComponentType<Transform2D>());
+	writes.set(m_scene->getComponentType<Mover2D>());
+	setupAccess(Signature(), writes);
 }
 
 void UpdateMover2D::update()
 {
-	for (auto const &ent : m_entities)
+	for (auto [ent, mover, transform] : m_scene->view<Mover2D, Transform2D>())
 	{
-		auto &mover = m_scene->getComponent<Mover2D>(ent);
-		auto &transform = m_scene->getComponent<Transform2D>(ent);
 
 		Vec2f total = mover.remainder + mover.velocity * Time::delta;
 		Vec2i toMove = Vec2i(static_cast<int>(total.x), static_cast<int>(total.y));
@@ -1,4 +1,5 @@
 #include <components/Particles2D.h>
+#include <components/Activity.h>
 
 #include <engine/Ecs.h>
 #include <engine/Time.h>
@@ -13,6 +14,7 @@ void UpdateParticles2D::init()
 
 	sig.set(m_scene->getComponentType<Particles2D>());
 	sig.set(m_scene->getComponentType<Transform2D>());
+	sig.set(m_scene->getComponentType<Activity>());
 
 	setup(0, Type::Update, sig);
 }
@@ -25,6 +27,7 @@ void UpdateParticles2D::entityAdded(Entity const &ent)
 	if (pSystem.oneShot)
 	{
 		// Explosion of particles
+		pSystem.particles.reserve(pSystem.particles.size() + pSystem.particleCount);
 		for (int i = 0; i < pSystem.particleCount; i++)
 		{
 			spawnParticle(pSystem, transform);
@@ -34,10 +37,14 @@ void UpdateParticles2D::entityAdded(Entity const &ent)
 
 void UpdateParticles2D::update()
 {
-	for (auto const &ent : m_entities)
+	// Effects off screen run out a few ticks at a time
+	ActivityCommon::forEachDue(m_scene, m_entities, [&](Entity ent, const Activity &activity)
 	{
-		auto &pSystem = m_scene->getComponent<Particles2D>(ent);
-		auto &transform = m_scene->getComponent<Transform2D>(ent);
+		Particles2D &pSystem = m_scene->getComponent<Particles2D>(ent);
+		Transform2D &transform = m_scene->getComponent<Transform2D>(ent);
+
+		const float delta = ActivityCommon::delta(activity);
+		const float deltaSeconds = ActivityCommon::deltaSeconds(activity);
 
 		auto &particles = pSystem.particles;
 
@@ -45,14 +52,14 @@ void UpdateParticles2D::update()
 		for (auto &particle : particles)
 		{
 			float fac = particle.time / Math::Max(particle.lifeTime, 0.001f);
-			particle.time += Time::deltaSeconds;
+			particle.time += deltaSeconds;
 
 			// Move with velocity
-			particle.velocity += (pSystem.gravityDir * pSystem.gravity) * Time::delta;
-			particle.pos += particle.velocity * Time::delta * Graphics::resMult;
+			particle.velocity += (pSystem.gravityDir * pSystem.gravity) * delta;
+			particle.pos += particle.velocity * delta * Graphics::resMult;
 
 			// Animate rotation
-			particle.rotation += Math::degToRad(particle.rotationSpd * Time::delta);
+			particle.rotation += Math::degToRad(particle.rotationSpd * delta);
 
 			// Animate scale
 			particle.scale.x = Math::lerp(particle.scaleStart.x, particle.scaleEnd.x, fac);
@@ -92,7 +99,7 @@ void UpdateParticles2D::update()
 			// If we don't have an infinite lifetime, advance our time
 			if (pSystem.lifeTime > 0.0f)
 			{
-				pSystem.time += Time::deltaSeconds;
+				pSystem.time += deltaSeconds;
 				if (pSystem.time >= pSystem.lifeTime)
 				{
 					// Our lifetime reached, we convert to a oneshot system
@@ -107,7 +114,7 @@ void UpdateParticles2D::update()
 		{
 			Particles2DCommon::destroy(pSystem);
 		}
-	}
+	});
 }
 
 void UpdateParticles2D::spawnParticle(Particles2D &pSystem, Transform2D &transform)
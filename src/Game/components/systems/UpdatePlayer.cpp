@@ -9,6 +9,8 @@
 #include <components/Shadow.h>
 #include <components/CeilingHook.h>
 #include <components/Enemy.h>
+#include <components/Tilemap.h>
+#include <components/Collisions.h>
 
 #include <Content.h>
 #include <Factory.h>
@@ -72,11 +74,24 @@ void UpdatePlayer::init()
 
 void UpdatePlayer::update()
 {
-	m_grapplableEntities = m_scene->getSystemEntities<UpdateGrapplable>();
+	if (!m_updateGrapplable)
+	{
+		m_updateGrapplable = m_scene->getSystem<UpdateGrapplable>();
+		m_updateTilemap = m_scene->getSystem<UpdateTilemap>();
+		m_updateCollisions = m_scene->getSystem<UpdateCollisions>();
+		m_updateMoveAndCollide = m_scene->getSystem<UpdateMoveAndCollide2D>();
+	}
 
-	for (auto const &ent : m_entities)
+	for (auto [ent, transform, collider, animator, mover, player, uid, gravity] :
+		m_scene->view<Transform2D, Collider2D, Animator, Mover2D, Player, UID, Gravity>())
 	{
-		PlayerEntity self = PlayerCommon::getComponents(m_scene, ent);
+		PlayerEntity self = { ent, &transform, &collider, &animator, &mover, &player, &uid, &gravity };
+
+		// Before the state runs, so bouncing off a wall goes straight into the bounce state like it used to
+		if (self.player->state == Player::State::GrappleReeling)
+		{
+			checkReelingHits(self);
+		}
 
 		switch (self.player->state)
 		{
@@ -216,8 +231,7 @@ void UpdatePlayer::stGrappleBounce(PlayerEntity &self)
 
 void GS::UpdatePlayer::stCeilingHook(PlayerCommon::PlayerEntity &self)
 {
-	auto *uidSys = m_scene->getSystem<UpdateUID>();
-	if (!uidSys->entityExists(self.player->ceilingHookUid))
+	if (!m_scene->isAlive(self.player->ceilingHook))
 	{
 		switchState(m_scene, self, Player::State::Main);
 		return;
@@ -231,8 +245,8 @@ void GS::UpdatePlayer::stCeilingHook(PlayerCommon::PlayerEntity &self)
 		return;
 	}
 
-	Entity ceilHookEnt = uidSys->getEntity(self.player->ceilingHookUid);
-	auto &hookTransform = m_scene->getComponent<Transform2D>(ceilHookEnt);
+	Entity ceilHookEnt = self.player->ceilingHook.entity;
+	auto &hookTransform = m_scene->readComponent<Transform2D>(ceilHookEnt);
 
 	{
 		Vec2i colOffset = self.transform->pos - self.collider->rect.position();
@@ -312,33 +326,31 @@ void UpdatePlayer::handleGrappling(struct PlayerCommon::PlayerEntity &self)
 	// Check for line of sight collision with any grapplable entities
 	bool canGrapple = false;
 	{
-		float closestLength = -1;
 		int closestZ = 0;
 		Vec2i closestPoint;
 
+		// Get the closest intersection point out of all the grapplable colliders the line crosses
 		Linei los = Linei(zOffsetPos, m_game->m_input.mousePos());
-		for (const auto &gEnt : *m_grapplableEntities)
+		RayHit hit;
+		m_updateGrapplable->m_tree.raycastClosest(los, self.transform->pos, &hit);
+
+		// Walls in a tilemap win if they're closer, they sit on the floor so have no z
+		RayHit tileHit;
+		if (m_updateTilemap->raycastGrapplable(los, self.transform->pos, &tileHit) &&
+			(hit.distanceSquared < 0.0f || tileHit.distanceSquared < hit.distanceSquared))
 		{
-			auto &gCollider = m_scene->getComponent<Collider2D>(gEnt);
+			hit = tileHit;
+		}
 
-			Vec2i intersectionPoint;
-			if (los.intersectsClosest(self.transform->pos, gCollider.rect, &intersectionPoint))
-			{
-				canGrapple = true;
+		if (hit.distanceSquared >= 0.0f)
+		{
+			canGrapple = true;
+			closestPoint = hit.point;
 
-				// Get the closest intersection point out of all the grapplable colliders we've checked...
-				float checkLength = (self.transform->pos - intersectionPoint).lengthSquared();
-				if (closestLength < 0 || checkLength < closestLength)
-				{
-					closestLength = checkLength;
-					closestPoint = intersectionPoint;
-
-					if (m_scene->hasComponent<Transform2D>(gEnt))
-					{
-						auto &transform = m_scene->getComponent<Transform2D>(gEnt);
-						closestZ = transform.z;
-					}
-				}
+			if (m_scene->hasComponent<Transform2D>(hit.entity))
+			{
+				auto &transform = m_scene->readComponent<Transform2D>(hit.entity);
+				closestZ = transform.z;
 			}
 		}
 
@@ -407,15 +419,9 @@ void UpdatePlayer::startReeling(PlayerEntity &self)
 	// Prevent being able to hold into a wall while we start reeling, causing an instant bounce
 	self.mover->velocity = Vec2f(0, 0);
 
-	// Setup callback so we bounce on collision with a solid
+	// While reeling we bounce on collision with a solid, see checkReelingHits
 	// TODO: Also collide with enemies
 	// TODO: Handle collision with other objects
-	auto bounceCallback = [this, self](Entity ent)
-	{
-		auto _self = self;
-		checkImpactCollision(_self, ent);
-	};
-	Mover2DCommon::setOnCollide(*self.mover, bounceCallback);
 
 	// NOTE: There's a bug where the player won't stop grappling if their grappleNormal is
 	// almost parallel to the wall they're grappling to
@@ -459,11 +465,10 @@ void UpdatePlayer::doGrappleBounce(PlayerEntity &self)
 
 void GS::UpdatePlayer::attachCeilingHook(PlayerCommon::PlayerEntity &self, Engine::Entity hookEnt)
 {
-	auto &uid = m_scene->getComponent<UID>(hookEnt);
 	auto &animator = m_scene->getComponent<Animator>(hookEnt);
 	auto &hookTransform = m_scene->getComponent<Transform2D>(hookEnt);
 
-	self.player->ceilingHookUid = uid.id;
+	self.player->ceilingHook = m_scene->getHandle(hookEnt);
 
 	animator.offset = self.mover->velocity.normalized() * ceilHookBounceOffset;
 	self.animator->offset = self.mover->velocity.normalized() * ceilHookBounceOffset;
@@ -503,16 +508,36 @@ bool UpdatePlayer::checkReelingCollision(PlayerCommon::PlayerEntity &self)
 	Recti offsetCollider = self.collider->rect;
 	offsetCollider.y -= self.transform->z;
 
-	for (auto const &ent : *m_grapplableEntities)
+	Entity hitEnt = NULL_ENTITY;
+	m_updateGrapplable->m_tree.queryRect(offsetCollider, [&](Entity ent)
+		{
+			hitEnt = ent;
+			return false;
+		});
+
+	if (hitEnt == NULL_ENTITY)
+	{
+		m_updateTilemap->overlapsGrapplable(offsetCollider, &hitEnt);
+	}
+
+	if (hitEnt != NULL_ENTITY)
+	{
+		checkImpactCollision(self, hitEnt);
+		return true;
+	}
+	return false;
+}
+
+void UpdatePlayer::checkReelingHits(PlayerCommon::PlayerEntity &self)
+{
+	for (const MoverHit &hit : m_updateMoveAndCollide->m_hits)
 	{
-		auto &collider = m_scene->getComponent<Collider2D>(ent);
-		if (offsetCollider.overlaps(collider.rect))
+		// Only the first hit that does something counts, it takes us out of reeling
+		if (hit.ent == self.ent && self.player->state == Player::State::GrappleReeling)
 		{
-			checkImpactCollision(self, ent);
-			return true;
+			checkImpactCollision(self, hit.other);
 		}
 	}
-	return false;
 }
 
 Vec3f UpdatePlayer::calcGrappleNormal(PlayerCommon::PlayerEntity &self)
@@ -524,42 +549,44 @@ Vec3f UpdatePlayer::calcGrappleNormal(PlayerCommon::PlayerEntity &self)
 
 void GS::UpdatePlayer::checkEnemyCollision(PlayerCommon::PlayerEntity &self)
 {
-	UpdateEnemy *enemySys = m_scene->getSystem<UpdateEnemy>();
-	if (enemySys->m_entities.size() < 0)
-	{
-		return;
-	}
+	const uint32_t enemyBit = CollisionMatrix::bit(Layer::Enemy);
 
 	if (self.player->state == Player::State::Main ||
 		self.player->state == Player::State::ShotGrapple ||
 		self.player->state == Player::State::CeilingHook)
 	{
 		// Touching an enemy kills us
-		for (auto const &ent : enemySys->m_entities)
-		{
-			auto &collider = m_scene->getComponent<Collider2D>(ent);
-			if (self.collider->rect.overlaps(collider.rect))
+		bool touching = false;
+		m_updateCollisions->forEachContact(self.ent, enemyBit, [&](Entity)
 			{
-				// TODO:
-				// Die
-				die(self);
-				
-				return;
-			}
+				touching = true;
+			});
+
+		if (touching)
+		{
+			// TODO:
+			// Die
+			die(self);
 		}
 	}
 	else
 	{
+		// Only enemies that just started touching us, so each one is only killed once
+		m_touchedEnemies.clear();
+		m_updateCollisions->forEachEvent(self.ent, enemyBit, [&](const CollisionEvent &event)
+			{
+				if (event.type == CollisionEvent::Type::Enter)
+				{
+					m_touchedEnemies.push_back(event.other);
+				}
+			});
+
 		// Touching an enemy kills the enemy
-		for (auto const &ent : enemySys->m_entities)
+		for (auto const &ent : m_touchedEnemies)
 		{
-			auto &collider = m_scene->getComponent<Collider2D>(ent);
-			if (self.collider->rect.overlaps(collider.rect))
-			{
-				// Kill enemy
-				EnemyCommon::kill(m_scene, ent);
-				self.player->enemiesKilled++;
-			}
+			// Kill enemy
+			EnemyCommon::kill(m_scene, ent);
+			self.player->enemiesKilled++;
 		}
 	}
 }
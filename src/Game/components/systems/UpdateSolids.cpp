@@ -8,8 +8,7 @@
 using namespace Engine;
 using namespace GS;
 
-// Mainly just here so we have a list of solid entities we can reference
-// from other systems
+// Keeps a grid of solid colliders that other systems can query
 void UpdateSolids::init()
 {
     Signature sig;
@@ -19,4 +18,54 @@ void UpdateSolids::init()
     sig.set(m_scene->getComponentType<Transform2D>());
 
     setup(0, Type::Update, sig);
-}
\ No newline at end of file
+
+    Signature reads;
+    reads.set(m_scene->getComponentType<Collider2D>());
+    setupAccess(reads, Signature());
+}
+
+void UpdateSolids::update()
+{
+    catchUp();
+}
+
+void UpdateSolids::catchUp()
+{
+    const Tick now = ChangeTick::current();
+    m_scene->forEachChanged<Collider2D>(m_caughtUp, [this](Entity ent)
+        {
+            if (m_entities.contains(ent))
+            {
+                insert(ent);
+            }
+        });
+
+    // The rest of this tick can still write colliders, look at it again next time
+    m_caughtUp = now - 1;
+}
+
+void UpdateSolids::entityAdded(Entity const &ent)
+{
+    insert(ent);
+}
+
+void UpdateSolids::entityRemoved(Entity const &ent)
+{
+    m_grid.remove(ent);
+}
+
+void UpdateSolids::restored()
+{
+    m_grid.clear();
+    for (Entity ent : m_entities)
+    {
+        insert(ent);
+    }
+}
+
+void UpdateSolids::insert(Entity ent)
+{
+    // With its layer, so movers only find the solids they collide with
+    const Collider2D &collider = m_scene->readComponent<Collider2D>(ent);
+    m_grid.insert(ent, collider.rect, CollisionMatrix::bit(collider.layer));
+}
@@ -0,0 +1,104 @@
+#include <components/Tilemap.h>
+
+#include <engine/Ecs.h>
+
+using namespace Engine;
+using namespace GS;
+
+// Answers collision queries against the scene's tilemaps, nothing in them changes on its own
+void UpdateTilemap::init()
+{
+    Signature sig;
+
+    sig.set(m_scene->getComponentType<Tilemap>());
+
+    setup(0, Type::Update, sig);
+
+    // Nothing to update, never holds other systems up
+    setupAccess(Signature(), Signature());
+}
+
+void UpdateTilemap::update()
+{}
+
+bool UpdateTilemap::overlapsSolid(const Recti &rect, uint32_t layerMask, Entity *hitEnt)
+{
+    for (Entity ent : m_entities)
+    {
+        const Tilemap &tilemap = m_scene->readComponent<Tilemap>(ent);
+        if ((layerMask & CollisionMatrix::bit(tilemap.layer)) && TilemapCommon::overlaps(tilemap, rect, Tilemap::CellSolid))
+        {
+            if (hitEnt)
+            {
+                *hitEnt = ent;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UpdateTilemap::overlapsGrapplable(const Recti &rect, Entity *hitEnt)
+{
+    for (Entity ent : m_entities)
+    {
+        if (TilemapCommon::overlaps(m_scene->readComponent<Tilemap>(ent), rect, Tilemap::CellGrapplable))
+        {
+            if (hitEnt)
+            {
+                *hitEnt = ent;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+int UpdateTilemap::firstOverlapStep(const Recti &rect, const Vec2i &dir, int maxSteps, uint32_t layerMask)
+{
+    // Everywhere the rect passes through on the way
+    const Recti swept = dir.x != 0
+        ? Recti(dir.x > 0 ? rect.x + 1 : rect.x - maxSteps, rect.y, rect.w + maxSteps - 1, rect.h)
+        : Recti(rect.x, dir.y > 0 ? rect.y + 1 : rect.y - maxSteps, rect.w, rect.h + maxSteps - 1);
+
+    int firstHit = 0;
+    for (Entity ent : m_entities)
+    {
+        const Tilemap &tilemap = m_scene->readComponent<Tilemap>(ent);
+        if (!(layerMask & CollisionMatrix::bit(tilemap.layer)))
+        {
+            continue;
+        }
+
+        TilemapCommon::forEachCell(tilemap, swept, Tilemap::CellSolid, [&](int cellX, int cellY)
+            {
+                int step = rect.firstOverlapStep(TilemapCommon::cellRect(tilemap, cellX, cellY), dir, maxSteps);
+                if (step != 0 && (firstHit == 0 || step < firstHit))
+                {
+                    firstHit = step;
+                }
+            });
+    }
+    return firstHit;
+}
+
+bool UpdateTilemap::raycastGrapplable(const Linei &ray, const Vec2i &pos, RayHit *hit)
+{
+    bool found = false;
+    for (Entity ent : m_entities)
+    {
+        Vec2i point;
+        if (TilemapCommon::raycast(m_scene->readComponent<Tilemap>(ent), ray, pos, Tilemap::CellGrapplable, &point))
+        {
+            float distance = (pos - point).lengthSquared();
+            if (!found || distance < hit->distanceSquared)
+            {
+                hit->entity = ent;
+                hit->point = point;
+                hit->distanceSquared = distance;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
@@ -30,6 +30,16 @@ void UpdateUID::entityRemoved(Engine::Entity const &ent)
     m_uidMap.erase(guid.id);
 }
 
+void UpdateUID::restored()
+{
+    // IDs handed out since the snapshot are never reused, m_id only goes up
+    m_uidMap.clear();
+    for (Entity ent : m_entities)
+    {
+        m_uidMap.insert({m_scene->getComponent<UID>(ent).id, ent});
+    }
+}
+
 bool UpdateUID::entityExists(const uint32_t uid)
 {
     return m_uidMap.count(uid) != 0;
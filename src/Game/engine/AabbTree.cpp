@@ -0,0 +1,541 @@
+#include "AabbTree.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace Engine;
+
+namespace
+{
+    // Rays are tested against boxes grown by this much, so rounding can't lose a hit on an edge
+    constexpr double rayPadding = 0.5;
+
+    // Cost of a box when choosing where to insert, smaller boxes are cheaper to walk past
+    int64_t perimeter(const Recti &box)
+    {
+        return 2 * (static_cast<int64_t>(box.w) + box.h);
+    }
+}
+
+AabbTree::Ray::Ray(const Linei &line)
+    : ax(line.a.x), ay(line.a.y)
+{
+    const double dx = static_cast<double>(line.b.x) - line.a.x;
+    const double dy = static_cast<double>(line.b.y) - line.a.y;
+    flatX = dx == 0.0;
+    flatY = dy == 0.0;
+    invX = flatX ? 0.0 : 1.0 / dx;
+    invY = flatY ? 0.0 : 1.0 / dy;
+}
+
+bool AabbTree::Ray::touches(const Recti &box) const
+{
+    // Slab test, clipping the segment's [0, 1] range to the box on each axis
+    double tMin = 0.0;
+    double tMax = 1.0;
+
+    auto clip = [&](double start, double inv, bool flat, double low, double high)
+    {
+        if (flat)
+        {
+            return start >= low && start <= high;
+        }
+
+        double t1 = (low - start) * inv;
+        double t2 = (high - start) * inv;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        return tMin <= tMax;
+    };
+
+    return clip(ax, invX, flatX, box.x - rayPadding, box.x + box.w + rayPadding) &&
+        clip(ay, invY, flatY, box.y - rayPadding, box.y + box.h + rayPadding);
+}
+
+AabbTree::AabbTree(int margin)
+    : mMargin(std::max(margin, 0))
+{}
+
+int32_t AabbTree::allocateNode()
+{
+    if (mFreeList == NULL_NODE)
+    {
+        mNodes.emplace_back();
+        mNodes.back().height = 0;
+        return static_cast<int32_t>(mNodes.size() - 1);
+    }
+
+    const int32_t index = mFreeList;
+    mFreeList = mNodes[index].parent;
+    mNodes[index] = Node();
+    mNodes[index].height = 0;
+    return index;
+}
+
+void AabbTree::freeNode(int32_t index)
+{
+    mNodes[index] = Node();
+    mNodes[index].parent = mFreeList;
+    mFreeList = index;
+}
+
+Recti AabbTree::combine(const Recti &a, const Recti &b)
+{
+    const int x0 = std::min(a.x, b.x);
+    const int y0 = std::min(a.y, b.y);
+    const int x1 = std::max(a.x + a.w, b.x + b.w);
+    const int y1 = std::max(a.y + a.h, b.y + b.h);
+    return Recti(x0, y0, x1 - x0, y1 - y0);
+}
+
+float AabbTree::distanceSquared(const Vec2i &pos, const Recti &box)
+{
+    const int64_t dx = pos.x < box.x ? box.x - pos.x : (pos.x > box.x + box.w ? pos.x - (box.x + box.w) : 0);
+    const int64_t dy = pos.y < box.y ? box.y - pos.y : (pos.y > box.y + box.h ? pos.y - (box.y + box.h) : 0);
+    return static_cast<float>(dx * dx + dy * dy);
+}
+
+bool AabbTree::hit(const Linei &ray, const Vec2i &pos, const Node &leaf, RayHit *result)
+{
+    Vec2i point;
+    if (!ray.intersectsClosest(pos, leaf.rect, &point))
+    {
+        return false;
+    }
+
+    result->entity = leaf.entity;
+    result->point = point;
+    result->distanceSquared = (pos - point).lengthSquared();
+    return true;
+}
+
+void AabbTree::insertLeaf(int32_t leaf)
+{
+    if (mRoot == NULL_NODE)
+    {
+        mRoot = leaf;
+        mNodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Walk down to the cheapest sibling for the new leaf
+    const Recti leafBox = mNodes[leaf].box;
+    int32_t index = mRoot;
+    while (!mNodes[index].isLeaf())
+    {
+        const Node &node = mNodes[index];
+
+        const int64_t area = perimeter(node.box);
+        const int64_t combinedArea = perimeter(combine(node.box, leafBox));
+
+        // Pairing with this node makes a new parent here
+        const int64_t cost = 2 * combinedArea;
+        // Going further down grows this node's box anyway
+        const int64_t inheritance = 2 * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child)
+        {
+            const Node &childNode = mNodes[child];
+            const int64_t grown = perimeter(combine(leafBox, childNode.box));
+            return (childNode.isLeaf() ? grown : grown - perimeter(childNode.box)) + inheritance;
+        };
+
+        const int64_t cost1 = descendCost(node.child1);
+        const int64_t cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+        {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    const int32_t sibling = index;
+    const int32_t oldParent = mNodes[sibling].parent;
+    const int32_t newParent = allocateNode();
+
+    Node &parent = mNodes[newParent];
+    parent.parent = oldParent;
+    parent.box = combine(leafBox, mNodes[sibling].box);
+    parent.height = mNodes[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+
+    if (oldParent != NULL_NODE)
+    {
+        Node &grandparent = mNodes[oldParent];
+        (grandparent.child1 == sibling ? grandparent.child1 : grandparent.child2) = newParent;
+    }
+    else
+    {
+        mRoot = newParent;
+    }
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+
+    refitFrom(mNodes[leaf].parent);
+}
+
+void AabbTree::removeLeaf(int32_t leaf)
+{
+    if (leaf == mRoot)
+    {
+        mRoot = NULL_NODE;
+        return;
+    }
+
+    // The leaf's parent goes away, its sibling takes the parent's place
+    const int32_t parent = mNodes[leaf].parent;
+    const int32_t grandparent = mNodes[parent].parent;
+    const int32_t sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+    if (grandparent != NULL_NODE)
+    {
+        Node &node = mNodes[grandparent];
+        (node.child1 == parent ? node.child1 : node.child2) = sibling;
+        mNodes[sibling].parent = grandparent;
+        freeNode(parent);
+
+        refitFrom(grandparent);
+    }
+    else
+    {
+        mRoot = sibling;
+        mNodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+    mNodes[leaf].parent = NULL_NODE;
+}
+
+void AabbTree::refitFrom(int32_t index)
+{
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+
+        Node &node = mNodes[index];
+        const Node &child1 = mNodes[node.child1];
+        const Node &child2 = mNodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.box = combine(child1.box, child2.box);
+
+        index = node.parent;
+    }
+}
+
+int32_t AabbTree::balance(int32_t indexA)
+{
+    // Rotates the taller child of A up if the two differ in height by more than one, returns the node now in A's place
+    // A has children B and C, B has D and E, C has F and G
+    Node &a = mNodes[indexA];
+    if (a.isLeaf() || a.height < 2)
+    {
+        return indexA;
+    }
+
+    const int32_t indexB = a.child1;
+    const int32_t indexC = a.child2;
+    Node &b = mNodes[indexB];
+    Node &c = mNodes[indexC];
+
+    const int32_t difference = c.height - b.height;
+
+    // Rotate C up
+    if (difference > 1)
+    {
+        const int32_t indexF = c.child1;
+        const int32_t indexG = c.child2;
+        Node &f = mNodes[indexF];
+        Node &g = mNodes[indexG];
+
+        c.child1 = indexA;
+        c.parent = a.parent;
+        a.parent = indexC;
+
+        if (c.parent != NULL_NODE)
+        {
+            Node &parent = mNodes[c.parent];
+            (parent.child1 == indexA ? parent.child1 : parent.child2) = indexC;
+        }
+        else
+        {
+            mRoot = indexC;
+        }
+
+        // The taller of F and G stays with C
+        if (f.height > g.height)
+        {
+            c.child2 = indexF;
+            a.child2 = indexG;
+            g.parent = indexA;
+            a.box = combine(b.box, g.box);
+            c.box = combine(a.box, f.box);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        }
+        else
+        {
+            c.child2 = indexG;
+            a.child2 = indexF;
+            f.parent = indexA;
+            a.box = combine(b.box, f.box);
+            c.box = combine(a.box, g.box);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+        return indexC;
+    }
+
+    // Rotate B up
+    if (difference < -1)
+    {
+        const int32_t indexD = b.child1;
+        const int32_t indexE = b.child2;
+        Node &d = mNodes[indexD];
+        Node &e = mNodes[indexE];
+
+        b.child1 = indexA;
+        b.parent = a.parent;
+        a.parent = indexB;
+
+        if (b.parent != NULL_NODE)
+        {
+            Node &parent = mNodes[b.parent];
+            (parent.child1 == indexA ? parent.child1 : parent.child2) = indexB;
+        }
+        else
+        {
+            mRoot = indexB;
+        }
+
+        // The taller of D and E stays with B
+        if (d.height > e.height)
+        {
+            b.child2 = indexD;
+            a.child1 = indexE;
+            e.parent = indexA;
+            a.box = combine(c.box, e.box);
+            b.box = combine(a.box, d.box);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        }
+        else
+        {
+            b.child2 = indexE;
+            a.child1 = indexD;
+            d.parent = indexA;
+            a.box = combine(c.box, d.box);
+            b.box = combine(a.box, e.box);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+        return indexB;
+    }
+
+    return indexA;
+}
+
+void AabbTree::insert(Entity entity, const Recti &rect)
+{
+    const int32_t existing = leafOf(entity);
+    if (existing != NULL_NODE)
+    {
+        Node &leaf = mNodes[existing];
+        leaf.rect = rect;
+
+        // Still inside its fat box, nothing above it has to change
+        if (encloses(leaf.box, rect))
+        {
+            return;
+        }
+
+        removeLeaf(existing);
+        mNodes[existing].box = fatten(rect);
+        insertLeaf(existing);
+        return;
+    }
+
+    const int32_t leaf = allocateNode();
+    Node &node = mNodes[leaf];
+    node.entity = entity;
+    node.rect = rect;
+    node.box = fatten(rect);
+
+    if (entity >= mLeaves.size())
+    {
+        mLeaves.resize(static_cast<size_t>(entity) + 1, NOT_IN_TREE);
+    }
+    mLeaves[entity] = static_cast<uint32_t>(leaf);
+    mCount++;
+
+    insertLeaf(leaf);
+}
+
+void AabbTree::remove(Entity entity)
+{
+    const int32_t leaf = leafOf(entity);
+    if (leaf == NULL_NODE)
+    {
+        return;
+    }
+
+    removeLeaf(leaf);
+    freeNode(leaf);
+    mLeaves[entity] = NOT_IN_TREE;
+    mCount--;
+}
+
+void AabbTree::clear()
+{
+    for (const Node &node : mNodes)
+    {
+        if (node.height == 0 && node.entity != NULL_ENTITY)
+        {
+            mLeaves[node.entity] = NOT_IN_TREE;
+        }
+    }
+    mNodes.clear();
+    mRoot = NULL_NODE;
+    mFreeList = NULL_NODE;
+    mCount = 0;
+}
+
+bool AabbTree::raycastClosest(const Linei &ray, const Vec2i &pos, RayHit *result)
+{
+    RayHit best;
+    if (mRoot != NULL_NODE)
+    {
+        const Ray segment(ray);
+
+        mStack.clear();
+        mStack.push_back(mRoot);
+        while (!mStack.empty())
+        {
+            const Node &node = mNodes[mStack.back()];
+            mStack.pop_back();
+
+            // Nothing under here can beat what's been found
+            if (best.distanceSquared >= 0.0f && distanceSquared(pos, node.box) > best.distanceSquared)
+            {
+                continue;
+            }
+            if (!segment.touches(node.box))
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                RayHit candidate;
+                if (hit(ray, pos, node, &candidate) && closer(candidate, best))
+                {
+                    best = candidate;
+                }
+                continue;
+            }
+
+            // Nearer child last, so it's opened first and the other is more likely to be skipped
+            const bool secondNearer = distanceSquared(pos, mNodes[node.child2].box) < distanceSquared(pos, mNodes[node.child1].box);
+            mStack.push_back(secondNearer ? node.child1 : node.child2);
+            mStack.push_back(secondNearer ? node.child2 : node.child1);
+        }
+    }
+
+    *result = best;
+    return best.entity != NULL_ENTITY;
+}
+
+size_t AabbTree::raycastClosest(const Linei *rays, size_t count, const Vec2i &pos, RayHit *results)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        results[i] = RayHit();
+    }
+    if (mRoot == NULL_NODE || count == 0)
+    {
+        return 0;
+    }
+
+    mRays.clear();
+    mBatchRays.clear();
+    mBatchStack.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        mRays.emplace_back(rays[i]);
+    }
+
+    // Queue a node with the rays from 'from' that reach it and could still find something closer there
+    auto push = [&](int32_t index, uint32_t begin, uint32_t end)
+    {
+        const Recti &box = mNodes[index].box;
+        const float distance = distanceSquared(pos, box);
+
+        BatchItem item;
+        item.node = index;
+        item.begin = static_cast<uint32_t>(mBatchRays.size());
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const uint32_t ray = mBatchRays[i];
+            if (results[ray].distanceSquared >= 0.0f && distance > results[ray].distanceSquared)
+            {
+                continue;
+            }
+            if (mRays[ray].touches(box))
+            {
+                mBatchRays.push_back(ray);
+            }
+        }
+        item.end = static_cast<uint32_t>(mBatchRays.size());
+
+        if (item.end > item.begin)
+        {
+            mBatchStack.push_back(item);
+        }
+    };
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        mBatchRays.push_back(i);
+    }
+    push(mRoot, 0, static_cast<uint32_t>(count));
+
+    while (!mBatchStack.empty())
+    {
+        const BatchItem item = mBatchStack.back();
+        mBatchStack.pop_back();
+
+        // Ray lists are stacked like the items, anything past this one's belonged to items already done
+        mBatchRays.resize(item.end);
+
+        const Node &node = mNodes[item.node];
+        if (node.isLeaf())
+        {
+            for (uint32_t i = item.begin; i < item.end; i++)
+            {
+                const uint32_t ray = mBatchRays[i];
+                RayHit candidate;
+                if (hit(rays[ray], pos, node, &candidate) && closer(candidate, results[ray]))
+                {
+                    results[ray] = candidate;
+                }
+            }
+            continue;
+        }
+
+        // Nearer child last, so it's opened first
+        const bool secondNearer = distanceSquared(pos, mNodes[node.child2].box) < distanceSquared(pos, mNodes[node.child1].box);
+        push(secondNearer ? node.child1 : node.child2, item.begin, item.end);
+        push(secondNearer ? node.child2 : node.child1, item.begin, item.end);
+    }
+
+    size_t hits = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        hits += results[i].entity != NULL_ENTITY ? 1 : 0;
+    }
+    return hits;
+}
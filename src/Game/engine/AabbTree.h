@@ -0,0 +1,292 @@
+#ifndef _AABB_TREE_H
+#define _AABB_TREE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Spatial.h"
+#include "ecs/Types.h"
+
+namespace Engine
+{
+    // Where a ray hit an entity's rect
+    struct RayHit
+    {
+        Entity entity = NULL_ENTITY;
+        Vec2i point;
+        // From the position the ray was cast for, -1 if nothing was hit
+        float distanceSquared = -1.0f;
+    };
+
+    // Dynamic bounding volume tree over rects, for ray casts and rect queries.
+    // Leaves hold an entity's rect inside a "fat" box grown by a margin, and every node's box
+    // covers its children. A move that stays inside the fat box only stores the new rect,
+    // anything further re-inserts the leaf and refits the boxes above it, with rotations
+    // keeping the tree balanced.
+    //
+    // Ray casts only open nodes the segment touches and, for the closest hit, that could be closer
+    // than what's been found so far. Hits are tested with Line::intersectsClosest on the exact
+    // rect, so they're the same as checking every rect one by one.
+    // Not thread safe, queries use scratch memory kept in the tree.
+    class AabbTree
+    {
+    private:
+        static constexpr int32_t NULL_NODE = -1;
+        static constexpr uint32_t NOT_IN_TREE = UINT32_MAX;
+
+        struct Node
+        {
+            // Fat box for leaves, covers both children otherwise
+            Recti box;
+            // Exact rect, leaves only
+            Recti rect;
+            Entity entity = NULL_ENTITY;
+
+            // Parent, or the next free node while unused
+            int32_t parent = NULL_NODE;
+            int32_t child1 = NULL_NODE;
+            int32_t child2 = NULL_NODE;
+            // Leaves are 0, free nodes -1
+            int32_t height = -1;
+
+            bool isLeaf() const
+            {
+                return child1 == NULL_NODE;
+            }
+        };
+
+        // A segment set up for testing against boxes
+        struct Ray
+        {
+            double ax = 0.0;
+            double ay = 0.0;
+            double invX = 0.0;
+            double invY = 0.0;
+            bool flatX = false;
+            bool flatY = false;
+
+            explicit Ray(const Linei &line);
+
+            // Does the segment touch the box, edges included?
+            bool touches(const Recti &box) const;
+        };
+
+        // A node of a batched cast, and the rays still worth testing under it (a range of mBatchRays)
+        struct BatchItem
+        {
+            int32_t node = NULL_NODE;
+            uint32_t begin = 0;
+            uint32_t end = 0;
+        };
+
+        int mMargin = 8;
+
+        std::vector<Node> mNodes{};
+        int32_t mRoot = NULL_NODE;
+        int32_t mFreeList = NULL_NODE;
+
+        // Entity ID -> leaf node
+        std::vector<uint32_t> mLeaves{};
+        size_t mCount = 0;
+
+        // Scratch for queries
+        std::vector<int32_t> mStack{};
+        std::vector<Ray> mRays{};
+        std::vector<uint32_t> mBatchRays{};
+        std::vector<BatchItem> mBatchStack{};
+
+        int32_t allocateNode();
+        void freeNode(int32_t index);
+
+        void insertLeaf(int32_t leaf);
+        void removeLeaf(int32_t leaf);
+        int32_t balance(int32_t index);
+        // Refit boxes and heights from 'index' up to the root, balancing on the way
+        void refitFrom(int32_t index);
+
+        Recti fatten(const Recti &rect) const
+        {
+            return Recti(rect.x - mMargin, rect.y - mMargin, rect.w + mMargin * 2, rect.h + mMargin * 2);
+        }
+
+        static Recti combine(const Recti &a, const Recti &b);
+
+        // Box inside 'outer', edges included
+        static bool encloses(const Recti &outer, const Recti &inner)
+        {
+            return inner.x >= outer.x && inner.y >= outer.y &&
+                inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+        }
+
+        // Smallest squared distance from 'pos' to any point of 'box', edges included
+        static float distanceSquared(const Vec2i &pos, const Recti &box);
+
+        // Narrow phase, the same test UpdatePlayer always did
+        static bool hit(const Linei &ray, const Vec2i &pos, const Node &leaf, RayHit *result);
+
+        // Is 'candidate' a better closest hit than 'best'? Ties go to the lower entity, so the result
+        // doesn't depend on the tree's shape
+        static bool closer(const RayHit &candidate, const RayHit &best)
+        {
+            return best.distanceSquared < 0.0f || candidate.distanceSquared < best.distanceSquared ||
+                (candidate.distanceSquared == best.distanceSquared && candidate.entity < best.entity);
+        }
+
+        int32_t leafOf(Entity entity) const
+        {
+            return entity < mLeaves.size() && mLeaves[entity] != NOT_IN_TREE ? static_cast<int32_t>(mLeaves[entity]) : NULL_NODE;
+        }
+
+    public:
+        // 'margin' is how far, in pixels, a rect can move before its leaf has to be re-inserted
+        explicit AabbTree(int margin = 8);
+
+        // Add an entity, or move it if it's already in the tree
+        void insert(Entity entity, const Recti &rect);
+
+        // Move an entity already in the tree (or add it)
+        void update(Entity entity, const Recti &rect)
+        {
+            insert(entity, rect);
+        }
+
+        void remove(Entity entity);
+
+        bool contains(Entity entity) const
+        {
+            return leafOf(entity) != NULL_NODE;
+        }
+
+        // Rect an entity was last inserted with
+        const Recti &rectOf(Entity entity) const
+        {
+            return mNodes[mLeaves[entity]].rect;
+        }
+
+        // Calls func(Entity) once for every entity whose rect overlaps 'rect' (see Rect::overlaps).
+        // func returns false to stop early, and queryRect returns false if it did.
+        // Don't insert or remove from inside func, collect what you need first.
+        template <class F>
+        bool queryRect(const Recti &rect, F &&func)
+        {
+            if (mRoot == NULL_NODE)
+            {
+                return true;
+            }
+
+            mStack.clear();
+            mStack.push_back(mRoot);
+            while (!mStack.empty())
+            {
+                const Node &node = mNodes[mStack.back()];
+                mStack.pop_back();
+
+                if (!node.box.overlaps(rect))
+                {
+                    continue;
+                }
+
+                if (node.isLeaf())
+                {
+                    if (node.rect.overlaps(rect) && !func(node.entity))
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                mStack.push_back(node.child1);
+                mStack.push_back(node.child2);
+            }
+            return true;
+        }
+
+        // Every entity overlapping 'rect', appended to 'out'
+        void collect(const Recti &rect, std::vector<Entity> &out)
+        {
+            queryRect(rect, [&](Entity entity)
+                {
+                    out.push_back(entity);
+                    return true;
+                });
+        }
+
+        // Closest hit along 'ray' to 'pos' (which doesn't have to be the start of the ray).
+        // Returns false and leaves 'result' empty if nothing was hit.
+        bool raycastClosest(const Linei &ray, const Vec2i &pos, RayHit *result);
+
+        // The closest hit for each of 'count' rays, cast together: the tree is walked once,
+        // and each node only tests the rays that reached its parent. Returns how many rays hit something.
+        size_t raycastClosest(const Linei *rays, size_t count, const Vec2i &pos, RayHit *results);
+
+        // Calls func(const RayHit &) for every entity the ray hits, in no particular order.
+        // func returns false to stop early, and raycastAll returns false if it did.
+        template <class F>
+        bool raycastAll(const Linei &ray, const Vec2i &pos, F &&func)
+        {
+            if (mRoot == NULL_NODE)
+            {
+                return true;
+            }
+
+            const Ray segment(ray);
+
+            mStack.clear();
+            mStack.push_back(mRoot);
+            while (!mStack.empty())
+            {
+                const Node &node = mNodes[mStack.back()];
+                mStack.pop_back();
+
+                if (!segment.touches(node.box))
+                {
+                    continue;
+                }
+
+                if (node.isLeaf())
+                {
+                    RayHit result;
+                    if (hit(ray, pos, node, &result) && !func(result))
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                mStack.push_back(node.child1);
+                mStack.push_back(node.child2);
+            }
+            return true;
+        }
+
+        // Every hit along 'ray', appended to 'out'
+        void raycastAll(const Linei &ray, const Vec2i &pos, std::vector<RayHit> &out)
+        {
+            raycastAll(ray, pos, [&](const RayHit &result)
+                {
+                    out.push_back(result);
+                    return true;
+                });
+        }
+
+        void clear();
+
+        size_t size() const
+        {
+            return mCount;
+        }
+
+        // Longest path from the root to a leaf, 0 for a single leaf or an empty tree
+        int height() const
+        {
+            return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height;
+        }
+
+        int margin() const
+        {
+            return mMargin;
+        }
+    };
+}
+
+#endif // _AABB_TREE_H
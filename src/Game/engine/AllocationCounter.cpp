@@ -0,0 +1,119 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if BUILD_PLATFORM_WINDOWS
+#include <malloc.h>
+#endif
+
+using namespace Engine;
+
+namespace
+{
+    std::atomic<uint64_t> allocations{ 0 };
+
+    uint64_t frameStart = 0;
+    uint64_t lastFrameCount = 0;
+}
+
+uint64_t AllocationCounter::total()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::beginFrame()
+{
+    uint64_t now = total();
+    lastFrameCount = now - frameStart;
+    frameStart = now;
+}
+
+uint64_t AllocationCounter::lastFrame()
+{
+    return lastFrameCount;
+}
+
+#if LB_COUNT_ALLOCATIONS
+
+// -- Global operator new/delete --
+// Every form has to be replaced together, so memory from our new is never handed to the default delete
+
+namespace
+{
+    void *countedAlloc(size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void *countedAllocAligned(size_t size, size_t align)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        size = size == 0 ? align : size;
+#if BUILD_PLATFORM_WINDOWS
+        return _aligned_malloc(size, align);
+#else
+        // posix_memalign rejects anything under pointer alignment, which pmr's default resource asks for
+        align = align < sizeof(void *) ? sizeof(void *) : align;
+        void *ptr = nullptr;
+        return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    void freeAligned(void *ptr)
+    {
+#if BUILD_PLATFORM_WINDOWS
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    void *allocOrThrow(size_t size)
+    {
+        void *ptr = countedAlloc(size);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void *allocAlignedOrThrow(size_t size, size_t align)
+    {
+        void *ptr = countedAllocAligned(size, align);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+}
+
+void *operator new(size_t size) { return allocOrThrow(size); }
+void *operator new[](size_t size) { return allocOrThrow(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+
+void *operator new(size_t size, std::align_val_t align) { return allocAlignedOrThrow(size, static_cast<size_t>(align)); }
+void *operator new[](size_t size, std::align_val_t align) { return allocAlignedOrThrow(size, static_cast<size_t>(align)); }
+void *operator new(size_t size, std::align_val_t align, const std::nothrow_t &) noexcept { return countedAllocAligned(size, static_cast<size_t>(align)); }
+void *operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept { return countedAllocAligned(size, static_cast<size_t>(align)); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { freeAligned(ptr); }
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(ptr); }
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { freeAligned(ptr); }
+
+#endif // LB_COUNT_ALLOCATIONS
@@ -0,0 +1,30 @@
+#ifndef _ALLOCATION_COUNTER_H
+#define _ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// Counts every heap allocation made through operator new by replacing the global
+// operator new/delete (see AllocationCounter.cpp). Costs one atomic increment per allocation.
+// Define LB_COUNT_ALLOCATIONS as 0 to compile the hook out.
+#ifndef LB_COUNT_ALLOCATIONS
+#define LB_COUNT_ALLOCATIONS 1
+#endif
+
+namespace Engine
+{
+    namespace AllocationCounter
+    {
+        constexpr bool enabled = LB_COUNT_ALLOCATIONS;
+
+        // Allocations since the program started, on every thread
+        uint64_t total();
+
+        // Roll the count over to a new frame, Game calls this at the start of every update
+        void beginFrame();
+
+        // Allocations during the last complete frame
+        uint64_t lastFrame();
+    }
+}
+
+#endif // _ALLOCATION_COUNTER_H
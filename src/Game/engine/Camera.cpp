@@ -1,5 +1,8 @@
 #include "Camera.h"
 
+#include <engine/Math.h>
+#include <engine/Time.h>
+
 using namespace Engine;
 
 Recti Engine::Camera::getRect() const
@@ -11,3 +14,8 @@ void Engine::Camera::shake(float amt)
 {
 	m_shakeAmp = amt;
 }
+
+Vec2i Engine::Camera::drawPos() const
+{
+	return Math::lerp(m_prevPos, m_pos, Time::interpolation);
+}
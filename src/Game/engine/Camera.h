@@ -15,6 +15,8 @@ namespace Engine
 
 	public:
 		Vec2i m_pos = Vec2i(0, 0);
+		// Where m_pos was at the end of the last tick, set by Game
+		Vec2i m_prevPos = Vec2i(0, 0);
 		Vec2f m_scale = Vec2f(1.0f, 1.0f);
 
 		Vec2i m_size = Vec2i(0, 0);
@@ -23,6 +25,9 @@ namespace Engine
 
 		Recti getRect() const;
 		void shake(float amt);
+
+		// Position to draw from this frame, between the last tick and this one
+		Vec2i drawPos() const;
 	};
 }
 
@@ -0,0 +1,87 @@
+#ifndef _COLLISION_MATRIX_H
+#define _COLLISION_MATRIX_H
+
+#include <array>
+#include <cstdint>
+
+#include "DebugConsole.h"
+
+namespace Engine
+{
+    // Which collision layers interact with each other.
+    // Every collider is on one layer (Collider2D::layer), and a pair of colliders is only tested
+    // when their layers interact. Interaction goes both ways, and every layer interacts with
+    // every other until told otherwise.
+    class CollisionMatrix
+    {
+    public:
+        static constexpr int MAX_LAYERS = 32;
+
+        static constexpr uint32_t bit(uint8_t layer)
+        {
+            return uint32_t(1) << layer;
+        }
+
+        CollisionMatrix()
+        {
+            mMasks.fill(UINT32_MAX);
+        }
+
+        void set(uint8_t a, uint8_t b, bool interact)
+        {
+            LB_ASSERT(a < MAX_LAYERS && b < MAX_LAYERS, "Collision layer out of range.");
+
+            if (interact)
+            {
+                mMasks[a] |= bit(b);
+                mMasks[b] |= bit(a);
+            }
+            else
+            {
+                mMasks[a] &= ~bit(b);
+                mMasks[b] &= ~bit(a);
+            }
+        }
+
+        // Stop 'layer' interacting with anything, including itself
+        void clear(uint8_t layer)
+        {
+            for (int other = 0; other < MAX_LAYERS; other++)
+            {
+                set(layer, static_cast<uint8_t>(other), false);
+            }
+        }
+
+        // Nothing interacts with anything
+        void clearAll()
+        {
+            mMasks.fill(0);
+        }
+
+        bool interacts(uint8_t a, uint8_t b) const
+        {
+            return (mMasks[a] & bit(b)) != 0;
+        }
+
+        // Bits of every layer 'layer' interacts with
+        uint32_t mask(uint8_t layer) const
+        {
+            return mMasks[layer];
+        }
+
+        bool operator==(const CollisionMatrix &rhs) const
+        {
+            return mMasks == rhs.mMasks;
+        }
+
+        bool operator!=(const CollisionMatrix &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        std::array<uint32_t, MAX_LAYERS> mMasks;
+    };
+}
+
+#endif // _COLLISION_MATRIX_H
@@ -5,11 +5,17 @@
 // https://austinmorlan.com/posts/entity_component_system/
 
 #include "ecs/Types.h"
+#include "ecs/TypeIndex.h"
+#include "ecs/EntitySet.h"
 #include "ecs/ComponentArray.h"
+#include "ecs/ArchetypeStorage.h"
+#include "ecs/View.h"
+#include "ecs/CommandBuffer.h"
 #include "ecs/ComponentManager.h"
 #include "ecs/EntityManager.h"
 #include "ecs/System.h"
 #include "ecs/SystemManager.h"
 #include "ecs/Scene.h"
+#include "ecs/SystemPipeline.h"
 
 #endif // _ECS_H
\ No newline at end of file
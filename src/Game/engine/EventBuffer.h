@@ -0,0 +1,61 @@
+#ifndef _EVENT_BUFFER_H
+#define _EVENT_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Engine
+{
+    // Events of one type a system emits during its update, for the systems after it to read.
+    // The emitting system clears it at the start of each update, so it only ever holds
+    // the current frame's events. The storage is kept between frames, so once it has grown
+    // to fit a busy frame pushing never allocates.
+    //
+    // Readers only read, and have to run after the emitter in the same phase.
+    template <class T>
+    class EventBuffer
+    {
+    public:
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        void push(const T &event)
+        {
+            mEvents.push_back(event);
+        }
+
+        void clear()
+        {
+            mEvents.clear();
+        }
+
+        size_t size() const
+        {
+            return mEvents.size();
+        }
+
+        bool empty() const
+        {
+            return mEvents.empty();
+        }
+
+        const T &operator[](size_t index) const
+        {
+            return mEvents[index];
+        }
+
+        const_iterator begin() const
+        {
+            return mEvents.begin();
+        }
+
+        const_iterator end() const
+        {
+            return mEvents.end();
+        }
+
+    private:
+        std::vector<T> mEvents{};
+    };
+}
+
+#endif // _EVENT_BUFFER_H
@@ -0,0 +1,87 @@
+#ifndef _FIXED_TIMESTEP_H
+#define _FIXED_TIMESTEP_H
+
+#include <cmath>
+
+#include "DebugConsole.h"
+
+namespace Engine
+{
+    // Turns frames of any length into a whole number of fixed length ticks.
+    // Frame time is added up, and every full tick's worth of it is one tick to run. What's left over
+    // carries into the next frame, and says how far drawing is between the last tick and the next.
+    //
+    // A frame never runs more than maxTicksPerFrame ticks. After a long hitch the time past that is
+    // dropped, so one slow frame doesn't make the next one slower trying to catch up.
+    class FixedTimestep
+    {
+    public:
+        FixedTimestep(float tickRate = 60.0f, int maxTicksPerFrame = 4)
+        {
+            setup(tickRate, maxTicksPerFrame);
+        }
+
+        void setup(float tickRate, int maxTicksPerFrame)
+        {
+            LB_ASSERT(tickRate > 0.0f, "Tick rate has to be positive.");
+            LB_ASSERT(maxTicksPerFrame > 0, "A frame has to be able to run at least one tick.");
+
+            mTickSeconds = 1.0f / tickRate;
+            mMaxTicksPerFrame = maxTicksPerFrame;
+        }
+
+        // Add a frame's length, returns how many ticks to run for it
+        int advance(float frameSeconds)
+        {
+            mAccumulator += frameSeconds;
+
+            int ticks = 0;
+            while (mAccumulator >= mTickSeconds && ticks < mMaxTicksPerFrame)
+            {
+                mAccumulator -= mTickSeconds;
+                ticks++;
+            }
+
+            // Too far behind, keep only the part of a tick that's left over
+            if (mAccumulator >= mTickSeconds)
+            {
+                const float kept = std::fmod(mAccumulator, mTickSeconds);
+                mDroppedSeconds += mAccumulator - kept;
+                mAccumulator = kept;
+            }
+
+            return ticks;
+        }
+
+        // Forget any time that hasn't been simulated yet
+        void reset()
+        {
+            mAccumulator = 0.0f;
+        }
+
+        float tickSeconds() const
+        {
+            return mTickSeconds;
+        }
+
+        // How far the leftover time is into the next tick (0.0, 1.0)
+        float interpolation() const
+        {
+            return mAccumulator / mTickSeconds;
+        }
+
+        // Frame time thrown away so far because catching up on it would have taken too many ticks
+        float droppedSeconds() const
+        {
+            return mDroppedSeconds;
+        }
+
+    private:
+        float mTickSeconds = 0.0f;
+        int mMaxTicksPerFrame = 0;
+        float mAccumulator = 0.0f;
+        float mDroppedSeconds = 0.0f;
+    };
+}
+
+#endif // _FIXED_TIMESTEP_H
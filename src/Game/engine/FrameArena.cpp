@@ -0,0 +1,100 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace Engine;
+
+FrameArena::FrameArena(size_t initialBytes)
+{
+    addBlock(initialBytes);
+}
+
+void FrameArena::addBlock(size_t minBytes)
+{
+    size_t count = (minBytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+
+    Block block;
+    block.data.reset(new std::max_align_t[count]);
+    block.size = count * sizeof(std::max_align_t);
+    mBlocks.push_back(std::move(block));
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t align)
+{
+    while (true)
+    {
+        if (mBlock < mBlocks.size())
+        {
+            Block &block = mBlocks[mBlock];
+            size_t start = (mOffset + align - 1) / align * align;
+            if (start + bytes <= block.size)
+            {
+                mOffset = start + bytes;
+                mUsed += bytes;
+                return reinterpret_cast<std::byte *>(block.data.get()) + start;
+            }
+
+            // Doesn't fit, try the next block
+            mBlock++;
+            mOffset = 0;
+            continue;
+        }
+
+        // Out of room, grow by at least as much as we already have
+        addBlock(std::max(capacity(), bytes + align));
+    }
+}
+
+const char *FrameArena::format(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    const char *str = formatV(fmt, args);
+    va_end(args);
+    return str;
+}
+
+const char *FrameArena::formatV(const char *fmt, va_list args)
+{
+    va_list sizeArgs;
+    va_copy(sizeArgs, args);
+    int length = std::vsnprintf(nullptr, 0, fmt, sizeArgs);
+    va_end(sizeArgs);
+
+    if (length < 0)
+    {
+        return "";
+    }
+
+    char *str = allocateArray<char>(static_cast<size_t>(length) + 1);
+    std::vsnprintf(str, static_cast<size_t>(length) + 1, fmt, args);
+    return str;
+}
+
+void FrameArena::reset()
+{
+    mPeak = std::max(mPeak, mUsed);
+
+    // Last frame didn't fit in one block, swap them all for a single one that fits everything
+    if (mBlocks.size() > 1)
+    {
+        size_t total = capacity();
+        mBlocks.clear();
+        addBlock(total);
+    }
+
+    mBlock = 0;
+    mOffset = 0;
+    mUsed = 0;
+}
+
+size_t FrameArena::capacity() const
+{
+    size_t total = 0;
+    for (auto const &block : mBlocks)
+    {
+        total += block.size;
+    }
+    return total;
+}
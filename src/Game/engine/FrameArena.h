@@ -0,0 +1,84 @@
+#ifndef _FRAME_ARENA_H
+#define _FRAME_ARENA_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace Engine
+{
+    // Linear allocator for memory that only has to last until the end of the frame.
+    // Allocating bumps an offset, freeing does nothing, and Game rewinds the whole arena
+    // at the start of every frame (see Game::update).
+    //
+    // It's a std::pmr::memory_resource, so standard containers can live in it:
+    //     std::pmr::vector<Entry> entries(&m_scene->frameArena());
+    //
+    // If a frame needs more than the arena holds, extra blocks are allocated, and on the next reset
+    // they're merged into one big block. Once the arena has grown to fit a frame it never allocates again.
+    // Not thread safe, only use it from the main thread.
+    class FrameArena : public std::pmr::memory_resource
+    {
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::max_align_t[]> data;
+            size_t size = 0;
+        };
+
+        std::vector<Block> mBlocks{};
+        // Block currently being filled, and how much of it is used
+        size_t mBlock = 0;
+        size_t mOffset = 0;
+
+        // Bytes handed out this frame and the most handed out in any frame
+        size_t mUsed = 0;
+        size_t mPeak = 0;
+
+        void addBlock(size_t minBytes);
+
+    protected:
+        void *do_allocate(size_t bytes, size_t align) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    public:
+        explicit FrameArena(size_t initialBytes = 64 * 1024);
+
+        FrameArena(const FrameArena &) = delete;
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        // Room for 'count' Ts, left uninitialized
+        template <typename T>
+        T *allocateArray(size_t count)
+        {
+            return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        // printf into arena memory, the string is valid until the end of the frame
+        const char *format(const char *fmt, ...);
+        const char *formatV(const char *fmt, va_list args);
+
+        // Forget everything allocated so far
+        void reset();
+
+        size_t used() const
+        {
+            return mUsed;
+        }
+
+        size_t peak() const
+        {
+            return mPeak;
+        }
+
+        size_t capacity() const;
+    };
+}
+
+#endif // _FRAME_ARENA_H
@@ -2,6 +2,7 @@
 
 #include <app.h>
 
+#include <engine/AllocationCounter.h>
 #include <engine/DebugConsole.h>
 #include <engine/ecs/Scene.h>
 #include <engine/Graphics.h>
@@ -10,10 +11,13 @@
 
 #include <engine/tritone_editor/TritoneEditorScene.h>
 
+#include <chrono>
+#include <cstdio>
+
 using namespace Engine;
 
 Game::Game(const GameConfig &config)
-	: m_config(config)
+	: m_config(config), mTimestep(config.tickRate, config.maxTicksPerFrame)
 {
 }
 
@@ -58,23 +62,57 @@ void Game::init()
 
 void Game::update(const float dt)
 {
-	// auto start = std::chrono::high_resolution_clock::now();
+	const float frameSeconds = dt / 1000.0f;
+
+	// Start a new frame, last frame's scratch memory is no longer in use
+	m_frameArena.reset();
+	AllocationCounter::beginFrame();
+	getScene()->beginFrame();
+
+	if (!m_config.fixedTimestep)
+	{
+		tick(frameSeconds);
+		mTicksLastFrame = 1;
+		Time::interpolation = 1.0f;
+		return;
+	}
+
+	// Every tick sees the same delta, so how things move doesn't depend on the frame rate
+	mTicksLastFrame = mTimestep.advance(frameSeconds);
+	for (int i = 0; i < mTicksLastFrame; i++)
+	{
+		tick(mTimestep.tickSeconds());
+	}
+
+	// Drawing runs once a frame, it sees the frame's delta and how far it is into the next tick
+	Time::deltaSeconds = frameSeconds;
+	Time::delta = frameSeconds / Time::deltaTarget;
+	Time::interpolation = mTimestep.interpolation();
+}
 
-	// Update time
-	Time::deltaSeconds = dt / 1000.0f;
-	Time::delta = Time::deltaSeconds / Time::deltaTarget;
-	Time::seconds += Time::deltaSeconds;
+void Game::tick(float seconds)
+{
+	Time::deltaSeconds = seconds;
+	Time::delta = seconds / Time::deltaTarget;
+	Time::seconds += seconds;
 
-	// Update Input
+	// Input is read once a tick, so a key press is seen by exactly one tick
 	m_input.update();
 
 	handleGlobalControls();
 
-	// Update the scene
-	getScene()->update(dt);
+	if (mRestartQueued)
+	{
+		mRestartQueued = false;
+		applyRestart();
+	}
 
-	// std::chrono::duration<float, std::milli> sleepDuration = std::chrono::high_resolution_clock::now() - start;
-	// Sleep(Time::deltaTarget - sleepDuration.count());
+	// Where the camera was at the end of the last tick, for drawing between the two
+	Scene *scene = getScene();
+	scene->m_camera.m_prevPos = scene->m_camera.m_pos;
+
+	// Update the scene
+	scene->update(seconds * 1000.0f);
 }
 
 void Game::draw()
@@ -96,8 +134,46 @@ void Game::destroyed()
 
 void Engine::Game::restartScene()
 {
-	mSceneStack.top()->restart();
-	mSceneStack.top()->init();
+	mRestartQueued = true;
+}
+
+void Game::sceneInitialized(Scene *scene)
+{
+	if (!scene->canSnapshot())
+	{
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	scene->snapshot(scene->mRestartSnapshot);
+	std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+
+	if (m_config.debugMode)
+	{
+		printf("Snapshot of %s: %zu bytes in %.3fms\n", typeid(*scene).name(), scene->mRestartSnapshot.size(), duration.count());
+	}
+}
+
+void Game::applyRestart()
+{
+	Scene *scene = getScene();
+
+	// Scenes that couldn't be snapshotted are rebuilt from scratch
+	if (scene->mRestartSnapshot.empty())
+	{
+		scene->restart();
+		scene->init();
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	scene->restore(scene->mRestartSnapshot);
+	std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+
+	if (m_config.debugMode)
+	{
+		printf("Restored %s: %zu bytes in %.3fms\n", typeid(*scene).name(), scene->mRestartSnapshot.size(), duration.count());
+	}
 }
 
 void Engine::Game::handleGlobalControls()
@@ -2,12 +2,16 @@
 #define _GAME_H
 
 #include <freeglut_config.h>
+#include <AppSettings.h>
 
 #include <engine/Spatial.h>
 #include <engine/Sprite.h>
 #include <engine/Tritone.h>
 #include <engine/Input.h>
 #include <engine/Camera.h>
+#include <engine/ThreadPool.h>
+#include <engine/FrameArena.h>
+#include <engine/FixedTimestep.h>
 
 #include <stack>
 #include <memory>
@@ -28,6 +32,13 @@ namespace Engine
         bool genMipmaps = false;
 
         bool debugMode = true;
+
+        // Scenes update in fixed ticks of 1 / tickRate seconds however long frames take, and draw
+        // between the last two ticks. Turn it off to update once a frame with that frame's delta.
+        bool fixedTimestep = true;
+        float tickRate = APP_MAX_FRAME_RATE;
+        // Most ticks a slow frame runs to catch up, time past that is dropped
+        int maxTicksPerFrame = 4;
     };
 
     class Game
@@ -42,6 +53,22 @@ namespace Engine
         // Path to the data folder
         std::filesystem::path mDataPath;
 
+        // Set by restartScene, the restart happens at the start of the next update
+        bool mRestartQueued = false;
+
+        // Splits frames into ticks when GameConfig::fixedTimestep is on
+        FixedTimestep mTimestep;
+        int mTicksLastFrame = 0;
+
+        // Run the scene forward one tick of 'seconds'
+        void tick(float seconds);
+
+        // Snapshot a scene that just finished init() so it can be restarted by restoring it
+        void sceneInitialized(Scene *scene);
+
+        // Put the current scene back to how it was after init()
+        void applyRestart();
+
     public:
         // -- Managers --
         // Tritone playback engine
@@ -50,11 +77,17 @@ namespace Engine
         // Main input manager
         Input::Manager m_input;
 
+        // Worker threads for running independent systems at the same time
+        ThreadPool m_threadPool;
+
+        // Scratch memory that's rewound at the start of every frame
+        FrameArena m_frameArena;
+
         Game(const GameConfig &config);
 
         // Call once before adding any scenes to the game
         void init();
-        // Update current scene
+        // Update current scene, 'dt' is the frame's length in milliseconds
         void update(const float dt);
         // Draw current scene
         void draw();
@@ -77,12 +110,15 @@ namespace Engine
 
             // Give scene a reference to the game class
             scene->m_game = this;
+            scene->setThreadPool(&m_threadPool);
+            scene->setFrameArena(&m_frameArena);
 
             // Setup camera object
             scene->m_camera.m_size = getScreenSize();
 
             // Initialize scene
             scene->init();
+            sceneInitialized(scene);
         }
 
         template <class T>
@@ -109,6 +145,12 @@ namespace Engine
         // Get the game configuration
         const GameConfig &getConfig() const { return m_config; }
 
+        // Ticks the last update ran, and frame time dropped so far because catching up would take too many
+        int getTicksLastFrame() const { return mTicksLastFrame; }
+        float getDroppedSeconds() const { return mTimestep.droppedSeconds(); }
+
+        // Restart the current scene at the start of the next update
+        // (safe to call from inside a system or a callback)
         void restartScene();
     };
 }
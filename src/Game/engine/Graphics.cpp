@@ -25,13 +25,13 @@ void Graphics::drawLine(const Linei &line, const Color &col)
 
 void Graphics::drawLineCam(Scene *scene, const Vec2i &start, const Vec2i &end, const Color &col)
 {
-    Vec2i camPos = scene->m_camera.m_pos;
+    Vec2i camPos = scene->m_camera.drawPos();
     drawLine(start - camPos, end - camPos,col);
 }
 
 void Graphics::drawLineCam(Scene *scene, const Linei &line, const Color &col)
 {
-    Vec2i camPos = scene->m_camera.m_pos;
+    Vec2i camPos = scene->m_camera.drawPos();
     drawLine(line - camPos, col);
 }
 
@@ -49,7 +49,7 @@ void Graphics::drawTriangle(const Vec2i p1, const Vec2i p2, const Vec2i p3, cons
 
 void Graphics::drawTriangleCam(Scene *scene, const Vec2i p1, const Vec2i p2, const Vec2i p3, const Color &col, bool isWireframe)
 {
-    Vec2i camPos = scene->m_camera.m_pos;
+    Vec2i camPos = scene->m_camera.drawPos();
     drawTriangle(
         p1 - camPos,
         p2 - camPos,
@@ -74,7 +74,7 @@ void Graphics::drawRect(const Recti &rect, const Color &col)
 
 void Graphics::drawRectCam(Scene *scene, const Recti &rect, const Color &col)
 {
-    Vec2i camPos = scene->m_camera.m_pos;
+    Vec2i camPos = scene->m_camera.drawPos();
     drawRect(rect - camPos, col);
 }
 
@@ -94,24 +94,34 @@ void Graphics::drawRectFilled(const Recti &rect, const Color &col)
 
 void Graphics::drawRectFilledCam(Scene *scene, const Recti &rect, const Color &col)
 {
-    Vec2i camPos = scene->m_camera.m_pos;
+    Vec2i camPos = scene->m_camera.drawPos();
     drawRectFilled(rect - camPos, col);
 }
 
-void Graphics::drawText(const Vec2i &position, const std::string &str, const Color &col, void *font)
+void Graphics::drawText(const Vec2i &position, const char *str, const Color &col, void *font)
 {
     App::Print(position.x, APP_VIRTUAL_HEIGHT - position.y,
-               str.c_str(),
+               str,
                col.r_f32(), col.g_f32(), col.b_f32(),
                font);
 }
 
-void Graphics::drawTextCam(Scene *scene, const Vec2i &position, const std::string &str, const Color &col, void *font)
+void Graphics::drawText(const Vec2i &position, const std::string &str, const Color &col, void *font)
+{
+    drawText(position, str.c_str(), col, font);
+}
+
+void Graphics::drawTextCam(Scene *scene, const Vec2i &position, const char *str, const Color &col, void *font)
 {
-    Vec2i camPos = scene->m_camera.m_pos;
+    Vec2i camPos = scene->m_camera.drawPos();
     drawText(position - camPos, str, col, font);
 }
 
+void Graphics::drawTextCam(Scene *scene, const Vec2i &position, const std::string &str, const Color &col, void *font)
+{
+    drawTextCam(scene, position, str.c_str(), col, font);
+}
+
 void Graphics::windowResized(int w, int h)
 {
     printf("Window resized to: %d, %d\n", w, h);
@@ -36,7 +36,10 @@ namespace Engine
         void drawRectFilledCam(class Scene *scene, const Recti &rect, const Color &col);
         
         // Draw text to the screen ('font' expects a GLUT font)
+        // For text built every frame, format it into frame memory instead of a std::string (FrameArena::format)
+        void drawText(const Vec2i &position, const char *str, const Color &col, void *font = GLUT_BITMAP_HELVETICA_18);
         void drawText(const Vec2i &position, const std::string &str, const Color &col, void *font = GLUT_BITMAP_HELVETICA_18);
+        void drawTextCam(class Scene *scene, const Vec2i &position, const char *str, const Color &col, void *font = GLUT_BITMAP_HELVETICA_18);
         void drawTextCam(class Scene *scene, const Vec2i &position, const std::string &str, const Color &col, void *font = GLUT_BITMAP_HELVETICA_18);
         
         // Window resize callback
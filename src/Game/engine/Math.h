@@ -1,6 +1,7 @@
 #ifndef _MATH_H
 #define _MATH_H
 #include <cmath>
+#include <type_traits>
 
 // Nice math implementation all in one place
 
@@ -98,6 +99,22 @@ namespace Engine
 			return a + (b - a) * fac;
 		}
 
+		// 2D vectors, integer ones are rounded to the nearest pixel
+		template <typename T, template <typename> class Vec>
+		Vec<T> lerp(const Vec<T> &a, const Vec<T> &b, float fac)
+		{
+			if constexpr (std::is_integral_v<T>)
+			{
+				return Vec<T>(
+					static_cast<T>(std::lround(lerp(static_cast<float>(a.x), static_cast<float>(b.x), fac))),
+					static_cast<T>(std::lround(lerp(static_cast<float>(a.y), static_cast<float>(b.y), fac))));
+			}
+			else
+			{
+				return Vec<T>(lerp(a.x, b.x, fac), lerp(a.y, b.y, fac));
+			}
+		}
+
 		// Thank you Freya Holmer for the math behind this function
 		// https://www.youtube.com/watch?v=LSNQuFEDOyQ
 		inline float damp(float a, float b, float fac, float dt)
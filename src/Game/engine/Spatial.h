@@ -2,6 +2,7 @@
 #define _SPATIAL_H
 
 #include <string>
+#include <type_traits>
 #include <unordered_set>
 #include "Math.h"
 
@@ -175,6 +176,9 @@ namespace Engine
 		constexpr bool intersects(const Line<T> &line) const;
 		// Get the point of intersection on rect with a line, which is closest to a given point
 		constexpr bool intersectsClosest(const Vec2<T> pos, const Line<T> &line, Vec2<T> *intersectionPoint = nullptr) const;
+		// Moving one unit at a time along 'dir' ((±1, 0) or (0, ±1)), the first step (1 to maxSteps)
+		// at which rect would overlap another one, or 0 if it doesn't within maxSteps. Integer rects only.
+		constexpr int firstOverlapStep(const Rect &rect, const Vec2<T> &dir, int maxSteps) const;
 
 		const Rect operator+(const Vec2<T> &rhs) const;
 		const Rect operator-(const Vec2<T> &rhs) const;
@@ -586,6 +590,33 @@ namespace Engine
 		return line.intersectsClosest(pos, *this, intersectionPoint);
 	}
 
+	template <class T>
+	constexpr int Rect<T>::firstOverlapStep(const Rect &r, const Vec2<T> &dir, int maxSteps) const
+	{
+		static_assert(std::is_integral_v<T>, "firstOverlapStep needs integer rects.");
+
+		// Moving along one axis never changes overlap on the other
+		const bool alongX = dir.x != 0;
+		if (alongX ? !(y + h > r.y && y < r.y + r.h) : !(x + w > r.x && x < r.x + r.w))
+		{
+			return 0;
+		}
+
+		// Offsets 'd' along the axis where the two overlap (see overlaps), lo <= d <= hi
+		const T pos = alongX ? x : y;
+		const T size = alongX ? w : h;
+		const T otherPos = alongX ? r.x : r.y;
+		const T otherSize = alongX ? r.w : r.h;
+		const int lo = static_cast<int>(otherPos - pos - size + 1);
+		const int hi = static_cast<int>(otherPos + otherSize - pos - 1);
+
+		// Steps are 'd' going forwards, '-d' going backwards
+		const bool forwards = (alongX ? dir.x : dir.y) > 0;
+		const int first = forwards ? (lo > 1 ? lo : 1) : (-hi > 1 ? -hi : 1);
+		const int last = forwards ? (hi < maxSteps ? hi : maxSteps) : (-lo < maxSteps ? -lo : maxSteps);
+		return first <= last ? first : 0;
+	}
+
 	template <class T>
 	const Rect<T> Rect<T>::operator+(const Vec2<T> &rhs) const
 	{
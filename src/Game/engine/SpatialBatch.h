@@ -0,0 +1,512 @@
+#ifndef _SPATIAL_BATCH_H
+#define _SPATIAL_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Spatial.h"
+
+// Widest instruction set the build targets. x64 always has SSE2, AVX2 needs /arch:AVX2 (or -mavx2),
+// Apple silicon and other 64-bit ARM builds have NEON.
+#if defined(__AVX2__)
+#define LB_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LB_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define LB_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Engine
+{
+    // Rects laid out one array per field, so they can be loaded several at a time
+    struct RectBatch
+    {
+        std::vector<int32_t> x;
+        std::vector<int32_t> y;
+        std::vector<int32_t> w;
+        std::vector<int32_t> h;
+
+        void push(const Recti &rect)
+        {
+            x.push_back(rect.x);
+            y.push_back(rect.y);
+            w.push_back(rect.w);
+            h.push_back(rect.h);
+        }
+
+        Recti get(size_t i) const
+        {
+            return Recti(x[i], y[i], w[i], h[i]);
+        }
+
+        void clear()
+        {
+            x.clear();
+            y.clear();
+            w.clear();
+            h.clear();
+        }
+
+        size_t size() const
+        {
+            return x.size();
+        }
+    };
+
+    // Line segments laid out one array per coordinate
+    struct LineBatch
+    {
+        std::vector<int32_t> ax;
+        std::vector<int32_t> ay;
+        std::vector<int32_t> bx;
+        std::vector<int32_t> by;
+
+        void push(const Linei &line)
+        {
+            ax.push_back(line.a.x);
+            ay.push_back(line.a.y);
+            bx.push_back(line.b.x);
+            by.push_back(line.b.y);
+        }
+
+        Linei get(size_t i) const
+        {
+            return Linei(Vec2i(ax[i], ay[i]), Vec2i(bx[i], by[i]));
+        }
+
+        void clear()
+        {
+            ax.clear();
+            ay.clear();
+            bx.clear();
+            by.clear();
+        }
+
+        size_t size() const
+        {
+            return ax.size();
+        }
+    };
+
+    // One Rect or Line tested against a whole RectBatch/LineBatch, several at a time.
+    // Results are bit masks with one bit per item (bit i of word i / 64), and match what Rect::overlaps,
+    // Line::intersects and Line::intersectsClosest return for each item, as long as the math in them
+    // doesn't overflow an int (coordinates within +-32767).
+    //
+    // The kernels are written once against a Lanes type, NativeLanes is the widest the build has and
+    // ScalarLanes is the one-at-a-time fallback (also used for the items left over at the end).
+    namespace SpatialBatch
+    {
+        // One item at a time, a mask lane is all ones or zero
+        struct ScalarLanes
+        {
+            using V = int32_t;
+            static constexpr int width = 1;
+
+            static V load(const int32_t *p) { return *p; }
+            static V set(int32_t value) { return value; }
+            static V ones() { return -1; }
+
+            // Wraps like the vector instructions do, instead of overflowing
+            static V add(V a, V b) { return static_cast<V>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); }
+            static V sub(V a, V b) { return static_cast<V>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b)); }
+            static V mul(V a, V b) { return static_cast<V>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b)); }
+            static V min(V a, V b) { return a < b ? a : b; }
+            static V max(V a, V b) { return a > b ? a : b; }
+
+            static V greater(V a, V b) { return a > b ? -1 : 0; }
+            static V equal(V a, V b) { return a == b ? -1 : 0; }
+            static V bitAnd(V a, V b) { return a & b; }
+            static V bitOr(V a, V b) { return a | b; }
+            static V bitXor(V a, V b) { return a ^ b; }
+            // a and not b
+            static V andNot(V a, V b) { return a & ~b; }
+
+            static uint32_t bits(V m) { return m != 0 ? 1u : 0u; }
+        };
+
+#if defined(LB_SIMD_AVX2)
+        struct Avx2Lanes
+        {
+            using V = __m256i;
+            static constexpr int width = 8;
+
+            static V load(const int32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+            static V set(int32_t value) { return _mm256_set1_epi32(value); }
+            static V ones() { return _mm256_set1_epi32(-1); }
+
+            static V add(V a, V b) { return _mm256_add_epi32(a, b); }
+            static V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+            static V mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+            static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+            static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+
+            static V greater(V a, V b) { return _mm256_cmpgt_epi32(a, b); }
+            static V equal(V a, V b) { return _mm256_cmpeq_epi32(a, b); }
+            static V bitAnd(V a, V b) { return _mm256_and_si256(a, b); }
+            static V bitOr(V a, V b) { return _mm256_or_si256(a, b); }
+            static V bitXor(V a, V b) { return _mm256_xor_si256(a, b); }
+            static V andNot(V a, V b) { return _mm256_andnot_si256(b, a); }
+
+            static uint32_t bits(V m) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(m))); }
+        };
+        using NativeLanes = Avx2Lanes;
+#elif defined(LB_SIMD_SSE2)
+        struct Sse2Lanes
+        {
+            using V = __m128i;
+            static constexpr int width = 4;
+
+            static V load(const int32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+            static V set(int32_t value) { return _mm_set1_epi32(value); }
+            static V ones() { return _mm_set1_epi32(-1); }
+
+            static V add(V a, V b) { return _mm_add_epi32(a, b); }
+            static V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+
+            // SSE2 only multiplies even lanes into 64 bits, do evens and odds and keep the low halves
+            static V mul(V a, V b)
+            {
+                const __m128i even = _mm_mul_epu32(a, b);
+                const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+                return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            }
+
+            // No 32-bit min/max before SSE4.1
+            static V min(V a, V b)
+            {
+                const __m128i aGreater = _mm_cmpgt_epi32(a, b);
+                return _mm_or_si128(_mm_and_si128(aGreater, b), _mm_andnot_si128(aGreater, a));
+            }
+            static V max(V a, V b)
+            {
+                const __m128i aGreater = _mm_cmpgt_epi32(a, b);
+                return _mm_or_si128(_mm_and_si128(aGreater, a), _mm_andnot_si128(aGreater, b));
+            }
+
+            static V greater(V a, V b) { return _mm_cmpgt_epi32(a, b); }
+            static V equal(V a, V b) { return _mm_cmpeq_epi32(a, b); }
+            static V bitAnd(V a, V b) { return _mm_and_si128(a, b); }
+            static V bitOr(V a, V b) { return _mm_or_si128(a, b); }
+            static V bitXor(V a, V b) { return _mm_xor_si128(a, b); }
+            static V andNot(V a, V b) { return _mm_andnot_si128(b, a); }
+
+            static uint32_t bits(V m) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(m))); }
+        };
+        using NativeLanes = Sse2Lanes;
+#elif defined(LB_SIMD_NEON)
+        struct NeonLanes
+        {
+            using V = int32x4_t;
+            static constexpr int width = 4;
+
+            static V load(const int32_t *p) { return vld1q_s32(p); }
+            static V set(int32_t value) { return vdupq_n_s32(value); }
+            static V ones() { return vdupq_n_s32(-1); }
+
+            static V add(V a, V b) { return vaddq_s32(a, b); }
+            static V sub(V a, V b) { return vsubq_s32(a, b); }
+            static V mul(V a, V b) { return vmulq_s32(a, b); }
+            static V min(V a, V b) { return vminq_s32(a, b); }
+            static V max(V a, V b) { return vmaxq_s32(a, b); }
+
+            static V greater(V a, V b) { return vreinterpretq_s32_u32(vcgtq_s32(a, b)); }
+            static V equal(V a, V b) { return vreinterpretq_s32_u32(vceqq_s32(a, b)); }
+            static V bitAnd(V a, V b) { return vandq_s32(a, b); }
+            static V bitOr(V a, V b) { return vorrq_s32(a, b); }
+            static V bitXor(V a, V b) { return veorq_s32(a, b); }
+            static V andNot(V a, V b) { return vbicq_s32(a, b); }
+
+            // One bit per lane, added across
+            static uint32_t bits(V m)
+            {
+                static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+                return vaddvq_u32(vandq_u32(vreinterpretq_u32_s32(m), vld1q_u32(laneBits)));
+            }
+        };
+        using NativeLanes = NeonLanes;
+#else
+        using NativeLanes = ScalarLanes;
+#endif
+
+        // Words a mask over 'count' items needs
+        inline size_t maskWords(size_t count)
+        {
+            return (count + 63) / 64;
+        }
+
+        inline bool maskTest(const std::vector<uint64_t> &mask, size_t i)
+        {
+            return (mask[i / 64] >> (i % 64)) & 1u;
+        }
+
+        // Calls func(index) for every set bit of a mask over 'count' items, in order
+        template <class F>
+        void forEachSet(const std::vector<uint64_t> &mask, size_t count, F &&func)
+        {
+            for (size_t word = 0; word < maskWords(count); word++)
+            {
+                uint64_t bits = mask[word];
+                for (size_t i = word * 64; bits != 0; i++, bits >>= 1)
+                {
+                    if (bits & 1u)
+                    {
+                        func(i);
+                    }
+                }
+            }
+        }
+
+        namespace Kernels
+        {
+            // Rect::overlaps, 'rect' against each lane
+            template <class L>
+            typename L::V overlaps(const Recti &rect, typename L::V x, typename L::V y, typename L::V w, typename L::V h)
+            {
+                const typename L::V left = L::set(rect.x);
+                const typename L::V top = L::set(rect.y);
+                const typename L::V right = L::set(rect.x + rect.w);
+                const typename L::V bottom = L::set(rect.y + rect.h);
+
+                return L::bitAnd(
+                    L::bitAnd(L::greater(right, x), L::greater(bottom, y)),
+                    L::bitAnd(L::greater(L::add(x, w), left), L::greater(L::add(y, h), top)));
+            }
+
+            // Orientation of the triplet p, q, r as Line::intersects works it out, before taking its sign
+            template <class L>
+            typename L::V orientation(typename L::V px, typename L::V py, typename L::V qx, typename L::V qy, typename L::V rx, typename L::V ry)
+            {
+                return L::sub(L::mul(L::sub(qy, py), L::sub(rx, qx)), L::mul(L::sub(qx, px), L::sub(ry, qy)));
+            }
+
+            // q inside the box spanned by p and r, edges included
+            template <class L>
+            typename L::V onSegment(typename L::V px, typename L::V py, typename L::V qx, typename L::V qy, typename L::V rx, typename L::V ry)
+            {
+                const typename L::V outside = L::bitOr(
+                    L::bitOr(L::greater(qx, L::max(px, rx)), L::greater(L::min(px, rx), qx)),
+                    L::bitOr(L::greater(qy, L::max(py, ry)), L::greater(L::min(py, ry), qy)));
+                return L::andNot(L::ones(), outside);
+            }
+
+            // Orientations differ when their signs do
+            template <class L>
+            typename L::V differ(typename L::V first, typename L::V second)
+            {
+                const typename L::V zero = L::set(0);
+                return L::bitOr(
+                    L::bitXor(L::greater(first, zero), L::greater(second, zero)),
+                    L::bitXor(L::greater(zero, first), L::greater(zero, second)));
+            }
+
+            // The end of Line::intersects(Line) for segment a-b against c-d, once the four orientations are known.
+            // 'onSegment1/2' are c and d inside the box spanned by a and b.
+            template <class L>
+            typename L::V intersects(typename L::V o1, typename L::V o2, typename L::V o3, typename L::V o4,
+                typename L::V onSegment1, typename L::V onSegment2,
+                typename L::V ax, typename L::V ay, typename L::V bx, typename L::V by,
+                typename L::V cx, typename L::V cy, typename L::V dx, typename L::V dy)
+            {
+                const typename L::V zero = L::set(0);
+
+                const typename L::V general = L::bitAnd(differ<L>(o1, o2), differ<L>(o3, o4));
+
+                // Collinear and touching
+                const typename L::V special = L::bitOr(
+                    L::bitOr(
+                        L::bitAnd(L::equal(o1, zero), onSegment1),
+                        L::bitAnd(L::equal(o2, zero), onSegment2)),
+                    L::bitOr(
+                        L::bitAnd(L::equal(o3, zero), onSegment<L>(cx, cy, ax, ay, dx, dy)),
+                        L::bitAnd(L::equal(o4, zero), onSegment<L>(cx, cy, bx, by, dx, dy))));
+
+                return L::bitOr(general, special);
+            }
+
+            // Line::intersects(Line), segment a-b against each lane's segment c-d
+            template <class L>
+            typename L::V intersects(typename L::V ax, typename L::V ay, typename L::V bx, typename L::V by,
+                typename L::V cx, typename L::V cy, typename L::V dx, typename L::V dy)
+            {
+                return intersects<L>(
+                    orientation<L>(ax, ay, bx, by, cx, cy),
+                    orientation<L>(ax, ay, bx, by, dx, dy),
+                    orientation<L>(cx, cy, dx, dy, ax, ay),
+                    orientation<L>(cx, cy, dx, dy, bx, by),
+                    onSegment<L>(ax, ay, cx, cy, bx, by),
+                    onSegment<L>(ax, ay, dx, dy, bx, by),
+                    ax, ay, bx, by, cx, cy, dx, dy);
+            }
+
+            // Line::intersects(Rect), any of the four edges.
+            // The edges share corners and lie along the axes, so most of the products Line::intersects works out
+            // are shared or multiplied by zero. Only the rest are done, which gives the same values.
+            template <class L>
+            typename L::V intersects(const Linei &line, typename L::V x, typename L::V y, typename L::V w, typename L::V h)
+            {
+                const typename L::V ax = L::set(line.a.x);
+                const typename L::V ay = L::set(line.a.y);
+                const typename L::V bx = L::set(line.b.x);
+                const typename L::V by = L::set(line.b.y);
+                const typename L::V lineX = L::set(line.b.x - line.a.x);
+                const typename L::V lineY = L::set(line.b.y - line.a.y);
+                const typename L::V zero = L::set(0);
+
+                const typename L::V right = L::add(x, w);
+                const typename L::V bottom = L::add(y, h);
+
+                // Orientation of the line and each corner
+                const typename L::V leftTerm = L::mul(lineY, L::sub(x, bx));
+                const typename L::V rightTerm = L::mul(lineY, L::sub(right, bx));
+                const typename L::V topTerm = L::mul(lineX, L::sub(y, by));
+                const typename L::V bottomTerm = L::mul(lineX, L::sub(bottom, by));
+                const typename L::V topLeft = L::sub(leftTerm, topTerm);
+                const typename L::V topRight = L::sub(rightTerm, topTerm);
+                const typename L::V bottomLeft = L::sub(leftTerm, bottomTerm);
+                const typename L::V bottomRight = L::sub(rightTerm, bottomTerm);
+
+                const typename L::V onTopLeft = onSegment<L>(ax, ay, x, y, bx, by);
+                const typename L::V onTopRight = onSegment<L>(ax, ay, right, y, bx, by);
+                const typename L::V onBottomLeft = onSegment<L>(ax, ay, x, bottom, bx, by);
+                const typename L::V onBottomRight = onSegment<L>(ax, ay, right, bottom, bx, by);
+
+                // Orientation of each edge and the line's ends
+                const typename L::V leftEdge = intersects<L>(topLeft, bottomLeft,
+                    L::mul(h, L::sub(ax, x)), L::mul(h, L::sub(bx, x)), onTopLeft, onBottomLeft,
+                    ax, ay, bx, by, x, y, x, bottom);
+                const typename L::V rightEdge = intersects<L>(topRight, bottomRight,
+                    L::mul(h, L::sub(ax, right)), L::mul(h, L::sub(bx, right)), onTopRight, onBottomRight,
+                    ax, ay, bx, by, right, y, right, bottom);
+                const typename L::V topEdge = intersects<L>(topLeft, topRight,
+                    L::sub(zero, L::mul(w, L::sub(ay, y))), L::sub(zero, L::mul(w, L::sub(by, y))), onTopLeft, onTopRight,
+                    ax, ay, bx, by, x, y, right, y);
+                const typename L::V bottomEdge = intersects<L>(bottomLeft, bottomRight,
+                    L::sub(zero, L::mul(w, L::sub(ay, bottom))), L::sub(zero, L::mul(w, L::sub(by, bottom))), onBottomLeft, onBottomRight,
+                    ax, ay, bx, by, x, bottom, right, bottom);
+
+                return L::bitOr(L::bitOr(leftEdge, rightEdge), L::bitOr(topEdge, bottomEdge));
+            }
+
+            // Runs 'kernel(lanesType, index)' over every item, L::width at a time and the rest one by one,
+            // writing the bits it returns into 'mask'. Returns how many bits were set.
+            template <class L, class K>
+            size_t run(size_t count, std::vector<uint64_t> &mask, K &&kernel)
+            {
+                mask.assign(maskWords(count), 0);
+
+                size_t hits = 0;
+                auto store = [&](size_t i, uint32_t bits, int width)
+                {
+                    for (int lane = 0; lane < width; lane++)
+                    {
+                        if ((bits >> lane) & 1u)
+                        {
+                            mask[(i + lane) / 64] |= uint64_t(1) << ((i + lane) % 64);
+                            hits++;
+                        }
+                    }
+                };
+
+                size_t i = 0;
+                for (; i + L::width <= count; i += L::width)
+                {
+                    store(i, L::bits(kernel(L(), i)), L::width);
+                }
+                for (; i < count; i++)
+                {
+                    store(i, ScalarLanes::bits(kernel(ScalarLanes(), i)), 1);
+                }
+                return hits;
+            }
+        }
+
+        // rect.overlaps(rects[i]) for every rect, into 'mask'. Returns how many overlap.
+        template <class L = NativeLanes>
+        size_t overlaps(const Recti &rect, const RectBatch &rects, std::vector<uint64_t> &mask)
+        {
+            return Kernels::run<L>(rects.size(), mask, [&](auto lanes, size_t i)
+                {
+                    using Lanes = decltype(lanes);
+                    return Kernels::overlaps<Lanes>(rect, Lanes::load(&rects.x[i]), Lanes::load(&rects.y[i]), Lanes::load(&rects.w[i]), Lanes::load(&rects.h[i]));
+                });
+        }
+
+        // line.intersects(rects[i]) for every rect, into 'mask'. Returns how many are hit.
+        template <class L = NativeLanes>
+        size_t intersects(const Linei &line, const RectBatch &rects, std::vector<uint64_t> &mask)
+        {
+            return Kernels::run<L>(rects.size(), mask, [&](auto lanes, size_t i)
+                {
+                    using Lanes = decltype(lanes);
+                    return Kernels::intersects<Lanes>(line, Lanes::load(&rects.x[i]), Lanes::load(&rects.y[i]), Lanes::load(&rects.w[i]), Lanes::load(&rects.h[i]));
+                });
+        }
+
+        // line.intersects(lines[i]) for every line, into 'mask'. Returns how many are hit.
+        template <class L = NativeLanes>
+        size_t intersects(const Linei &line, const LineBatch &lines, std::vector<uint64_t> &mask)
+        {
+            return Kernels::run<L>(lines.size(), mask, [&](auto lanes, size_t i)
+                {
+                    using Lanes = decltype(lanes);
+                    return Kernels::intersects<Lanes>(
+                        Lanes::set(line.a.x), Lanes::set(line.a.y), Lanes::set(line.b.x), Lanes::set(line.b.y),
+                        Lanes::load(&lines.ax[i]), Lanes::load(&lines.ay[i]), Lanes::load(&lines.bx[i]), Lanes::load(&lines.by[i]));
+                });
+        }
+
+        // The rect whose Line::intersectsClosest point is closest to 'pos', as if checking them in order and
+        // keeping the first of any ties. Returns its index, or -1 if the line misses every rect.
+        // 'mask' is scratch, keep one around so this doesn't allocate.
+        template <class L = NativeLanes>
+        int intersectsClosest(const Linei &line, const Vec2i &pos, const RectBatch &rects, std::vector<uint64_t> &mask, Vec2i *intersectionPoint = nullptr)
+        {
+            int closest = -1;
+            if (intersects<L>(line, rects, mask) == 0)
+            {
+                return closest;
+            }
+
+            // Only the rects that were hit need the exact point
+            float closestLength = -1.0f;
+            Vec2i closestPoint;
+            forEachSet(mask, rects.size(), [&](size_t i)
+                {
+                    Vec2i point;
+                    if (line.intersectsClosest(pos, rects.get(i), &point))
+                    {
+                        float length = (pos - point).lengthSquared();
+                        if (closestLength < 0 || length < closestLength)
+                        {
+                            closestLength = length;
+                            closestPoint = point;
+                            closest = static_cast<int>(i);
+                        }
+                    }
+                });
+
+            if (intersectionPoint && closest >= 0)
+            {
+                *intersectionPoint = closestPoint;
+            }
+            return closest;
+        }
+
+        // Calls func(index) for every rect overlapping 'rect', in order
+        template <class L = NativeLanes, class F>
+        void forEachOverlap(const Recti &rect, const RectBatch &rects, std::vector<uint64_t> &mask, F &&func)
+        {
+            if (overlaps<L>(rect, rects, mask) > 0)
+            {
+                forEachSet(mask, rects.size(), func);
+            }
+        }
+    }
+}
+
+#endif // _SPATIAL_BATCH_H
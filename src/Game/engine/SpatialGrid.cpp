@@ -0,0 +1,146 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+
+using namespace Engine;
+
+namespace
+{
+    // Rounds toward negative infinity, so cells left of and above the origin work too
+    int floorDiv(int value, int divisor)
+    {
+        int quotient = value / divisor;
+        return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+    }
+}
+
+SpatialGrid::SpatialGrid(int cellSize, uint32_t bucketCount)
+    : mCellSize(std::max(cellSize, 1))
+{
+    uint32_t count = 1;
+    while (count < bucketCount)
+    {
+        count <<= 1;
+    }
+    mBuckets.resize(count);
+    mBucketMask = count - 1;
+}
+
+SpatialGrid::CellRange SpatialGrid::cellsOf(const Recti &rect) const
+{
+    // Rects include their left/top edge but not their right/bottom one, like Rect::overlaps
+    CellRange cells;
+    cells.x0 = floorDiv(rect.x, mCellSize);
+    cells.y0 = floorDiv(rect.y, mCellSize);
+    cells.x1 = floorDiv(rect.x + std::max(rect.w, 1) - 1, mCellSize);
+    cells.y1 = floorDiv(rect.y + std::max(rect.h, 1) - 1, mCellSize);
+    return cells;
+}
+
+uint32_t SpatialGrid::nextQueryStamp()
+{
+    // Wrapped around, stamps left on items could match again
+    if (++mQueryStamp == 0)
+    {
+        for (Item &item : mItems)
+        {
+            item.queryStamp = 0;
+        }
+        mQueryStamp = 1;
+    }
+    return mQueryStamp;
+}
+
+void SpatialGrid::addToCells(Entity entity, const CellRange &cells)
+{
+    for (int cellY = cells.y0; cellY <= cells.y1; cellY++)
+    {
+        for (int cellX = cells.x0; cellX <= cells.x1; cellX++)
+        {
+            bucket(cellX, cellY).push_back(entity);
+        }
+    }
+}
+
+void SpatialGrid::removeFromCells(Entity entity, const CellRange &cells)
+{
+    // One entry per cell, even when two of the cells share a bucket
+    for (int cellY = cells.y0; cellY <= cells.y1; cellY++)
+    {
+        for (int cellX = cells.x0; cellX <= cells.x1; cellX++)
+        {
+            std::vector<Entity> &entities = bucket(cellX, cellY);
+            auto it = std::find(entities.begin(), entities.end(), entity);
+            if (it != entities.end())
+            {
+                *it = entities.back();
+                entities.pop_back();
+            }
+        }
+    }
+}
+
+void SpatialGrid::insert(Entity entity, const Recti &rect, uint32_t layerBits)
+{
+    const CellRange cells = cellsOf(rect);
+
+    if (Item *item = find(entity))
+    {
+        item->rect = rect;
+        item->layerBits = layerBits;
+        if (!(item->cells == cells))
+        {
+            removeFromCells(entity, item->cells);
+            addToCells(entity, cells);
+            item->cells = cells;
+        }
+        return;
+    }
+
+    if (entity >= mSlots.size())
+    {
+        mSlots.resize(static_cast<size_t>(entity) + 1, NOT_IN_GRID);
+    }
+    mSlots[entity] = static_cast<uint32_t>(mItems.size());
+
+    Item item;
+    item.entity = entity;
+    item.rect = rect;
+    item.cells = cells;
+    item.layerBits = layerBits;
+    mItems.push_back(item);
+
+    addToCells(entity, cells);
+}
+
+void SpatialGrid::remove(Entity entity)
+{
+    Item *item = find(entity);
+    if (!item)
+    {
+        return;
+    }
+
+    removeFromCells(entity, item->cells);
+
+    // Keep items packed
+    const uint32_t slot = mSlots[entity];
+    const Entity last = mItems.back().entity;
+    mItems[slot] = mItems.back();
+    mSlots[last] = slot;
+    mItems.pop_back();
+    mSlots[entity] = NOT_IN_GRID;
+}
+
+void SpatialGrid::clear()
+{
+    for (auto &entities : mBuckets)
+    {
+        entities.clear();
+    }
+    for (const Item &item : mItems)
+    {
+        mSlots[item.entity] = NOT_IN_GRID;
+    }
+    mItems.clear();
+}
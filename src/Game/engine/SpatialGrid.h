@@ -0,0 +1,194 @@
+#ifndef _SPATIAL_GRID_H
+#define _SPATIAL_GRID_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Spatial.h"
+#include "ecs/Types.h"
+
+namespace Engine
+{
+    // Uniform grid broadphase for rects, bucketed by the cells they cover.
+    // The world is unbounded, cells are hashed into a fixed number of buckets, and every
+    // entity is listed in the bucket of each cell its rect touches. A query only looks at
+    // the buckets under the query rect and tests the rects stored here, so it never has to
+    // fetch the entities' components.
+    //
+    // Moving an entity inside the cells it already covers only stores the new rect.
+    // Buckets keep their memory, so a grid that has settled doesn't allocate.
+    //
+    // Entities can be given collision layer bits (see CollisionMatrix). Queries with a layer mask
+    // skip anything on other layers before testing its rect.
+    // Not thread safe, queries write to the grid (see query).
+    class SpatialGrid
+    {
+    private:
+        // Range of cells a rect covers, inclusive
+        struct CellRange
+        {
+            int x0 = 0;
+            int y0 = 0;
+            int x1 = -1;
+            int y1 = -1;
+
+            bool operator==(const CellRange &rhs) const
+            {
+                return x0 == rhs.x0 && y0 == rhs.y0 && x1 == rhs.x1 && y1 == rhs.y1;
+            }
+        };
+
+        struct Item
+        {
+            Entity entity = NULL_ENTITY;
+            Recti rect;
+            CellRange cells;
+            uint32_t layerBits = UINT32_MAX;
+            // Last query that saw this item, so entities covering several cells are only reported once
+            uint32_t queryStamp = 0;
+        };
+
+        static constexpr uint32_t NOT_IN_GRID = UINT32_MAX;
+
+        int mCellSize = 64;
+
+        std::vector<std::vector<Entity>> mBuckets{};
+        uint32_t mBucketMask = 0;
+
+        // Items are packed, mSlots maps entity IDs to them
+        std::vector<Item> mItems{};
+        std::vector<uint32_t> mSlots{};
+
+        uint32_t mQueryStamp = 0;
+
+        CellRange cellsOf(const Recti &rect) const;
+
+        uint32_t nextQueryStamp();
+
+        std::vector<Entity> &bucket(int cellX, int cellY)
+        {
+            // Large primes, so neighbouring cells land in unrelated buckets
+            uint32_t hash = static_cast<uint32_t>(cellX) * 73856093u ^ static_cast<uint32_t>(cellY) * 19349663u;
+            return mBuckets[hash & mBucketMask];
+        }
+
+        void addToCells(Entity entity, const CellRange &cells);
+        void removeFromCells(Entity entity, const CellRange &cells);
+
+        Item *find(Entity entity)
+        {
+            return entity < mSlots.size() && mSlots[entity] != NOT_IN_GRID ? &mItems[mSlots[entity]] : nullptr;
+        }
+
+    public:
+        static constexpr uint32_t ALL_LAYERS = UINT32_MAX;
+
+        // 'cellSize' should be about the size of the things in the grid,
+        // 'bucketCount' is rounded up to a power of two
+        explicit SpatialGrid(int cellSize = 64, uint32_t bucketCount = 4096);
+
+        // Add an entity, or move it if it's already in the grid
+        void insert(Entity entity, const Recti &rect, uint32_t layerBits = ALL_LAYERS);
+
+        // Move an entity already in the grid keeping its layer bits (or add it)
+        void update(Entity entity, const Recti &rect)
+        {
+            const Item *item = find(entity);
+            insert(entity, rect, item ? item->layerBits : ALL_LAYERS);
+        }
+
+        void remove(Entity entity);
+
+        bool contains(Entity entity) const
+        {
+            return entity < mSlots.size() && mSlots[entity] != NOT_IN_GRID;
+        }
+
+        // Rect an entity was last inserted with
+        const Recti &rectOf(Entity entity) const
+        {
+            return mItems[mSlots[entity]].rect;
+        }
+
+        uint32_t layerBitsOf(Entity entity) const
+        {
+            return mItems[mSlots[entity]].layerBits;
+        }
+
+        // Calls func(Entity, const Recti &) once for every entity in the cells under 'rect' with one of the
+        // layer bits in 'layerMask', without testing the rects themselves. For callers that want to
+        // count or do their own narrow phase. Same early out and rules as query.
+        template <class F>
+        bool forEachCandidate(const Recti &rect, uint32_t layerMask, F &&func)
+        {
+            const CellRange cells = cellsOf(rect);
+            const uint32_t stamp = nextQueryStamp();
+
+            for (int cellY = cells.y0; cellY <= cells.y1; cellY++)
+            {
+                for (int cellX = cells.x0; cellX <= cells.x1; cellX++)
+                {
+                    for (Entity entity : bucket(cellX, cellY))
+                    {
+                        Item &item = mItems[mSlots[entity]];
+                        if (item.queryStamp == stamp)
+                        {
+                            continue;
+                        }
+                        item.queryStamp = stamp;
+
+                        if ((item.layerBits & layerMask) != 0 && !func(entity, item.rect))
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Calls func(Entity) once for every entity whose rect overlaps 'rect' (see Rect::overlaps).
+        // func returns false to stop early, and query returns false if it did.
+        // Don't insert or remove from inside func, collect what you need first.
+        template <class F>
+        bool query(const Recti &rect, F &&func)
+        {
+            return query(rect, ALL_LAYERS, std::forward<F>(func));
+        }
+
+        // Same, only for entities with one of the layer bits in 'layerMask'
+        template <class F>
+        bool query(const Recti &rect, uint32_t layerMask, F &&func)
+        {
+            return forEachCandidate(rect, layerMask, [&](Entity entity, const Recti &itemRect)
+                {
+                    return !itemRect.overlaps(rect) || func(entity);
+                });
+        }
+
+        // Every entity overlapping 'rect', appended to 'out'
+        void collect(const Recti &rect, std::vector<Entity> &out)
+        {
+            query(rect, [&](Entity entity)
+                {
+                    out.push_back(entity);
+                    return true;
+                });
+        }
+
+        void clear();
+
+        size_t size() const
+        {
+            return mItems.size();
+        }
+
+        int cellSize() const
+        {
+            return mCellSize;
+        }
+    };
+}
+
+#endif // _SPATIAL_GRID_H
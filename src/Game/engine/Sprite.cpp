@@ -155,7 +155,7 @@ void Sprite::DrawEx(const Vec2f &pos, const Vec2f &scale, const int anim, const
 
 void Engine::Sprite::DrawExCam(const Vec2f &pos, const Vec2f &scale, const int anim, const Color &color)
 {
-	Vec2i camPos = m_game->getScene()->m_camera.m_pos;
+	Vec2i camPos = m_game->getScene()->m_camera.drawPos();
 	DrawEx(pos - camPos, scale, anim, color);
 }
 
@@ -0,0 +1,112 @@
+#include "ThreadPool.h"
+
+using namespace Engine;
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    mThreads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        mThreads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mWake.notify_all();
+
+    for (auto &thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, void (*job)(void *context, size_t index), void *context)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Not worth waking anyone for
+    if (count == 1 || mThreads.empty())
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            job(context, i);
+        }
+        return;
+    }
+
+    {
+        // The last batch is finished and every worker has left it, safe to swap it out
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJob = job;
+        mContext = context;
+        mCount = count;
+        mNext.store(0, std::memory_order_relaxed);
+        mGeneration++;
+    }
+    mWake.notify_all();
+
+    runJobs();
+
+    // Jobs handed out are finished once every worker that took one has left
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() { return mActive == 0; });
+
+    mJob = nullptr;
+    mContext = nullptr;
+    mCount = 0;
+}
+
+void ThreadPool::runJobs()
+{
+    while (true)
+    {
+        size_t index = mNext.fetch_add(1, std::memory_order_relaxed);
+        if (index >= mCount)
+        {
+            return;
+        }
+        mJob(mContext, index);
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    uint64_t seen = 0;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mWake.wait(lock, [&]() { return mQuit || mGeneration != seen; });
+        if (mQuit)
+        {
+            return;
+        }
+        seen = mGeneration;
+
+        // Woke up after the batch was already finished, nothing to do
+        if (mJob == nullptr)
+        {
+            continue;
+        }
+
+        mActive++;
+        lock.unlock();
+
+        runJobs();
+
+        lock.lock();
+        mActive--;
+        if (mActive == 0)
+        {
+            mDone.notify_all();
+        }
+    }
+}
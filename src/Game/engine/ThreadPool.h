@@ -0,0 +1,81 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Engine
+{
+    // A fixed set of worker threads for running a batch of independent jobs.
+    // The thread calling parallelFor works through the batch too, so a pool with
+    // no workers just runs everything on the caller.
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> mThreads{};
+
+        std::mutex mMutex;
+        // Signalled when a new batch is ready (or the pool is shutting down)
+        std::condition_variable mWake;
+        // Signalled when the last worker leaves a batch
+        std::condition_variable mDone;
+
+        // Current batch, only changed while no worker is inside it
+        void (*mJob)(void *context, size_t index) = nullptr;
+        void *mContext = nullptr;
+        size_t mCount = 0;
+        std::atomic<size_t> mNext{ 0 };
+
+        // Bumped for every batch, so workers can tell a new one apart from a spurious wake
+        uint64_t mGeneration = 0;
+        // Workers currently taking jobs from the batch
+        size_t mActive = 0;
+        bool mQuit = false;
+
+        void workerLoop();
+
+        // Take jobs from the current batch until there are none left
+        void runJobs();
+
+    public:
+        // Defaults to one worker per hardware thread, minus the one calling parallelFor
+        explicit ThreadPool(size_t threadCount = defaultThreadCount());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Call job(context, i) for every i in [0, count), returns once they've all finished
+        // Not re-entrant, don't call parallelFor from inside a job
+        void parallelFor(size_t count, void (*job)(void *context, size_t index), void *context);
+
+        // Same as above for any callable taking the index, e.g. a lambda (doesn't allocate)
+        template <typename Func>
+        void parallelFor(size_t count, Func &&job)
+        {
+            parallelFor(count, [](void *context, size_t index)
+                { (*static_cast<std::remove_reference_t<Func> *>(context))(index); },
+                const_cast<void *>(static_cast<const void *>(&job)));
+        }
+
+        // Number of worker threads (not counting the caller)
+        size_t threadCount() const
+        {
+            return mThreads.size();
+        }
+
+        static size_t defaultThreadCount()
+        {
+            unsigned int hardware = std::thread::hardware_concurrency();
+            return hardware > 1 ? hardware - 1 : 0;
+        }
+    };
+}
+
+#endif // _THREAD_POOL_H
@@ -16,6 +16,10 @@ namespace Time
 	// Number of seconds since program started
 	inline float seconds = 0.0f;
 
+	// How far drawing is between the last simulation tick and the next one (0.0, 1.0),
+	// see Game::update and TransformCommon::drawPos
+	inline float interpolation = 1.0f;
+
 	// Return true on interval
 	bool onInterval(float interval, float offset = 0.0f);
 }
@@ -6,6 +6,8 @@
 #include <engine/Graphics.h>
 #include <engine/ecs/System.h>
 
+#include <vector>
+
 struct Animator
 {
     Engine::Sprite *sprite = nullptr;
@@ -30,7 +32,24 @@ class UpdateAndDrawAnimator : public Engine::System
 {
 public:
     void init() override;
+    void entityAdded(Engine::Entity const &ent) override;
+    void entityRemoved(Engine::Entity const &ent) override;
     void update() override;
+    void restored() override;
+
+private:
+    struct DrawEntry
+    {
+        Engine::Entity ent;
+        int depth;
+    };
+
+    // Every entity in draw order, kept between frames
+    // Only sorted again when an animator changed, and then it's almost sorted already.
+    std::vector<DrawEntry> m_drawOrder;
+    bool m_orderDirty = true;
+
+    void sortDrawOrder();
 };
 
 namespace AnimatorCommon
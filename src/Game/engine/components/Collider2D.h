@@ -8,7 +8,8 @@ struct Collider2D
 {
 	Engine::Recti rect;
 
-	// TODO: Need type?
+	// Collision layer, only colliders on layers the scene's CollisionMatrix says interact are tested
+	uint8_t layer = 0;
 };
 
 class DrawCollider2D : public Engine::System
@@ -1,8 +1,20 @@
 #include "Transform2D.h"
 
+#include <engine/Math.h>
+#include <engine/Time.h>
+
 using namespace Engine;
 
 Engine::Vec2i TransformCommon::elevatedHeight(Transform2D &transform)
 {
     return transform.pos - Vec2i(0, transform.z);
-}
\ No newline at end of file
+}
+Engine::Vec2i TransformCommon::drawPos(const Transform2D &transform)
+{
+    return Math::lerp(transform.prevPos, transform.pos, Time::interpolation);
+}
+
+int TransformCommon::drawZ(const Transform2D &transform)
+{
+    return static_cast<int>(std::lround(Math::lerp(static_cast<float>(transform.prevZ), static_cast<float>(transform.z), Time::interpolation)));
+}
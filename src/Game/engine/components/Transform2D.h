@@ -2,6 +2,7 @@
 #define _TRANSFORM_2D_H
 
 #include <engine/Spatial.h>
+#include <engine/ecs/System.h>
 
 struct Transform2D
 {
@@ -16,11 +17,29 @@ struct Transform2D
 
     // Rotation in degrees
     float rotation = 0.0f;
+
+    // pos and z at the end of the last tick, drawing goes from here to pos (see TransformCommon::drawPos)
+    Engine::Vec2i prevPos = Engine::Vec2i(0, 0);
+    int prevZ = 0;
+};
+
+// Keeps Transform2D::prevPos/prevZ, scenes that draw transforms need it for interpolation.
+// Runs first every tick, and only looks at transforms that changed since the last one.
+class UpdateTransformHistory : public Engine::System
+{
+public:
+    void init() override;
+    void update() override;
+    void entityAdded(Engine::Entity const &ent) override;
 };
 
 namespace TransformCommon
 {
     Engine::Vec2i elevatedHeight(Transform2D &transform);
+
+    // Where to draw 'transform' this frame, between the last tick and this one (see Time::interpolation)
+    Engine::Vec2i drawPos(const Transform2D &transform);
+    int drawZ(const Transform2D &transform);
 }
 
 #endif // _TRANSFORM_2D_H
\ No newline at end of file
@@ -15,9 +15,8 @@ void DrawCollider2D::init()
 void DrawCollider2D::update()
 {
 	// Draw a rectangle for every collider
-	for (auto const &ent : m_entities)
+	for (auto [ent, collider] : m_scene->view<const Collider2D>())
 	{
-		auto &collider = m_scene->getComponent<Collider2D>(ent);
 		Graphics::drawRectCam(m_scene, collider.rect, Color::red);
 	}
 }
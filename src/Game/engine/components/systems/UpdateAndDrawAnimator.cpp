@@ -8,21 +8,9 @@
 
 #include <engine/components/Transform2D.h>
 
-using namespace Engine;
+#include <algorithm>
 
-namespace
-{
-    class SortlistEntry
-    {
-    public:
-        Transform2D *m_transform = nullptr;
-        Animator *m_animator = nullptr;
-
-        SortlistEntry(Transform2D *transform, Animator *animator)
-            : m_transform(transform), m_animator(animator)
-        {}
-    };
-}
+using namespace Engine;
 
 void UpdateAndDrawAnimator::init()
 {
@@ -32,35 +20,82 @@ void UpdateAndDrawAnimator::init()
     setup(0, Type::Draw, sig);
 }
 
-void UpdateAndDrawAnimator::update()
+void UpdateAndDrawAnimator::entityAdded(Entity const &ent)
+{
+    m_drawOrder.push_back({ ent, m_scene->readComponent<Animator>(ent).depth });
+    m_orderDirty = true;
+}
+
+void UpdateAndDrawAnimator::entityRemoved(Entity const &ent)
 {
-    // For depth sorting, we just add all animators to a list and then sort them
-    std::vector<SortlistEntry> sortedEntites;
+    // Removing keeps the rest in order
+    auto it = std::find_if(m_drawOrder.begin(), m_drawOrder.end(), [ent](const DrawEntry &entry)
+        { return entry.ent == ent; });
+    if (it != m_drawOrder.end())
+    {
+        m_drawOrder.erase(it);
+    }
+}
 
+void UpdateAndDrawAnimator::restored()
+{
+    m_drawOrder.clear();
     for (Entity ent : m_entities)
     {
-        auto &transform = m_scene->getComponent<Transform2D>(ent);
-        auto &animator = m_scene->getComponent<Animator>(ent);
+        m_drawOrder.push_back({ ent, m_scene->readComponent<Animator>(ent).depth });
+    }
+
+    std::sort(m_drawOrder.begin(), m_drawOrder.end(), [](const DrawEntry &ls, const DrawEntry &rs)
+        { return ls.depth < rs.depth; });
+    m_orderDirty = false;
+}
 
-        sortedEntites.emplace_back(&transform, &animator);
+void UpdateAndDrawAnimator::sortDrawOrder()
+{
+    for (auto &entry : m_drawOrder)
+    {
+        entry.depth = m_scene->readComponent<Animator>(entry.ent).depth;
     }
 
-    // Sort by depth
-    std::sort(sortedEntites.begin(), sortedEntites.end(), 
-        [](const SortlistEntry &ls, const SortlistEntry &rs)
+    // Insertion sort, the order only shifts a little from frame to frame
+    for (size_t i = 1; i < m_drawOrder.size(); i++)
+    {
+        DrawEntry entry = m_drawOrder[i];
+        size_t j = i;
+        while (j > 0 && m_drawOrder[j - 1].depth > entry.depth)
         {
-            return ls.m_animator->depth < rs.m_animator->depth;
-        });
+            m_drawOrder[j] = m_drawOrder[j - 1];
+            j--;
+        }
+        m_drawOrder[j] = entry;
+    }
+}
 
-    for (SortlistEntry &entry : sortedEntites)
+void UpdateAndDrawAnimator::update()
+{
+    // Depth can only have changed if an animator was written to since last frame
+    if (!m_orderDirty)
     {
-        auto *transform = entry.m_transform;
-        auto *animator = entry.m_animator;
+        m_scene->forEachChanged<Animator>(lastRunTick(), [this](Entity ent)
+            { m_orderDirty = m_orderDirty || m_entities.contains(ent); });
+    }
+
+    if (m_orderDirty)
+    {
+        sortDrawOrder();
+        m_orderDirty = false;
+    }
+
+    for (const DrawEntry &entry : m_drawOrder)
+    {
+        const Transform2D *transform = &m_scene->readComponent<Transform2D>(entry.ent);
+        const Animator *animator = &m_scene->readComponent<Animator>(entry.ent);
 
         if (animator->lerpOffset)
         {
-            animator->offset.x = Math::damp(animator->offset.x, 0.0f, animator->lerpOffsetFac, Time::deltaSeconds * 10.0f);
-            animator->offset.y = Math::damp(animator->offset.y, 0.0f, animator->lerpOffsetFac, Time::deltaSeconds * 10.0f);
+            Animator &lerped = m_scene->getComponent<Animator>(entry.ent);
+            lerped.offset.x = Math::damp(lerped.offset.x, 0.0f, lerped.lerpOffsetFac, Time::deltaSeconds * 10.0f);
+            lerped.offset.y = Math::damp(lerped.offset.y, 0.0f, lerped.lerpOffsetFac, Time::deltaSeconds * 10.0f);
         }
 
         if (animator->origin == Sprite::Origin::Custom)
@@ -76,9 +111,9 @@ void UpdateAndDrawAnimator::update()
         
         // Draw the actual sprite
         animator->sprite->DrawExCam(
-            transform->pos + animator->offset - Vec2i(0, transform->z),
+            TransformCommon::drawPos(*transform) + animator->offset - Vec2i(0, TransformCommon::drawZ(*transform)),
             transform->scale,
             animator->animation,
             animator->color);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,42 @@
+#include <engine/components/Transform2D.h>
+
+#include <engine/Ecs.h>
+
+using namespace Engine;
+
+void UpdateTransformHistory::init()
+{
+    Signature sig;
+    sig.set(m_scene->getComponentType<Transform2D>());
+
+    // Before anything else in the tick moves
+    setup(-10, Type::PreUpdate, sig);
+
+    Signature writes;
+    writes.set(m_scene->getComponentType<Transform2D>());
+    setupAccess(Signature(), writes);
+}
+
+void UpdateTransformHistory::update()
+{
+    // A transform nobody wrote to last tick is still where it was, so prevPos already matches.
+    // Only writing the ones that moved means they count as changed for one more tick, and then settle.
+    m_scene->forEachChanged<Transform2D>(lastRunTick(), [this](Entity ent)
+        {
+            const Transform2D &transform = m_scene->readComponent<Transform2D>(ent);
+            if (transform.prevPos != transform.pos || transform.prevZ != transform.z)
+            {
+                Transform2D &history = m_scene->getComponent<Transform2D>(ent);
+                history.prevPos = history.pos;
+                history.prevZ = history.z;
+            }
+        });
+}
+
+void UpdateTransformHistory::entityAdded(Entity const &ent)
+{
+    // Spawned mid-tick, draw it where it spawned instead of sliding in from the origin
+    Transform2D &transform = m_scene->getComponent<Transform2D>(ent);
+    transform.prevPos = transform.pos;
+    transform.prevZ = transform.z;
+}
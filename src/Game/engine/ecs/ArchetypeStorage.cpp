@@ -0,0 +1,247 @@
+#include "ArchetypeStorage.h"
+
+using namespace Engine;
+
+namespace
+{
+    size_t alignUp(size_t value, size_t align)
+    {
+        return (value + align - 1) / align * align;
+    }
+}
+
+ArchetypeStorage::~ArchetypeStorage()
+{
+    clear();
+}
+
+uint32_t ArchetypeStorage::getOrCreateArchetype(const Signature &signature)
+{
+    auto it = mArchetypeLookup.find(signature);
+    if (it != mArchetypeLookup.end())
+    {
+        return it->second;
+    }
+
+    auto arch = std::make_unique<Archetype>();
+    arch->signature = signature;
+    arch->addEdges.fill(NO_ARCHETYPE);
+    arch->removeEdges.fill(NO_ARCHETYPE);
+
+    // Work out how many entities fit in a chunk
+    size_t rowBytes = sizeof(Entity);
+    size_t alignSlack = 0;
+    for (ComponentType type = 0; type < MAX_COMPONENTS; type++)
+    {
+        if (signature.test(type))
+        {
+            LB_ASSERT(mComponentInfos[type].size != 0, "Component not registered before use.");
+
+            arch->types.push_back(type);
+            rowBytes += mComponentInfos[type].size;
+            alignSlack += mComponentInfos[type].align;
+        }
+    }
+    arch->capacity = static_cast<uint32_t>(std::max<size_t>(1, (CHUNK_BYTES - std::min(alignSlack, CHUNK_BYTES)) / rowBytes));
+
+    // Lay the columns out one after another, entity IDs first
+    size_t offset = sizeof(Entity) * arch->capacity;
+    for (ComponentType type : arch->types)
+    {
+        const ComponentInfo &info = mComponentInfos[type];
+        offset = alignUp(offset, info.align);
+        arch->columnOffsets[type] = offset;
+        offset += info.size * arch->capacity;
+    }
+    arch->chunkBytes = offset;
+
+    uint32_t index = static_cast<uint32_t>(mArchetypes.size());
+    mArchetypes.push_back(std::move(arch));
+    mArchetypeLookup.insert({signature, index});
+
+    return index;
+}
+
+uint32_t ArchetypeStorage::getAddTarget(uint32_t archetype, ComponentType type)
+{
+    if (archetype == NO_ARCHETYPE)
+    {
+        Signature signature;
+        signature.set(type);
+        return getOrCreateArchetype(signature);
+    }
+
+    uint32_t &edge = mArchetypes[archetype]->addEdges[type];
+    if (edge == NO_ARCHETYPE)
+    {
+        Signature signature = mArchetypes[archetype]->signature;
+        signature.set(type);
+        edge = getOrCreateArchetype(signature);
+    }
+    return edge;
+}
+
+uint32_t ArchetypeStorage::getRemoveTarget(uint32_t archetype, ComponentType type)
+{
+    uint32_t &edge = mArchetypes[archetype]->removeEdges[type];
+    if (edge == NO_ARCHETYPE)
+    {
+        Signature signature = mArchetypes[archetype]->signature;
+        signature.reset(type);
+
+        if (signature.none())
+        {
+            return NO_ARCHETYPE;
+        }
+
+        edge = getOrCreateArchetype(signature);
+    }
+    return edge;
+}
+
+void *ArchetypeStorage::componentPtr(const Archetype &arch, ComponentType type, uint32_t row) const
+{
+    size_t chunk = row / arch.capacity;
+    size_t index = row % arch.capacity;
+    auto *base = reinterpret_cast<std::byte *>(arch.chunks[chunk].get());
+    return base + arch.columnOffsets[type] + index * mComponentInfos[type].size;
+}
+
+uint32_t ArchetypeStorage::allocateRow(Archetype &arch, Entity entity)
+{
+    uint32_t row = arch.size;
+    size_t chunk = row / arch.capacity;
+
+    // Grab a new chunk if the last one is full
+    if (chunk >= arch.chunks.size())
+    {
+        size_t count = (arch.chunkBytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        arch.chunks.emplace_back(new std::max_align_t[count]);
+    }
+
+    arch.entities(chunk)[row % arch.capacity] = entity;
+    arch.size++;
+
+    return row;
+}
+
+void ArchetypeStorage::removeRow(Archetype &arch, uint32_t row)
+{
+    uint32_t last = arch.size - 1;
+
+    if (row != last)
+    {
+        // Move the last entity into the hole
+        for (ComponentType type : arch.types)
+        {
+            const ComponentInfo &info = mComponentInfos[type];
+            void *lastPtr = componentPtr(arch, type, last);
+            info.moveConstruct(componentPtr(arch, type, row), lastPtr);
+            info.destroy(lastPtr);
+        }
+
+        Entity movedEntity = arch.entities(last / arch.capacity)[last % arch.capacity];
+        arch.entities(row / arch.capacity)[row % arch.capacity] = movedEntity;
+        setRow(mLocations[movedEntity], row, arch.capacity);
+    }
+
+    arch.size--;
+}
+
+void ArchetypeStorage::moveEntity(Entity entity, uint32_t dstArchetype)
+{
+    Location &loc = mLocations[entity];
+    uint32_t srcArchetype = loc.archetype;
+
+    uint32_t dstRow = 0;
+    if (dstArchetype != NO_ARCHETYPE)
+    {
+        dstRow = allocateRow(*mArchetypes[dstArchetype], entity);
+    }
+
+    if (srcArchetype != NO_ARCHETYPE)
+    {
+        Archetype &src = *mArchetypes[srcArchetype];
+        for (ComponentType type : src.types)
+        {
+            const ComponentInfo &info = mComponentInfos[type];
+            void *srcPtr = componentPtr(src, type, loc.row);
+
+            if (dstArchetype != NO_ARCHETYPE && mArchetypes[dstArchetype]->signature.test(type))
+            {
+                info.moveConstruct(componentPtr(*mArchetypes[dstArchetype], type, dstRow), srcPtr);
+            }
+            info.destroy(srcPtr);
+        }
+
+        removeRow(src, loc.row);
+    }
+
+    loc.archetype = dstArchetype;
+    if (dstArchetype != NO_ARCHETYPE)
+    {
+        setRow(loc, dstRow, mArchetypes[dstArchetype]->capacity);
+    }
+    else
+    {
+        loc = Location();
+    }
+}
+
+void ArchetypeStorage::entityDestroyed(const Entity entity)
+{
+    if (entity < mLocations.size() && mLocations[entity].archetype != NO_ARCHETYPE)
+    {
+        moveEntity(entity, NO_ARCHETYPE);
+    }
+}
+
+void ArchetypeStorage::clear()
+{
+    for (auto &arch : mArchetypes)
+    {
+        for (uint32_t row = 0; row < arch->size; row++)
+        {
+            for (ComponentType type : arch->types)
+            {
+                mComponentInfos[type].destroy(componentPtr(*arch, type, row));
+            }
+        }
+    }
+
+    mArchetypes.clear();
+    mArchetypeLookup.clear();
+    mLocations.clear();
+    mComponentInfos.fill(ComponentInfo());
+}
+
+MemoryUsage ArchetypeStorage::memoryUsage(ComponentType type) const
+{
+    MemoryUsage usage;
+    for (auto const &arch : mArchetypes)
+    {
+        if (arch->signature.test(type))
+        {
+            usage.reserved += arch->chunks.size() * arch->capacity * mComponentInfos[type].size;
+            usage.live += arch->size * mComponentInfos[type].size;
+        }
+    }
+    return usage;
+}
+
+MemoryUsage ArchetypeStorage::memoryUsage() const
+{
+    MemoryUsage usage;
+    for (auto const &arch : mArchetypes)
+    {
+        usage.reserved += arch->chunks.size() * arch->chunkBytes;
+        usage.live += arch->size * sizeof(Entity);
+        for (ComponentType type : arch->types)
+        {
+            usage.live += arch->size * mComponentInfos[type].size;
+        }
+    }
+
+    usage.reserved += mLocations.capacity() * sizeof(Location);
+    return usage;
+}
@@ -0,0 +1,283 @@
+#ifndef _ARCHETYPE_STORAGE_H
+#define _ARCHETYPE_STORAGE_H
+
+#include "Types.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <engine/DebugConsole.h>
+
+namespace Engine
+{
+    // Alternative to ComponentManager, enabled per scene with Scene::setStorage.
+    // Entities with the same signature are stored together in an 'archetype', split into
+    // fixed-size chunks. Inside a chunk each component type gets its own contiguous column (SoA),
+    // so iterating every entity with a given set of components walks memory linearly.
+    //
+    // Adding or removing a component moves the entity to a different archetype, and destroying
+    // an entity moves the last entity of its archetype into the hole. Component references
+    // are only valid until the next structural change to the archetype that holds them.
+    class ArchetypeStorage
+    {
+    public:
+        // Target size of one chunk in bytes (a chunk always fits at least one entity)
+        static constexpr size_t CHUNK_BYTES = 16 * 1024;
+
+        // Marks 'no archetype' - entities without any components live here
+        static constexpr uint32_t NO_ARCHETYPE = std::numeric_limits<uint32_t>::max();
+
+        // Type-erased info needed to move components between chunks
+        struct ComponentInfo
+        {
+            size_t size = 0;
+            size_t align = 0;
+            void (*moveConstruct)(void *dst, void *src) = nullptr;
+            void (*destroy)(void *ptr) = nullptr;
+        };
+
+        struct Archetype
+        {
+            Signature signature;
+
+            // Component types stored in this archetype, in ascending order
+            std::vector<ComponentType> types;
+
+            // Byte offset of each component type's column inside a chunk (only valid for 'types')
+            std::array<size_t, MAX_COMPONENTS> columnOffsets{};
+
+            // Archetype reached by adding/removing a component type, cached as they're found
+            std::array<uint32_t, MAX_COMPONENTS> addEdges;
+            std::array<uint32_t, MAX_COMPONENTS> removeEdges;
+
+            // Entities per chunk, and the size of a chunk's buffer
+            uint32_t capacity = 0;
+            size_t chunkBytes = 0;
+
+            // Every chunk but the last one is always full
+            std::vector<std::unique_ptr<std::max_align_t[]>> chunks;
+
+            // Total entities in this archetype
+            uint32_t size = 0;
+
+            // Number of entities in a given chunk
+            uint32_t chunkSize(size_t chunk) const
+            {
+                size_t start = chunk * capacity;
+                return start >= size ? 0 : static_cast<uint32_t>(std::min<size_t>(capacity, size - start));
+            }
+
+            size_t chunkCount() const
+            {
+                return (size + capacity - 1) / capacity;
+            }
+
+            // Entity IDs stored in a chunk (the entity column always sits at offset 0)
+            Entity *entities(size_t chunk) const
+            {
+                return reinterpret_cast<Entity *>(chunks[chunk].get());
+            }
+
+            // Column of a component type inside a chunk
+            template <typename T>
+            T *column(size_t chunk, ComponentType type) const
+            {
+                return reinterpret_cast<T *>(reinterpret_cast<std::byte *>(chunks[chunk].get()) + columnOffsets[type]);
+            }
+        };
+
+    private:
+        // Where an entity's components live
+        // 'chunk' and 'index' are 'row' split up, cached so lookups don't need a division
+        struct Location
+        {
+            uint32_t archetype = NO_ARCHETYPE;
+            uint32_t row = 0;
+            uint32_t chunk = 0;
+            uint32_t index = 0;
+        };
+
+        // Indexed by component type
+        std::array<ComponentInfo, MAX_COMPONENTS> mComponentInfos{};
+
+        std::vector<std::unique_ptr<Archetype>> mArchetypes{};
+        std::unordered_map<Signature, uint32_t> mArchetypeLookup{};
+
+        // Indexed by entity ID, grown to cover the IDs that get components
+        std::vector<Location> mLocations{};
+
+        // Location of an entity, growing mLocations to fit it if needed
+        Location &locationFor(Entity entity)
+        {
+            if (entity >= mLocations.size())
+            {
+                size_t needed = (static_cast<size_t>(entity) / ENTITY_PAGE_SIZE + 1) * ENTITY_PAGE_SIZE;
+                mLocations.resize(std::max(needed, mLocations.size() * 2));
+            }
+            return mLocations[entity];
+        }
+
+        uint32_t getOrCreateArchetype(const Signature &signature);
+        uint32_t getAddTarget(uint32_t archetype, ComponentType type);
+        uint32_t getRemoveTarget(uint32_t archetype, ComponentType type);
+
+        // Pointer to an entity's component inside an archetype
+        void *componentPtr(const Archetype &arch, ComponentType type, uint32_t row) const;
+
+        void *componentPtr(const Location &loc, ComponentType type) const
+        {
+            const Archetype &arch = *mArchetypes[loc.archetype];
+            auto *base = reinterpret_cast<std::byte *>(arch.chunks[loc.chunk].get());
+            return base + arch.columnOffsets[type] + loc.index * mComponentInfos[type].size;
+        }
+
+        void setRow(Location &loc, uint32_t row, uint32_t capacity)
+        {
+            loc.row = row;
+            loc.chunk = row / capacity;
+            loc.index = row % capacity;
+        }
+
+        // Move an entity into another archetype. Components the destination doesn't have are destroyed.
+        // Components the source didn't have are left unconstructed for the caller.
+        void moveEntity(Entity entity, uint32_t dstArchetype);
+
+        // Append an uninitialized row to an archetype, returns the row index
+        uint32_t allocateRow(Archetype &arch, Entity entity);
+        // Fill the (already destroyed) row with the archetype's last row
+        void removeRow(Archetype &arch, uint32_t row);
+
+    public:
+        ArchetypeStorage() = default;
+        ~ArchetypeStorage();
+
+        ArchetypeStorage(const ArchetypeStorage &) = delete;
+        ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+
+        template <typename T>
+        void registerComponent(ComponentType type)
+        {
+            ComponentInfo &info = mComponentInfos[type];
+            LB_ASSERT(info.size == 0, "Registering component type more than once.");
+
+            info.size = sizeof(T);
+            info.align = alignof(T);
+            info.moveConstruct = [](void *dst, void *src)
+            { new (dst) T(std::move(*static_cast<T *>(src))); };
+            info.destroy = [](void *ptr)
+            { static_cast<T *>(ptr)->~T(); };
+        }
+
+        // Construct a component in place, in the entity's new archetype
+        template <typename T, typename... Args>
+        T &emplace(const Entity entity, ComponentType type, Args &&...args)
+        {
+            LB_ASSERT(mComponentInfos[type].size != 0, "Component not registered before use.");
+            LB_ASSERT(!has(entity, type), "Component added to entity more than once");
+
+            moveEntity(entity, getAddTarget(locationFor(entity).archetype, type));
+
+            return *new (componentPtr(mLocations[entity], type)) T(std::forward<Args>(args)...);
+        }
+
+        // Type-erased add, moves out of 'component' (used to apply queued commands)
+        void addFrom(const Entity entity, ComponentType type, void *component)
+        {
+            LB_ASSERT(mComponentInfos[type].size != 0, "Component not registered before use.");
+            LB_ASSERT(!has(entity, type), "Component added to entity more than once");
+
+            moveEntity(entity, getAddTarget(locationFor(entity).archetype, type));
+
+            mComponentInfos[type].moveConstruct(componentPtr(mLocations[entity], type), component);
+        }
+
+        // Add several components at once, moving the entity straight to the archetype that has all of them
+        template <typename... Ts>
+        void addAll(const Entity entity, const std::array<ComponentType, sizeof...(Ts)> &types, Ts &&...components)
+        {
+            Location &loc = locationFor(entity);
+            Signature signature = loc.archetype != NO_ARCHETYPE ? mArchetypes[loc.archetype]->signature : Signature();
+            for (ComponentType type : types)
+            {
+                LB_ASSERT(mComponentInfos[type].size != 0, "Component not registered before use.");
+                LB_ASSERT(!signature.test(type), "Component added to entity more than once");
+                signature.set(type);
+            }
+
+            moveEntity(entity, getOrCreateArchetype(signature));
+
+            size_t i = 0;
+            ((new (componentPtr(mLocations[entity], types[i++])) std::decay_t<Ts>(std::forward<Ts>(components))), ...);
+        }
+
+        void remove(const Entity entity, ComponentType type)
+        {
+            LB_ASSERT(has(entity, type), "Removing non-existent component.");
+            moveEntity(entity, getRemoveTarget(mLocations[entity].archetype, type));
+        }
+
+        template <typename T>
+        T &get(const Entity entity, ComponentType type)
+        {
+            LB_ASSERT(has(entity, type), "Retrieving non-existent component.");
+
+            return *static_cast<T *>(componentPtr(mLocations[entity], type));
+        }
+
+        bool has(const Entity entity, ComponentType type) const
+        {
+            if (entity >= mLocations.size())
+            {
+                return false;
+            }
+
+            const Location &loc = mLocations[entity];
+            return loc.archetype != NO_ARCHETYPE && mArchetypes[loc.archetype]->signature.test(type);
+        }
+
+        void entityDestroyed(const Entity entity);
+
+        // Destroy every component and forget all archetypes and registered component types
+        void clear();
+
+        // Call func(const Archetype &) for every archetype whose signature contains 'signature'
+        template <typename Func>
+        void forEachArchetype(const Signature &signature, Func &&func) const
+        {
+            for (auto const &arch : mArchetypes)
+            {
+                if (arch->size > 0 && (arch->signature & signature) == signature)
+                {
+                    func(*arch);
+                }
+            }
+        }
+
+        // Chunk memory used by one component type's columns, across every archetype
+        MemoryUsage memoryUsage(ComponentType type) const;
+
+        // Chunk memory of every archetype plus the location table
+        MemoryUsage memoryUsage() const;
+
+        size_t archetypeCount() const
+        {
+            return mArchetypes.size();
+        }
+
+        // Archetypes are only ever appended, so indices stay valid until clear()
+        const std::vector<std::unique_ptr<Archetype>> &archetypes() const
+        {
+            return mArchetypes;
+        }
+    };
+}
+
+#endif // _ARCHETYPE_STORAGE_H
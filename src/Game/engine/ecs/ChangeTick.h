@@ -0,0 +1,39 @@
+#ifndef _CHANGE_TICK_H
+#define _CHANGE_TICK_H
+
+#include <cstdint>
+
+namespace Engine
+{
+    using Tick = uint32_t;
+
+    // Clock for component change detection
+    // Every component slot remembers the tick it was last written at (see ComponentArray::get), and every
+    // system the tick it last ran at. SystemManager advances the clock around each system, so a system
+    // sees everything written since its previous run, except what it wrote itself.
+    // Only advanced on the main thread, between systems, so systems running in parallel read a fixed value.
+    namespace ChangeTick
+    {
+        inline Tick gCurrent = 1;
+
+        // Tick that writes made right now are stamped with
+        inline Tick current()
+        {
+            return gCurrent;
+        }
+
+        inline Tick advance()
+        {
+            return ++gCurrent;
+        }
+
+        // Was 'tick' after 'since'? Keeps working when the clock wraps around,
+        // as long as nothing waits more than 2^31 ticks between looks.
+        inline bool isNewer(Tick tick, Tick since)
+        {
+            return static_cast<int32_t>(tick - since) > 0;
+        }
+    }
+}
+
+#endif // _CHANGE_TICK_H
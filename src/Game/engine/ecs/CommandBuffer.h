@@ -0,0 +1,193 @@
+#ifndef _COMMAND_BUFFER_H
+#define _COMMAND_BUFFER_H
+
+#include "Types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Engine
+{
+    // Records structural changes (add/remove component, destroy entity) so they can be
+    // applied later in one batch. Owned by Scene, which records into it with the queue* functions
+    // and applies it in Scene::flushCommands.
+    //
+    // Component data is moved into pages owned by the buffer. Pages are kept between flushes,
+    // so once the buffer has grown to fit a frame's worth of commands, recording doesn't allocate.
+    class CommandBuffer
+    {
+    public:
+        enum class Kind : uint8_t
+        {
+            Add,
+            Remove,
+            Destroy,
+        };
+
+        struct Command
+        {
+            // Commands for an entity that died before the flush are dropped
+            EntityHandle handle;
+            Kind kind = Kind::Destroy;
+            ComponentType type = 0;
+
+            // Component to add (Add only)
+            void *data = nullptr;
+            void (*destroy)(void *ptr) = nullptr;
+
+            // Lets the component be moved into another buffer (see append)
+            uint32_t size = 0;
+            uint32_t align = 0;
+            void (*moveConstruct)(void *dst, void *src) = nullptr;
+        };
+
+    private:
+        // Size of one page of component data
+        static constexpr size_t PAGE_BYTES = 16 * 1024;
+
+        struct Page
+        {
+            std::unique_ptr<std::max_align_t[]> data;
+            size_t size = 0;
+        };
+
+        std::vector<Command> mCommands{};
+
+        std::vector<Page> mPages{};
+        // Page currently being filled, and how much of it is used
+        size_t mPage = 0;
+        size_t mOffset = 0;
+
+        void *allocate(size_t size, size_t align)
+        {
+            while (true)
+            {
+                if (mPage < mPages.size())
+                {
+                    Page &page = mPages[mPage];
+                    size_t start = (mOffset + align - 1) / align * align;
+                    if (start + size <= page.size)
+                    {
+                        mOffset = start + size;
+                        return reinterpret_cast<std::byte *>(page.data.get()) + start;
+                    }
+
+                    // Doesn't fit, try the next page
+                    mPage++;
+                    mOffset = 0;
+                    continue;
+                }
+
+                // Out of pages, make one big enough for this component
+                size_t bytes = std::max(PAGE_BYTES, size + align);
+                size_t count = (bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+
+                Page page;
+                page.data.reset(new std::max_align_t[count]);
+                page.size = count * sizeof(std::max_align_t);
+                mPages.push_back(std::move(page));
+            }
+        }
+
+    public:
+        CommandBuffer() = default;
+        ~CommandBuffer()
+        {
+            clear();
+        }
+
+        CommandBuffer(const CommandBuffer &) = delete;
+        CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+        template <typename T>
+        void add(const EntityHandle &handle, ComponentType type, T &&component)
+        {
+            using Component = std::decay_t<T>;
+
+            Command cmd;
+            cmd.handle = handle;
+            cmd.kind = Kind::Add;
+            cmd.type = type;
+            cmd.data = new (allocate(sizeof(Component), alignof(Component))) Component(std::forward<T>(component));
+            cmd.destroy = [](void *ptr)
+            { static_cast<Component *>(ptr)->~Component(); };
+            cmd.size = static_cast<uint32_t>(sizeof(Component));
+            cmd.align = static_cast<uint32_t>(alignof(Component));
+            cmd.moveConstruct = [](void *dst, void *src)
+            { new (dst) Component(std::move(*static_cast<Component *>(src))); };
+
+            mCommands.push_back(cmd);
+        }
+
+        // Move every command from 'other' onto the end of this buffer, leaving 'other' empty
+        void append(CommandBuffer &other)
+        {
+            for (const Command &src : other.mCommands)
+            {
+                Command cmd = src;
+                if (src.data)
+                {
+                    cmd.data = allocate(src.size, src.align);
+                    src.moveConstruct(cmd.data, src.data);
+                }
+                mCommands.push_back(cmd);
+            }
+            other.clear();
+        }
+
+        void remove(const EntityHandle &handle, ComponentType type)
+        {
+            Command cmd;
+            cmd.handle = handle;
+            cmd.kind = Kind::Remove;
+            cmd.type = type;
+            mCommands.push_back(cmd);
+        }
+
+        void destroy(const EntityHandle &handle)
+        {
+            Command cmd;
+            cmd.handle = handle;
+            cmd.kind = Kind::Destroy;
+            mCommands.push_back(cmd);
+        }
+
+        // Commands stay valid until clear(), even if more are recorded in the meantime
+        // (vector growth only moves the Command structs, never the component data)
+        Command &operator[](size_t index)
+        {
+            return mCommands[index];
+        }
+
+        size_t size() const
+        {
+            return mCommands.size();
+        }
+
+        bool empty() const
+        {
+            return mCommands.empty();
+        }
+
+        // Forget every command, destroying component data that was never applied
+        void clear()
+        {
+            for (Command &cmd : mCommands)
+            {
+                if (cmd.data)
+                {
+                    cmd.destroy(cmd.data);
+                }
+            }
+            mCommands.clear();
+            mPage = 0;
+            mOffset = 0;
+        }
+    };
+}
+
+#endif // _COMMAND_BUFFER_H
@@ -2,8 +2,16 @@
 #define _COMPONENT_ARRAY_H
 
 #include "Types.h"
-#include <array>
-#include <unordered_map>
+#include "ChangeTick.h"
+#include "Snapshot.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <engine/DebugConsole.h>
 
 namespace Engine
@@ -13,82 +21,240 @@ namespace Engine
     public:
         virtual ~IComponentArray() = default;
         virtual void entityDestroyed(Entity entity) = 0;
+
+        // Type-erased insert, moves out of 'component' (used to apply queued commands)
+        virtual void insertFrom(Entity entity, void *component) = 0;
+        virtual void remove(Entity entity) = 0;
+
+        virtual MemoryUsage memoryUsage() const = 0;
+
+        // Copy every component in or out of a scene snapshot
+        // Only possible for copyable components, move-only ones make their scene unsnapshottable.
+        virtual bool canSnapshot() const = 0;
+        virtual void save(SnapshotWriter &out) const = 0;
+        virtual void load(SnapshotReader &in) = 0;
     };
 
+    // Largest power of two count of 'elementSize' that fits in 'bytes' (at least 1)
+    constexpr size_t elementsPerPage(size_t elementSize, size_t bytes)
+    {
+        size_t count = 1;
+        while (count * 2 * elementSize <= bytes)
+        {
+            count *= 2;
+        }
+        return count;
+    }
+
     // We'll have one of these for each type of component
+    // Stored as a sparse set, so every lookup is a plain array index.
+    // Both the components and the sparse table are split into pages that are allocated as they're
+    // needed, so a component only one entity has costs one small page instead of a slot per entity.
+    // Pages are never moved, references to components stay valid when other entities get one.
+    //
+    // Slots only hold a constructed component while they're in use. Components are moved in and out
+    // and destroyed when they're removed, so nothing with heap memory of its own (vectors, std::function)
+    // is ever deep-copied by the array, and a removed component's memory is released straight away.
+    //
+    // Each slot also keeps the ChangeTick it was last written at. Adding a component and every mutable
+    // access (get) count as a write, read() doesn't, so systems can skip whatever hasn't changed.
     template <typename T>
     class ComponentArray : public IComponentArray
     {
     private:
-        // Packed array of components
-        std::array<T, MAX_ENTITIES> mData;
-        
-        // Map from an entity ID to an array index
-        // Given an entity, what index of the packed array contains its component?
-        std::unordered_map<Entity, size_t> mEntityToIndex;
-        
-        // Map from an array index to an entity ID
+        // Marks an entity that has no component in this array
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        // Components per page of mData, roughly 4KB worth
+        static constexpr size_t DATA_PAGE_SIZE = elementsPerPage(sizeof(T), 4 * 1024);
+
+        // Uninitialized storage for one component
+        struct Slot
+        {
+            alignas(T) std::byte bytes[sizeof(T)];
+        };
+
+        // Packed array of components, split into pages of DATA_PAGE_SIZE
+        // Only the first mSize slots hold a constructed component.
+        std::vector<std::unique_ptr<Slot[]>> mData;
+
+        // Packed array of entity IDs, parallel to mData
         // Given an index of the packed array, what entity is it associated with?
-        std::unordered_map<size_t, Entity> mIndexToEntity;
+        std::vector<Entity> mDenseEntities;
+
+        // Tick each component was last written at, parallel to mData
+        std::vector<Tick> mChangeTicks;
+
+        // Sparse table indexed by entity ID, split into pages of ENTITY_PAGE_SIZE (null until used)
+        // Given an entity, what index of the packed array contains its component?
+        std::vector<std::unique_ptr<uint32_t[]>> mSparse;
 
         // Total size of valid entries in array
-        size_t mSize;
-        
+        size_t mSize = 0;
+
+        T &at(size_t index)
+        {
+            return *std::launder(reinterpret_cast<T *>(mData[index / DATA_PAGE_SIZE][index % DATA_PAGE_SIZE].bytes));
+        }
+
+        const T &at(size_t index) const
+        {
+            return *std::launder(reinterpret_cast<const T *>(mData[index / DATA_PAGE_SIZE][index % DATA_PAGE_SIZE].bytes));
+        }
+
+        // Raw memory of a slot, for constructing a component in
+        T *slot(size_t index)
+        {
+            return reinterpret_cast<T *>(mData[index / DATA_PAGE_SIZE][index % DATA_PAGE_SIZE].bytes);
+        }
+
+        // Make sure there are pages for the first 'count' slots
+        void reservePages(size_t count)
+        {
+            while (mData.size() * DATA_PAGE_SIZE < count)
+            {
+                mData.push_back(std::make_unique<Slot[]>(DATA_PAGE_SIZE));
+            }
+        }
+
+        // Destroy every component, the pages are kept
+        void destroyAll()
+        {
+            for (size_t i = 0; i < mSize; i++)
+            {
+                std::destroy_at(&at(i));
+            }
+            mSize = 0;
+        }
+
+        // Sparse entry of an entity that has a page already
+        uint32_t &sparse(const Entity entity)
+        {
+            return mSparse[entity / ENTITY_PAGE_SIZE][entity % ENTITY_PAGE_SIZE];
+        }
+
+        // Put new entry at end and update the lookup tables, returns its (unconstructed) index
+        size_t allocateIndex(const Entity entity)
+        {
+            LB_ASSERT(entity != NULL_ENTITY, "Entity out of range.");
+            LB_ASSERT(!has(entity), "Component added to entity more than once");
+
+            size_t page = entity / ENTITY_PAGE_SIZE;
+            if (page >= mSparse.size())
+            {
+                mSparse.resize(page + 1);
+            }
+            if (!mSparse[page])
+            {
+                mSparse[page].reset(new uint32_t[ENTITY_PAGE_SIZE]);
+                std::fill_n(mSparse[page].get(), ENTITY_PAGE_SIZE, INVALID_INDEX);
+            }
+
+            size_t newIndex = mSize;
+            reservePages(newIndex + 1);
+
+            sparse(entity) = static_cast<uint32_t>(newIndex);
+            mDenseEntities.push_back(entity);
+            mChangeTicks.push_back(ChangeTick::current());
+
+            mSize++;
+            return newIndex;
+        }
+
     public:
+        ComponentArray() = default;
+        ~ComponentArray()
+        {
+            destroyAll();
+        }
+
+        ComponentArray(const ComponentArray &) = delete;
+        ComponentArray &operator=(const ComponentArray &) = delete;
+
+        // Construct a new component in place from 'args'
+        template <typename... Args>
+        T &emplace(const Entity entity, Args &&...args)
+        {
+            return *new (slot(allocateIndex(entity))) T(std::forward<Args>(args)...);
+        }
+
         // Insert a new component into the array
         void insert(const Entity entity, const T &component)
         {
-            LB_ASSERT(mEntityToIndex.find(entity) == mEntityToIndex.end(), "Component added to entity more than once");
-            
-            // Put new entry at end and update the maps
-            size_t newIndex = mSize;
-            
-            mEntityToIndex[entity] = newIndex;
-            mIndexToEntity[newIndex] = entity;
-            
-            mData[newIndex] = component;
+            emplace(entity, component);
+        }
 
-            mSize++;
+        void insert(const Entity entity, T &&component)
+        {
+            emplace(entity, std::move(component));
+        }
+
+        void insertFrom(const Entity entity, void *component) override
+        {
+            emplace(entity, std::move(*static_cast<T *>(component)));
         }
 
         // Remove a component from the array
-        void remove(const Entity entity)
+        void remove(const Entity entity) override
         {
-            LB_ASSERT(mEntityToIndex.find(entity) != mEntityToIndex.end(), "Removing non-existent component.");
+            LB_ASSERT(has(entity), "Removing non-existent component.");
 
-            size_t indexOfRemovedEntity = mEntityToIndex[entity];
-            size_t indexLast = mSize - 1;
-            Entity entityLast = mIndexToEntity[indexLast];
+            uint32_t indexOfRemovedEntity = sparse(entity);
+            uint32_t indexLast = static_cast<uint32_t>(mSize - 1);
+            Entity entityLast = mDenseEntities[indexLast];
 
-            // Copy component data from end into removed index
-            mData[indexOfRemovedEntity] = mData[indexLast];
+            // Move the last component into the removed one's slot, then the last slot is free
+            if (indexOfRemovedEntity != indexLast)
+            {
+                at(indexOfRemovedEntity) = std::move(at(indexLast));
+            }
+            std::destroy_at(&at(indexLast));
 
             // Given entity, return index to opened spot
-            mEntityToIndex[entityLast] = indexOfRemovedEntity;            
+            sparse(entityLast) = indexOfRemovedEntity;
             // Given index, return moved entity
-            mIndexToEntity[indexOfRemovedEntity] = entityLast;
+            mDenseEntities[indexOfRemovedEntity] = entityLast;
+            mDenseEntities.pop_back();
+            mChangeTicks[indexOfRemovedEntity] = mChangeTicks[indexLast];
+            mChangeTicks.pop_back();
 
-            mEntityToIndex.erase(entity);
-            mIndexToEntity.erase(indexLast);
+            sparse(entity) = INVALID_INDEX;
             mSize--;
         }
 
-        // Get component data
+        // Get component data, for writing
         T &get(const Entity entity)
         {
-            LB_ASSERT(mEntityToIndex.find(entity) != mEntityToIndex.end(), "Retrieving non-existent component.");
-            return mData[mEntityToIndex[entity]];
+            LB_ASSERT(has(entity), "Retrieving non-existent component.");
+            uint32_t index = sparse(entity);
+            mChangeTicks[index] = ChangeTick::current();
+            return at(index);
+        }
+
+        // Get component data without marking it changed
+        const T &read(const Entity entity) const
+        {
+            LB_ASSERT(has(entity), "Retrieving non-existent component.");
+            return at(mSparse[entity / ENTITY_PAGE_SIZE][entity % ENTITY_PAGE_SIZE]);
+        }
+
+        // Tick an entity's component was last written at
+        Tick changeTick(const Entity entity) const
+        {
+            LB_ASSERT(has(entity), "Retrieving non-existent component.");
+            return mChangeTicks[mSparse[entity / ENTITY_PAGE_SIZE][entity % ENTITY_PAGE_SIZE]];
         }
 
         // Check if entity has component
-        bool has(const Entity entity)
+        bool has(const Entity entity) const
         {
-            return mEntityToIndex.find(entity) != mEntityToIndex.end(); 
+            size_t page = entity / ENTITY_PAGE_SIZE;
+            return page < mSparse.size() && mSparse[page] && mSparse[page][entity % ENTITY_PAGE_SIZE] != INVALID_INDEX;
         }
 
         void entityDestroyed(Entity entity) override
         {
-            if (mEntityToIndex.find(entity) != mEntityToIndex.end())
+            if (has(entity))
             {
                 // Remove entity's component if it existed
                 remove(entity);
@@ -99,7 +265,113 @@ namespace Engine
         {
             return mSize;
         }
+
+        // Packed entity IDs, in the same order as the components
+        const std::vector<Entity> &entities() const
+        {
+            return mDenseEntities;
+        }
+
+        // Change ticks, in the same order as the components
+        const std::vector<Tick> &changeTicks() const
+        {
+            return mChangeTicks;
+        }
+
+        bool canSnapshot() const override
+        {
+            return std::is_copy_constructible_v<T>;
+        }
+
+        void save(SnapshotWriter &out) const override
+        {
+            LB_ASSERT(canSnapshot(), "Move-only components can't be snapshotted.");
+
+            // Components a page at a time, only the live ones
+            out.write(mSize);
+            if constexpr (std::is_copy_constructible_v<T>)
+            {
+                for (size_t start = 0; start < mSize; start += DATA_PAGE_SIZE)
+                {
+                    out.write(&at(start), std::min(DATA_PAGE_SIZE, mSize - start));
+                }
+            }
+
+            out.writeVector(mDenseEntities);
+
+            out.write(mSparse.size());
+            for (auto const &page : mSparse)
+            {
+                out.write(page != nullptr);
+                if (page)
+                {
+                    out.write(page.get(), ENTITY_PAGE_SIZE);
+                }
+            }
+        }
+
+        void load(SnapshotReader &in) override
+        {
+            LB_ASSERT(canSnapshot(), "Move-only components can't be snapshotted.");
+
+            destroyAll();
+
+            size_t size = 0;
+            in.read(size);
+            reservePages(size);
+            if constexpr (std::is_copy_constructible_v<T>)
+            {
+                for (size_t start = 0; start < size; start += DATA_PAGE_SIZE)
+                {
+                    in.readConstruct(slot(start), std::min(DATA_PAGE_SIZE, size - start));
+                }
+                mSize = size;
+            }
+
+            in.readVector(mDenseEntities);
+
+            // Everything is different from what systems last saw
+            mChangeTicks.assign(mDenseEntities.size(), ChangeTick::current());
+
+            size_t pageCount = 0;
+            in.read(pageCount);
+            mSparse.resize(pageCount);
+            for (auto &page : mSparse)
+            {
+                bool used = false;
+                in.read(used);
+                if (!used)
+                {
+                    page.reset();
+                    continue;
+                }
+
+                if (!page)
+                {
+                    page.reset(new uint32_t[ENTITY_PAGE_SIZE]);
+                }
+                in.read(page.get(), ENTITY_PAGE_SIZE);
+            }
+        }
+
+        MemoryUsage memoryUsage() const override
+        {
+            MemoryUsage usage;
+
+            usage.reserved += mData.size() * DATA_PAGE_SIZE * sizeof(T);
+            usage.reserved += mDenseEntities.capacity() * sizeof(Entity);
+            usage.reserved += mChangeTicks.capacity() * sizeof(Tick);
+            for (auto const &page : mSparse)
+            {
+                usage.reserved += page ? ENTITY_PAGE_SIZE * sizeof(uint32_t) : 0;
+            }
+            usage.reserved += mSparse.capacity() * sizeof(mSparse[0]) + mData.capacity() * sizeof(mData[0]);
+
+            // A live component needs its data, its dense entity ID, its change tick and its sparse entry
+            usage.live = mSize * (sizeof(T) + sizeof(Entity) + sizeof(Tick) + sizeof(uint32_t));
+            return usage;
+        }
     };
 }
 
-#endif // _COMPONENT_ARRAY_H
\ No newline at end of file
+#endif // _COMPONENT_ARRAY_H
@@ -1,22 +1,31 @@
 #ifndef _COMPONENT_MANAGER_H
 #define _COMPONENT_MANAGER_H
 
-#include <unordered_map>
+#include <vector>
 #include <memory>
+#include <string>
+#include <typeinfo>
 #include "Types.h"
+#include "TypeIndex.h"
 #include "ComponentArray.h"
 
 namespace Engine
 {
+    // Dense IDs for component types, shared by every scene
+    using ComponentTypeIndex = TypeIndex<struct ComponentFamily>;
+
     class ComponentManager
     {
     private:
-        // Map from type string to a component type
-        std::unordered_map<const char *, ComponentType> mComponentTypes{};
+        // Marks a component type ID that hasn't been registered in this manager
+        static constexpr ComponentType UNREGISTERED = std::numeric_limits<ComponentType>::max();
+
+        // Indexed by ComponentTypeIndex, gives the component type (signature bit) for this scene
+        std::vector<ComponentType> mComponentTypes{};
 
-        // Map from type string to a component array
+        // Indexed by component type, in the order they were registered
         // TODO: Figure out why we need to have this on heap
-        std::unordered_map<const char *, std::shared_ptr<IComponentArray>> mComponentArrays{};
+        std::vector<std::shared_ptr<IComponentArray>> mComponentArrays{};
 
         // The component type to be assigned to the next registered component - starting at 0
         ComponentType mNextComponentType{};
@@ -24,68 +33,86 @@ namespace Engine
         // Debug array for storing component type names so we can print them in scene
         std::vector<std::string> mDebugComponentNames{};
 
+        template <typename T>
+        void registerComponentSafe()
+        {
+            if (!isRegistered<T>())
+            {
+                registerComponent<T>();
+            }
+        }
+
+    public:
         // Convenience function to get the statically casted pointer to the ComponentArray of type T
         template <typename T>
-        std::shared_ptr<ComponentArray<T>> getComponentArray()
+        ComponentArray<T> *getComponentArray()
         {
-            const char *name = typeid(T).name();
-            LB_ASSERT(mComponentTypes.find(name) != mComponentTypes.end(), "Component not registered before use.");
+            LB_ASSERT(isRegistered<T>(), "Component not registered before use.");
 
-            return std::static_pointer_cast<ComponentArray<T>>(mComponentArrays[name]);
+            ComponentType type = mComponentTypes[ComponentTypeIndex::get<T>()];
+            return static_cast<ComponentArray<T> *>(mComponentArrays[type].get());
         }
 
         template <typename T>
-        void registerComponentSafe()
+        bool isRegistered() const
         {
-            const char *name = typeid(T).name();
-            if (!mComponentTypes.count(name))
-            {
-                registerComponent<T>();
-            }
+            const size_t id = ComponentTypeIndex::get<T>();
+            return id < mComponentTypes.size() && mComponentTypes[id] != UNREGISTERED;
         }
 
-    public:
         // Register a new component type
+        // Scenes using archetype storage only need the type, not a ComponentArray to store it in
         template <typename T>
-        void registerComponent()
+        void registerComponent(bool createArray = true)
         {
-            const char *name = typeid(T).name();
-            LB_ASSERT(mComponentTypes.find(name) == mComponentTypes.end(), "Registering component type more than once.");
+            LB_ASSERT(!isRegistered<T>(), "Registering component type more than once.");
+            LB_ASSERT(mNextComponentType < MAX_COMPONENTS, "Too many component types registered.");
 
-            // Add this component type to the component type map
-            mComponentTypes.insert({name, mNextComponentType});
+            // Add this component type to the component type lookup
+            const size_t id = ComponentTypeIndex::get<T>();
+            if (id >= mComponentTypes.size())
+            {
+                mComponentTypes.resize(id + 1, UNREGISTERED);
+            }
+            mComponentTypes[id] = mNextComponentType;
 
-            // Create a ComponentArray pointer and add it to the component arrays map
-            mComponentArrays.insert({name, std::make_shared<ComponentArray<T>>()});
+            // Create a ComponentArray pointer and add it to the component arrays list
+            mComponentArrays.push_back(createArray ? std::make_shared<ComponentArray<T>>() : nullptr);
 
             // Increment value so that the next component registered will be different
             mNextComponentType++;
 
             // Insert into debug names list
-            mDebugComponentNames.push_back(name);
+            mDebugComponentNames.push_back(typeid(T).name());
         }
 
         template <typename T>
         ComponentType getComponentType()
         {
-            const char *name = typeid(T).name();
-            LB_ASSERT(mComponentTypes.find(name) != mComponentTypes.end(), "Component not registered before use.");
+            LB_ASSERT(isRegistered<T>(), "Component not registered before use.");
 
-            return mComponentTypes[name];
+            return mComponentTypes[ComponentTypeIndex::get<T>()];
         }
 
         // Add a component to an entity
         template <typename T>
         void add(const Entity entity, const T &component)
+        {
+            emplace<T>(entity, component);
+        }
+
+        // Construct a component for an entity in place
+        template <typename T, typename... Args>
+        T &emplace(const Entity entity, Args &&...args)
         {
             // Register component if it doesn't exist yet
             registerComponentSafe<T>();
-            getComponentArray<T>()->insert(entity, component);
+            return getComponentArray<T>()->emplace(entity, std::forward<Args>(args)...);
         }
 
         // Remove component from entity
         template <typename T>
-        void remove(const Entity entity, const T &component)
+        void remove(const Entity entity)
         {
             registerComponentSafe<T>();
             getComponentArray<T>()->remove(entity);
@@ -102,11 +129,22 @@ namespace Engine
         // Remove component from entity
         // Will trigger assert if component type was not previously registered
         template <typename T>
-        void removeUnsafe(const Entity entity, const T &component)
+        void removeUnsafe(const Entity entity)
         {
             getComponentArray<T>()->remove(entity);
         }
 
+        // Type-erased add/remove by component type, used to apply queued commands
+        void addFrom(const Entity entity, ComponentType type, void *component)
+        {
+            mComponentArrays[type]->insertFrom(entity, component);
+        }
+
+        void remove(const Entity entity, ComponentType type)
+        {
+            mComponentArrays[type]->remove(entity);
+        }
+
         // Get a component from an entity
         template <typename T>
         T &get(const Entity entity)
@@ -114,6 +152,13 @@ namespace Engine
             return getComponentArray<T>()->get(entity);
         }
 
+        // Get a component without marking it changed
+        template <typename T>
+        const T &read(const Entity entity)
+        {
+            return getComponentArray<T>()->read(entity);
+        }
+
         // Does this entity have this component?
         template <typename T>
         bool has(const Entity entity)
@@ -124,10 +169,53 @@ namespace Engine
         void entityDestroyed(const Entity entity)
         {
             // Notify each component array that an entity has been destroyed
-            for (auto const &pair : mComponentArrays)
+            for (auto const &componentArray : mComponentArrays)
+            {
+                if (componentArray)
+                {
+                    componentArray->entityDestroyed(entity);
+                }
+            }
+        }
+
+        // Memory held by a component type's array (nothing in scenes using archetype storage)
+        MemoryUsage memoryUsage(ComponentType type) const
+        {
+            return mComponentArrays[type] ? mComponentArrays[type]->memoryUsage() : MemoryUsage();
+        }
+
+        // Every component array, in component type order (sparse storage only)
+        // Every registered component can be copied into a snapshot
+        bool canSnapshot() const
+        {
+            for (auto const &componentArray : mComponentArrays)
+            {
+                if (componentArray && !componentArray->canSnapshot())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void save(SnapshotWriter &out) const
+        {
+            out.write(mComponentArrays.size());
+            for (auto const &componentArray : mComponentArrays)
+            {
+                componentArray->save(out);
+            }
+        }
+
+        void load(SnapshotReader &in)
+        {
+            size_t count = 0;
+            in.read(count);
+            LB_ASSERT(count == mComponentArrays.size(), "Snapshot was taken with different components registered.");
+
+            for (auto const &componentArray : mComponentArrays)
             {
-                auto const &componentArray = pair.second;
-                componentArray->entityDestroyed(entity);
+                componentArray->load(in);
             }
         }
 
@@ -2,8 +2,10 @@
 #define _ENTITY_MANAGER_H
 
 #include "Types.h"
-#include <array>
-#include <queue>
+#include "Snapshot.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
 #include <engine/DebugConsole.h>
 
 namespace Engine
@@ -11,52 +13,126 @@ namespace Engine
     class EntityManager
     {
     private:
-        // Queue of unused entity IDs
-        std::queue<Entity> mAvailableEntries{};
+        // Destroyed IDs are only reused once this many are waiting, so an ID isn't handed straight
+        // back out after it's destroyed and the ID range stays close to the most entities alive at once
+        static constexpr uint32_t MIN_FREE_IDS = 1024;
 
+        // Per-ID tables, grown as new IDs get handed out
         // Array of signatures where the index corresponds to the entity ID
-        std::array<Signature, MAX_ENTITIES> mSignatures{};
+        std::vector<Signature> mSignatures{};
+
+        // Bumped every time an entity ID is destroyed, so old EntityHandles stop matching
+        std::vector<uint32_t> mGenerations{};
+
+        // Which entity IDs are currently in use
+        std::vector<uint8_t> mAlive{};
+
+        // Destroyed IDs waiting to be reused, as a FIFO linked through mNextFree
+        // (only entries of IDs in the list are meaningful)
+        std::vector<Entity> mNextFree{};
+        Entity mFreeHead = NULL_ENTITY;
+        Entity mFreeTail = NULL_ENTITY;
+        uint32_t mFreeCount = 0;
+
+        // IDs from here up have never been handed out
+        Entity mNextUnused = 0;
+
+        // IDs taken by reserveEntity, they become entities in createReserved
+        std::vector<Entity> mReserved{};
+        std::mutex mReserveMutex;
 
         // Total living entities - used to keep limits on how many exist
         uint32_t mLivingEntityCount = 0;
 
+        uint32_t mMaxEntities = DEFAULT_MAX_ENTITIES;
+
     public:
-        EntityManager()
+        Entity createEntity()
         {
-            // Initialize the queue with all possible entity IDs
-            for (Entity entity = 0; entity < MAX_ENTITIES; entity++)
-            {
-                mAvailableEntries.push(entity);
-            }
+            // Reserved entities were asked for first
+            createReserved();
+
+            LB_ASSERT(mLivingEntityCount < mMaxEntities, "Too many entities in existence.");
+
+            Entity id = takeId();
+            makeAlive(id);
+            return id;
         }
 
-        Entity createEntity()
+        // Take the next entity ID without creating the entity, for systems running in parallel
+        // Safe to call from several threads at once, as long as nothing else changes this manager meanwhile.
+        // The entity isn't alive until createReserved, but the handle is already the one it'll have.
+        EntityHandle reserveEntity()
         {
-            LB_ASSERT(mLivingEntityCount < MAX_ENTITIES, "Too many entities in existence.");
+            std::lock_guard<std::mutex> lock(mReserveMutex);
+            LB_ASSERT(mLivingEntityCount + mReserved.size() < mMaxEntities, "Too many entities in existence.");
 
-            // Take an ID from the front of the queue
-            Entity id = mAvailableEntries.front();
-            mAvailableEntries.pop();
-            mLivingEntityCount++;
-            
-            return id;
+            Entity id = takeId();
+            mReserved.push_back(id);
+
+            // An ID past the tables has never been used, so it's on its first generation
+            return { id, id < mGenerations.size() ? mGenerations[id] : 0 };
+        }
+
+        // Create every reserved entity
+        void createReserved()
+        {
+            for (Entity id : mReserved)
+            {
+                makeAlive(id);
+            }
+            mReserved.clear();
         }
         
         void destroyEntity(Entity entity)
         {
-            LB_ASSERT(entity < MAX_ENTITIES, "Entity out of range");
+            LB_ASSERT(isAlive(entity), "Destroying an entity that doesn't exist.");
+            if (!isAlive(entity))
+            {
+                // Would put the ID in the free list twice
+                return;
+            }
             
-            // Invalidate the destroyed entity's signature
+            // Invalidate the destroyed entity's signature and any handles to it
             mSignatures[entity].reset();
+            mGenerations[entity]++;
+            mAlive[entity] = 0;
             
-            // Put the destroyed ID at the back of the queue
-            mAvailableEntries.push(entity);
+            // Put the destroyed ID at the back of the free list
+            mNextFree[entity] = NULL_ENTITY;
+            if (mFreeTail == NULL_ENTITY)
+            {
+                mFreeHead = entity;
+            }
+            else
+            {
+                mNextFree[mFreeTail] = entity;
+            }
+            mFreeTail = entity;
+            mFreeCount++;
+
             mLivingEntityCount--;
         }
 
+        bool isAlive(Entity entity) const
+        {
+            return entity < mAlive.size() && mAlive[entity];
+        }
+
+        bool isAlive(const EntityHandle &handle) const
+        {
+            return isAlive(handle.entity) && mGenerations[handle.entity] == handle.generation;
+        }
+
+        EntityHandle getHandle(Entity entity) const
+        {
+            LB_ASSERT(isAlive(entity), "Getting a handle to an entity that doesn't exist.");
+            return { entity, mGenerations[entity] };
+        }
+
         void setSignature(Entity entity, Signature signature)
         {
-            LB_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+            LB_ASSERT(entity < mSignatures.size(), "Entity out of range.");
 
             // Put this entity's signature into the array
             mSignatures[entity] = signature;
@@ -64,17 +140,127 @@ namespace Engine
 
         Signature getSignature(Entity entity)
         {
-            LB_ASSERT(entity < MAX_ENTITIES, "Entities out of range.");
+            LB_ASSERT(entity < mSignatures.size(), "Entities out of range.");
 
             // Get this entity's signature from the array
             return mSignatures[entity];
         }
 
+        // Forget every entity, the cap stays what it was
+        void clear()
+        {
+            mSignatures.clear();
+            mGenerations.clear();
+            mAlive.clear();
+            mNextFree.clear();
+            mFreeHead = NULL_ENTITY;
+            mFreeTail = NULL_ENTITY;
+            mFreeCount = 0;
+            mNextUnused = 0;
+            mReserved.clear();
+            mLivingEntityCount = 0;
+        }
+
         uint32_t livingEntityCount()
         {
             return mLivingEntityCount;
         }
+
+        // Change how many entities can be alive at once
+        // Can't go below the number alive right now, or above what an Entity ID can address
+        void setMaxEntities(uint32_t maxEntities)
+        {
+            LB_ASSERT(maxEntities >= mLivingEntityCount, "Entity cap is lower than the living entity count.");
+            LB_ASSERT(maxEntities < NULL_ENTITY, "Entity cap is out of range.");
+
+            mMaxEntities = std::clamp<uint32_t>(maxEntities, mLivingEntityCount, NULL_ENTITY - 1);
+        }
+
+        uint32_t maxEntities() const
+        {
+            return mMaxEntities;
+        }
+
+        // IDs handed out so far, every per-ID table only needs to cover this many
+        Entity idRange() const
+        {
+            return mNextUnused;
+        }
+
+        // Everything but the cap, which stays whatever this manager has
+        void save(SnapshotWriter &out) const
+        {
+            out.writeVector(mSignatures);
+            out.writeVector(mGenerations);
+            out.writeVector(mAlive);
+            out.writeVector(mNextFree);
+            out.write(mFreeHead);
+            out.write(mFreeTail);
+            out.write(mFreeCount);
+            out.write(mNextUnused);
+            out.write(mLivingEntityCount);
+        }
+
+        void load(SnapshotReader &in)
+        {
+            in.readVector(mSignatures);
+            in.readVector(mGenerations);
+            in.readVector(mAlive);
+            in.readVector(mNextFree);
+            in.read(mFreeHead);
+            in.read(mFreeTail);
+            in.read(mFreeCount);
+            in.read(mNextUnused);
+            in.read(mLivingEntityCount);
+            mReserved.clear();
+        }
+
+        MemoryUsage memoryUsage() const
+        {
+            MemoryUsage usage;
+            usage.reserved = mSignatures.capacity() * sizeof(Signature) + mGenerations.capacity() * sizeof(uint32_t) +
+                             mNextFree.capacity() * sizeof(Entity) + mAlive.capacity();
+            usage.live = mLivingEntityCount * (sizeof(Signature) + sizeof(uint32_t) + sizeof(Entity) + sizeof(uint8_t));
+            return usage;
+        }
+
+    private:
+        // Pick the ID for the next entity, this doesn't touch the per-ID tables
+        Entity takeId()
+        {
+            if (mFreeCount < MIN_FREE_IDS && mNextUnused < mMaxEntities)
+            {
+                return mNextUnused++;
+            }
+
+            // Take an ID from the front of the free list
+            Entity id = mFreeHead;
+            mFreeHead = mNextFree[id];
+            if (mFreeHead == NULL_ENTITY)
+            {
+                mFreeTail = NULL_ENTITY;
+            }
+            mFreeCount--;
+            return id;
+        }
+
+        void makeAlive(Entity id)
+        {
+            if (id >= mSignatures.size())
+            {
+                // Grow geometrically, but never past the cap
+                size_t newSize = std::min<size_t>(std::max<size_t>(mSignatures.size() * 2, ENTITY_PAGE_SIZE), mMaxEntities);
+                newSize = std::max<size_t>(newSize, id + 1);
+                mSignatures.resize(newSize);
+                mGenerations.resize(newSize, 0);
+                mAlive.resize(newSize, 0);
+                mNextFree.resize(newSize, NULL_ENTITY);
+            }
+
+            mAlive[id] = 1;
+            mLivingEntityCount++;
+        }
     };
 }
 
-#endif // _ENTITY_MANAGER_H
\ No newline at end of file
+#endif // _ENTITY_MANAGER_H
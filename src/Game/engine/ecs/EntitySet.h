@@ -0,0 +1,163 @@
+#ifndef _ENTITY_SET_H
+#define _ENTITY_SET_H
+
+#include "Types.h"
+#include "Snapshot.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Engine
+{
+    // Set of entities stored as a sparse set, used for system membership.
+    // Entities are packed in a contiguous list, so iterating is a linear walk
+    // and insert/erase/contains are O(1) without allocating a node per entity.
+    //
+    // Iteration order is insertion order, except erase moves the last entity into the hole.
+    // Iterators work by index, so inserting while iterating is safe (new entities aren't visited),
+    // but erasing while iterating can skip an entity.
+    class EntitySet
+    {
+    private:
+        // Marks an entity that isn't in the set
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        // Packed list of entities
+        std::vector<Entity> mDense{};
+
+        // Indexed by entity ID, gives the entity's index into mDense
+        // Grows to fit the largest entity inserted so far
+        std::vector<uint32_t> mSparse{};
+
+    public:
+        class Iterator
+        {
+        private:
+            const std::vector<Entity> *mDense = nullptr;
+            size_t mIndex = 0;
+
+        public:
+            Iterator(const std::vector<Entity> *dense, size_t index)
+                : mDense(dense), mIndex(index)
+            {}
+
+            Entity operator*() const
+            {
+                return (*mDense)[mIndex];
+            }
+
+            Iterator &operator++()
+            {
+                mIndex++;
+                return *this;
+            }
+
+            bool operator==(const Iterator &rhs) const
+            {
+                return mIndex == rhs.mIndex;
+            }
+
+            bool operator!=(const Iterator &rhs) const
+            {
+                return mIndex != rhs.mIndex;
+            }
+        };
+
+        // Returns true if the entity wasn't in the set already
+        bool insert(const Entity entity)
+        {
+            if (entity >= mSparse.size())
+            {
+                mSparse.resize(std::max(static_cast<size_t>(entity) + 1, mSparse.size() * 2), INVALID_INDEX);
+            }
+            else if (mSparse[entity] != INVALID_INDEX)
+            {
+                return false;
+            }
+
+            mSparse[entity] = static_cast<uint32_t>(mDense.size());
+            mDense.push_back(entity);
+            return true;
+        }
+
+        // Returns true if the entity was in the set
+        bool erase(const Entity entity)
+        {
+            if (!contains(entity))
+            {
+                return false;
+            }
+
+            // Move the last entity into the hole
+            uint32_t index = mSparse[entity];
+            Entity last = mDense.back();
+
+            mDense[index] = last;
+            mSparse[last] = index;
+
+            mDense.pop_back();
+            mSparse[entity] = INVALID_INDEX;
+            return true;
+        }
+
+        bool contains(const Entity entity) const
+        {
+            return entity < mSparse.size() && mSparse[entity] != INVALID_INDEX;
+        }
+
+        void clear()
+        {
+            for (Entity ent : mDense)
+            {
+                mSparse[ent] = INVALID_INDEX;
+            }
+            mDense.clear();
+        }
+
+        size_t size() const
+        {
+            return mDense.size();
+        }
+
+        bool empty() const
+        {
+            return mDense.empty();
+        }
+
+        // Entity at a position in iteration order
+        Entity operator[](size_t index) const
+        {
+            return mDense[index];
+        }
+
+        const Entity *data() const
+        {
+            return mDense.data();
+        }
+
+        void save(SnapshotWriter &out) const
+        {
+            out.writeVector(mDense);
+            out.writeVector(mSparse);
+        }
+
+        void load(SnapshotReader &in)
+        {
+            in.readVector(mDense);
+            in.readVector(mSparse);
+        }
+
+        Iterator begin() const
+        {
+            return Iterator(&mDense, 0);
+        }
+
+        Iterator end() const
+        {
+            return Iterator(&mDense, mDense.size());
+        }
+    };
+}
+
+#endif // _ENTITY_SET_H
@@ -0,0 +1,47 @@
+#ifndef _PREFAB_H
+#define _PREFAB_H
+
+#include <tuple>
+#include <utility>
+
+namespace Engine
+{
+    // A fixed set of components to stamp onto new entities with Scene::spawn.
+    // Spawning writes the entity's whole signature at once and goes through system membership
+    // a single time, instead of once per addComponent.
+    //
+    // Build one up front (a function-local static works well) and customize each entity's copy
+    // in the initializer passed to spawn:
+    //     using EffectPrefab = Prefab<Transform2D, Animator>;
+    //     static const EffectPrefab prefab = ...;
+    //     scene->spawn(prefab, [&](Entity, EffectPrefab &effect) { effect.get<Transform2D>().pos = pos; });
+    template <typename... Ts>
+    struct Prefab
+    {
+        static_assert(sizeof...(Ts) > 0, "A prefab needs at least one component.");
+
+        std::tuple<Ts...> components{};
+
+        Prefab() = default;
+
+        explicit Prefab(Ts... components)
+            : components(std::move(components)...)
+        {
+        }
+
+        // The prefab's copy of a component
+        template <typename T>
+        T &get()
+        {
+            return std::get<T>(components);
+        }
+
+        template <typename T>
+        const T &get() const
+        {
+            return std::get<T>(components);
+        }
+    };
+}
+
+#endif // _PREFAB_H
@@ -0,0 +1,218 @@
+#include "Scene.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace Engine;
+
+void Scene::flushCommands()
+{
+    // Entities spawned by systems that declare their access, their commands are about to be applied
+    mEntityManager.createReserved();
+
+    // Commands recorded while flushing (e.g. from entityAdded) are picked up by the next round
+    size_t start = 0;
+    while (start < mCommands.size())
+    {
+        size_t end = mCommands.size();
+
+        // Group by entity, keeping each entity's commands in the order they were recorded
+        mCommandOrder.clear();
+        for (size_t i = start; i < end; i++)
+        {
+            mCommandOrder.push_back(static_cast<uint32_t>(i));
+        }
+        auto byEntity = [this](uint32_t ls, uint32_t rs)
+            {
+                Entity lsEnt = mCommands[ls].handle.entity;
+                Entity rsEnt = mCommands[rs].handle.entity;
+                return lsEnt < rsEnt || (lsEnt == rsEnt && ls < rs);
+            };
+
+        // Factories record one entity at a time, so this is usually sorted already
+        if (!std::is_sorted(mCommandOrder.begin(), mCommandOrder.end(), byEntity))
+        {
+            std::sort(mCommandOrder.begin(), mCommandOrder.end(), byEntity);
+        }
+
+        // Apply each entity's commands
+        size_t groupStart = 0;
+        while (groupStart < mCommandOrder.size())
+        {
+            Entity ent = mCommands[mCommandOrder[groupStart]].handle.entity;
+
+            size_t groupEnd = groupStart + 1;
+            while (groupEnd < mCommandOrder.size() && mCommands[mCommandOrder[groupEnd]].handle.entity == ent)
+            {
+                groupEnd++;
+            }
+
+            applyCommands(mCommandOrder.data() + groupStart, groupEnd - groupStart);
+            groupStart = groupEnd;
+        }
+
+        start = end;
+    }
+
+    mCommands.clear();
+}
+
+void Scene::applyCommands(const uint32_t *order, size_t count)
+{
+    const Entity ent = mCommands[order[0]].handle.entity;
+    if (!mEntityManager.isAlive(ent))
+    {
+        return;
+    }
+
+    // Handles are taken when a command is recorded. Commands recorded for an
+    // earlier entity with the same ID are skipped.
+    const EntityHandle handle = mEntityManager.getHandle(ent);
+
+    // Destroying wins over everything else queued for this entity
+    for (size_t i = 0; i < count; i++)
+    {
+        const CommandBuffer::Command &cmd = mCommands[order[i]];
+        if (cmd.handle == handle && cmd.kind == CommandBuffer::Kind::Destroy)
+        {
+            destroyEntity(handle.entity);
+            return;
+        }
+    }
+
+    const Signature before = mEntityManager.getSignature(handle.entity);
+    Signature after = before;
+
+    // Removes are held back until systems have been told, so entityRemoved can still read the component
+    Signature pendingRemoves;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CommandBuffer::Command &cmd = mCommands[order[i]];
+        if (cmd.handle != handle)
+        {
+            continue;
+        }
+
+        if (cmd.kind == CommandBuffer::Kind::Add)
+        {
+            // Replacing a component we're about to remove, remove the old one now
+            if (pendingRemoves.test(cmd.type))
+            {
+                removeFromStorage(handle.entity, cmd.type);
+                pendingRemoves.reset(cmd.type);
+            }
+
+            if (m_storage == Storage::Archetype)
+            {
+                mArchetypeStorage.addFrom(handle.entity, cmd.type, cmd.data);
+            }
+            else
+            {
+                mComponentManager.addFrom(handle.entity, cmd.type, cmd.data);
+            }
+
+            // Data has been moved into storage, the leftover can go
+            cmd.destroy(cmd.data);
+            cmd.data = nullptr;
+
+            after.set(cmd.type);
+        }
+        else if (cmd.kind == CommandBuffer::Kind::Remove)
+        {
+            if (after.test(cmd.type))
+            {
+                after.reset(cmd.type);
+                pendingRemoves.set(cmd.type);
+            }
+        }
+    }
+
+    mEntityManager.setSignature(handle.entity, after);
+    mSystemManager.entitySignatureChanged(handle.entity, before, after);
+
+    for (ComponentType type = 0; type < MAX_COMPONENTS && pendingRemoves.any(); type++)
+    {
+        if (pendingRemoves.test(type))
+        {
+            removeFromStorage(handle.entity, type);
+            pendingRemoves.reset(type);
+        }
+    }
+}
+
+void Scene::save(SnapshotWriter &out) const
+{
+    mEntityManager.save(out);
+    mComponentManager.save(out);
+    mSystemManager.save(out);
+
+    out.write(m_camera);
+    out.write(m_hitStun);
+}
+
+void Scene::snapshot(Snapshot &snapshot)
+{
+    LB_ASSERT(canSnapshot(), "Only scenes using sparse storage and copyable components can be snapshotted.");
+    flushCommands();
+
+    // Measure first, so the buffer is allocated once and components are constructed where they stay
+    SnapshotWriter measure;
+    save(measure);
+
+    snapshot.reset(measure.offset());
+    SnapshotWriter out(snapshot);
+    save(out);
+}
+
+void Scene::restore(const Snapshot &snapshot)
+{
+    LB_ASSERT(canSnapshot(), "Only scenes using sparse storage and copyable components can be snapshotted.");
+    LB_ASSERT(!snapshot.empty(), "Restoring an empty snapshot.");
+
+    // Anything queued since belongs to the state we're throwing away
+    mCommands.clear();
+
+    SnapshotReader in(snapshot);
+    mEntityManager.load(in);
+    mComponentManager.load(in);
+    mSystemManager.load(in);
+
+    in.read(m_camera);
+    in.read(m_hitStun);
+}
+
+std::string Scene::getMemoryReport() const
+{
+    std::string str = "-- Memory (reserved / live bytes) --\n";
+
+    char line[192];
+    MemoryUsage total;
+    auto addLine = [&](const char *name, const MemoryUsage &usage)
+    {
+        snprintf(line, sizeof(line), "    %-40s %10zu / %10zu\n", name, usage.reserved, usage.live);
+        str += line;
+        total.reserved += usage.reserved;
+        total.live += usage.live;
+    };
+
+    auto const &names = mComponentManager.debugGetRegisteredComponentNames();
+    for (size_t type = 0; type < names.size(); type++)
+    {
+        addLine(names[type].c_str(), getComponentMemory(static_cast<ComponentType>(type)));
+    }
+
+    if (m_storage == Storage::Archetype)
+    {
+        // Entity columns, chunk padding and the location table on top of the component columns
+        MemoryUsage components = total;
+        MemoryUsage storage = mArchetypeStorage.memoryUsage();
+        addLine("(archetype overhead)", { storage.reserved - components.reserved, storage.live - components.live });
+    }
+
+    addLine("(entities)", mEntityManager.memoryUsage());
+
+    snprintf(line, sizeof(line), "    %-40s %10zu / %10zu\n", "Total", total.reserved, total.live);
+    str += line;
+    return str;
+}
@@ -2,12 +2,21 @@
 #define _SCENE_H
 
 #include "Types.h"
+#include "ArchetypeStorage.h"
+#include "ChangeTick.h"
+#include "CommandBuffer.h"
 #include "ComponentManager.h"
 #include "EntityManager.h"
+#include "Prefab.h"
+#include "Snapshot.h"
 #include "SystemManager.h"
+#include "View.h"
 
 #include <engine/Math.h>
 #include <engine/Time.h>
+#include <engine/ThreadPool.h>
+#include <engine/FrameArena.h>
+#include <engine/CollisionMatrix.h>
 
 namespace Engine
 {
@@ -20,31 +29,178 @@ namespace Engine
 		// So it can access destroyEntity
 		friend SystemManager;
 		
+	public:
+		// How component data is stored
+		enum class Storage
+		{
+			// One packed array per component type (ComponentManager)
+			Sparse,
+			// Entities with the same signature are stored together in chunks (ArchetypeStorage)
+			Archetype,
+		};
+
 	protected:
 		ComponentManager mComponentManager;
+		ArchetypeStorage mArchetypeStorage;
 		EntityManager mEntityManager;
 		SystemManager mSystemManager;
 
+		Storage m_storage = Storage::Sparse;
+
+		// Structural changes queued by the queue* functions, applied in flushCommands
+		CommandBuffer mCommands;
+		// Scratch list of command indices sorted by entity, kept to avoid reallocating
+		std::vector<uint32_t> mCommandOrder{};
+
+		// Runs independent systems at the same time, owned by Game (null runs everything serially)
+		ThreadPool *mThreadPool = nullptr;
+
+		// Per-frame scratch memory, owned by Game
+		FrameArena *mFrameArena = nullptr;
+
+		// Taken by Game right after init(), restarting the scene restores it
+		Snapshot mRestartSnapshot;
+
+		// Where queued commands go, systems running in parallel each record into their own buffer
+		CommandBuffer &commandTarget()
+		{
+			CommandBuffer *commands = SystemManager::threadCommands();
+			return commands ? *commands : mCommands;
+		}
+
+		// Apply every queued command
+		// Commands are grouped by entity, so each entity's system membership is only recomputed once
+		void flushCommands();
+
+		// Apply one entity's commands ('order' indexes into mCommands)
+		void applyCommands(const uint32_t *order, size_t count);
+
+		void removeFromStorage(const Entity entity, ComponentType type)
+		{
+			if (m_storage == Storage::Archetype)
+			{
+				mArchetypeStorage.remove(entity, type);
+			}
+			else
+			{
+				mComponentManager.remove(entity, type);
+			}
+		}
+
+		// Put a new component in storage and update the entity's signature and system membership
+		template <typename T, typename... Args>
+		void constructComponent(const Entity entity, Args &&...args)
+		{
+			LB_ASSERT(!SystemManager::inDeclaredSystem(), "Systems that declare their access have to use queueAddComponent.");
+
+			registerIfNeeded<T>();
+			const ComponentType type = mComponentManager.getComponentType<T>();
+
+			if (m_storage == Storage::Archetype)
+			{
+				mArchetypeStorage.emplace<T>(entity, type, std::forward<Args>(args)...);
+			}
+			else
+			{
+				mComponentManager.emplace<T>(entity, std::forward<Args>(args)...);
+			}
+
+			auto signature = mEntityManager.getSignature(entity);
+			signature.set(type, true);
+			mEntityManager.setSignature(entity, signature);
+
+			mSystemManager.entitySignatureChanged(entity, signature, type);
+		}
+
+		template <typename T>
+		void registerIfNeeded()
+		{
+			if (!mComponentManager.isRegistered<T>())
+			{
+				registerComponent<T>();
+			}
+		}
+
+		template <typename... Ts>
+		Signature prefabSignature()
+		{
+			Signature signature;
+			(signature.set(mComponentManager.getComponentType<Ts>()), ...);
+			return signature;
+		}
+
+		// Move a spawned entity's components into storage and write its signature, returns the signature
+		template <typename... Ts>
+		Signature addPrefabComponents(const Entity entity, Prefab<Ts...> &instance)
+		{
+			std::apply([&](Ts &...components)
+				{
+					if (m_storage == Storage::Archetype)
+					{
+						mArchetypeStorage.addAll(entity, { mComponentManager.getComponentType<Ts>()... }, std::move(components)...);
+					}
+					else
+					{
+						(mComponentManager.emplace<Ts>(entity, std::move(components)), ...);
+					}
+				}, instance.components);
+
+			const Signature signature = prefabSignature<Ts...>();
+			mEntityManager.setSignature(entity, signature);
+			return signature;
+		}
+
+		// Everything snapshot() copies, in order
+		void save(SnapshotWriter &out) const;
+
 		// Destroy and entity and its components
 		void destroyEntity(const Entity entity)
 		{
 			mEntityManager.destroyEntity(entity);
 			mSystemManager.entityDestroyed(entity);
-			mComponentManager.entityDestroyed(entity);
+
+			if (m_storage == Storage::Archetype)
+			{
+				mArchetypeStorage.entityDestroyed(entity);
+			}
+			else
+			{
+				mComponentManager.entityDestroyed(entity);
+			}
 		}
 
-		// Debug restart the scene
+		// Called by Game at the start of every frame
+		void beginFrame()
+		{
+			mSystemManager.beginFrame();
+		}
+
+		// Rebuild the scene from scratch (init() is run again after), used for scenes that can't be snapshotted
 		virtual void restart()
 		{
+			mCommands.clear();
 			mComponentManager = ComponentManager();
-			mEntityManager = EntityManager();
+			mArchetypeStorage.clear();
+			mEntityManager.clear();
 			mSystemManager = SystemManager();
 
 			m_camera = Camera();
 			m_camera.m_size = m_game->getScreenSize();
+			m_collisionMatrix = CollisionMatrix();
 		}
 
 		float m_hitStun = 0.0f;
+
+		// Run the update/draw phases, overridden by PipelineScene to run a static pipeline instead
+		virtual void updateSystems()
+		{
+			mSystemManager.update();
+		}
+
+		virtual void drawSystems()
+		{
+			mSystemManager.draw();
+		}
 		
 	public:
 		// Pointer to parent game class
@@ -53,71 +209,442 @@ namespace Engine
 		// Camera object
 		Camera m_camera;
 
+		// Which collider layers collide with each other, everything does by default
+		CollisionMatrix m_collisionMatrix;
+
 		// -- Entity --
 		// Create a new entity
 		Entity createEntity()
 		{
+			LB_ASSERT(!SystemManager::inDeclaredSystem(), "Systems that declare their access can't create entities.");
 			return mEntityManager.createEntity();
 		}
 
+		// Get a handle that can be held onto past the entity's lifetime
+		EntityHandle getHandle(const Entity entity) const
+		{
+			return mEntityManager.getHandle(entity);
+		}
+
+		// Is the entity this handle refers to still around?
+		bool isAlive(const EntityHandle &handle) const
+		{
+			return mEntityManager.isAlive(handle);
+		}
+
+		bool isAlive(const Entity entity) const
+		{
+			return mEntityManager.isAlive(entity);
+		}
+
+		// Change how many entities can be alive at once, starts at DEFAULT_MAX_ENTITIES
+		// Storage only grows as entities are created, raising the cap doesn't allocate anything
+		void setMaxEntities(uint32_t maxEntities)
+		{
+			mEntityManager.setMaxEntities(maxEntities);
+		}
+
+		uint32_t getMaxEntities() const
+		{
+			return mEntityManager.maxEntities();
+		}
+
+		uint32_t getLivingEntityCount()
+		{
+			return mEntityManager.livingEntityCount();
+		}
+
 		// -- Component --
+		// Choose how this scene stores its components
+		// Call at the start of init(), before any components are registered
+		void setStorage(Storage storage)
+		{
+			LB_ASSERT(mComponentManager.debugGetRegisteredComponentNames().empty(), "Storage must be set before registering components.");
+			m_storage = storage;
+		}
+
+		Storage getStorage() const
+		{
+			return m_storage;
+		}
+
 		// Register a component type
 		template <typename T>
 		void registerComponent()
 		{
-			mComponentManager.registerComponent<T>();
+			LB_ASSERT(!SystemManager::inDeclaredSystem(), "Systems that declare their access can't register components.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				mComponentManager.registerComponent<T>(false);
+				mArchetypeStorage.registerComponent<T>(mComponentManager.getComponentType<T>());
+			}
+			else
+			{
+				mComponentManager.registerComponent<T>();
+			}
 		}
 
-		// Queue entity for destruction by the end of this update 
+		// -- Queued commands --
+		// These record a structural change instead of applying it straight away. Queued commands are
+		// applied at the end of the current system phase (see setCommandSync), so systems can spawn
+		// and destroy entities while iterating without disturbing anyone's entity lists.
+		// createEntity is safe to call anywhere, an entity is invisible to systems until it has components
+		// (except in systems that declare their access, which may be running alongside others and have
+		// to use queueSpawn instead).
+
+		// Queue entity for destruction
 		void queueDestroy(const Entity entity)
 		{
-			mSystemManager.queueDestroy(entity);
+			commandTarget().destroy(mEntityManager.getHandle(entity));
+		}
+
+		// Queue a component to be added to an entity
+		template <typename T>
+		void queueAddComponent(const Entity entity, T component)
+		{
+			if (!mComponentManager.isRegistered<T>())
+			{
+				registerComponent<T>();
+			}
+			commandTarget().add(mEntityManager.getHandle(entity), mComponentManager.getComponentType<T>(), std::move(component));
+		}
+
+		// Queue a component to be removed from an entity
+		template <typename T>
+		void queueRemoveComponent(const Entity entity)
+		{
+			commandTarget().remove(mEntityManager.getHandle(entity), mComponentManager.getComponentType<T>());
+		}
+
+		// Choose when queued commands are applied
+		void setCommandSync(SystemManager::CommandSync sync)
+		{
+			mSystemManager.setCommandSync(sync);
+		}
+
+		// -- Snapshots --
+		// Copy every entity, component and system's entity list into 'snapshot', reusing its buffer
+		// Queued commands are applied first. Only scenes using sparse storage can be snapshotted.
+		void snapshot(Snapshot &snapshot);
+
+		// Put the scene back the way it was when 'snapshot' was taken
+		// The scene has to have the same components and systems registered as it did then.
+		// Systems' entity lists are replaced without entityAdded/entityRemoved, see System::restored.
+		void restore(const Snapshot &snapshot);
+
+		bool canSnapshot() const
+		{
+			return m_storage == Storage::Sparse && mComponentManager.canSnapshot();
+		}
+
+		// -- Frame memory --
+		// Game hands every scene its frame arena
+		void setFrameArena(FrameArena *arena)
+		{
+			mFrameArena = arena;
+		}
+
+		FrameArena *getFrameArena() const
+		{
+			return mFrameArena;
+		}
+
+		// Memory that lasts until the end of the frame, see FrameArena
+		FrameArena &frameArena()
+		{
+			LB_ASSERT(mFrameArena, "Scene has no frame arena.");
+			return *mFrameArena;
+		}
+
+		// -- Parallel systems --
+		// Systems that declare their access (System::setupAccess) and don't conflict are run at the same time
+		// on this pool. Game hands every scene its pool; set null to run without one.
+		void setThreadPool(ThreadPool *pool)
+		{
+			mThreadPool = pool;
+		}
+
+		ThreadPool *getThreadPool() const
+		{
+			return mThreadPool;
+		}
+
+		// Turn running systems in parallel on or off (serial gives the same results, just slower)
+		void setParallelSystems(bool parallel)
+		{
+			mSystemManager.setParallel(parallel);
+		}
+
+		bool getParallelSystems() const
+		{
+			return mSystemManager.getParallel();
 		}
 
 		// Create a component and add it to an entity
 		template <typename T>
 		void addComponent(const Entity entity, T component)
 		{
-			mComponentManager.add<T>(entity, component);
-
-			auto signature = mEntityManager.getSignature(entity);
-			signature.set(mComponentManager.getComponentType<T>(), true);
-			mEntityManager.setSignature(entity, signature);
+			constructComponent<T>(entity, std::move(component));
+		}
 
-			mSystemManager.entitySignatureChanged(entity, signature);
+		// Construct a component directly in storage from 'args' and add it to an entity
+		// Systems the entity joins may change its components in entityAdded, so the component is
+		// looked up again afterwards. The reference lasts as long as one from getComponent.
+		template <typename T, typename... Args>
+		T &emplaceComponent(const Entity entity, Args &&...args)
+		{
+			constructComponent<T>(entity, std::forward<Args>(args)...);
+			return getComponent<T>(entity);
 		}
 
 		// Remove a component from an entity
 		template <typename T>
 		void removeComponent(const Entity entity)
 		{
-			mComponentManager.remove<T>(entity);
+			LB_ASSERT(!SystemManager::inDeclaredSystem(), "Systems that declare their access have to use queueRemoveComponent.");
 
+			const ComponentType type = mComponentManager.getComponentType<T>();
+
+			// Update systems first so entityRemoved can still read the component
 			auto signature = mEntityManager.getSignature(entity);
-			signature.set(mComponentManager.getComponentType<T>(), false);
+			signature.set(type, false);
 			mEntityManager.setSignature(entity, signature);
 
-			mSystemManager.entitySignatureChanged(entity, signature);
+			mSystemManager.entitySignatureChanged(entity, signature, type);
+
+			if (m_storage == Storage::Archetype)
+			{
+				mArchetypeStorage.remove(entity, type);
+			}
+			else
+			{
+				mComponentManager.remove<T>(entity);
+			}
 		}
 
+		// Get a component for writing, marks it changed (see ChangeTick)
 		template <typename T>
 		T &getComponent(const Entity entity)
 		{
+			LB_ASSERT(!SystemManager::inDeclaredSystem() || SystemManager::canWrite(mComponentManager.getComponentType<T>()),
+				"Writing a component this system didn't declare, use readComponent.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				return mArchetypeStorage.get<T>(entity, mComponentManager.getComponentType<T>());
+			}
 			return mComponentManager.get<T>(entity);
 		}
 
+		// Get a component only to read it, it isn't marked changed
+		template <typename T>
+		const T &readComponent(const Entity entity)
+		{
+			LB_ASSERT(SystemManager::canRead(mComponentManager.getComponentType<T>()),
+				"Reading a component this system didn't declare.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				return mArchetypeStorage.get<T>(entity, mComponentManager.getComponentType<T>());
+			}
+			return mComponentManager.read<T>(entity);
+		}
+
+		// -- Change detection --
+		// Has an entity's T been added or written to after 'since'? Usually since is System::lastRunTick.
+		// Archetype storage doesn't track changes, everything counts as changed there.
+		template <typename T>
+		bool changedSince(const Entity entity, Tick since)
+		{
+			LB_ASSERT(SystemManager::canRead(mComponentManager.getComponentType<T>()),
+				"Reading a component this system didn't declare.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				return true;
+			}
+			return ChangeTick::isNewer(mComponentManager.getComponentArray<T>()->changeTick(entity), since);
+		}
+
+		// Call func(ent) for every entity whose T has been added or written to after 'since'
+		// Only goes through the change ticks, components that didn't change are never touched.
+		template <typename T, typename Func>
+		void forEachChanged(Tick since, Func &&func)
+		{
+			LB_ASSERT(SystemManager::canRead(mComponentManager.getComponentType<T>()),
+				"Reading a component this system didn't declare.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				for (auto [ent, component] : view<const T>())
+				{
+					func(ent);
+				}
+				return;
+			}
+
+			auto *array = mComponentManager.getComponentArray<T>();
+			const std::vector<Tick> &ticks = array->changeTicks();
+			const std::vector<Entity> &entities = array->entities();
+			for (size_t i = 0; i < ticks.size(); i++)
+			{
+				if (ChangeTick::isNewer(ticks[i], since))
+				{
+					func(entities[i]);
+				}
+			}
+		}
+
 		template <typename T>
 		bool hasComponent(const Entity entity)
 		{
+			LB_ASSERT(SystemManager::canRead(mComponentManager.getComponentType<T>()),
+				"Reading a component this system didn't declare.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				return mArchetypeStorage.has(entity, mComponentManager.getComponentType<T>());
+			}
 			return mComponentManager.has<T>(entity);
 		}
 
+		// Iterate component data chunk by chunk (archetype storage only)
+		// Calls func(size_t count, const Entity *entities, Ts *...columns) for every chunk
+		// whose archetype has all of Ts; each column holds 'count' components
+		template <typename... Ts, typename Func>
+		void forEachChunk(Func &&func)
+		{
+			LB_ASSERT(m_storage == Storage::Archetype, "forEachChunk needs archetype storage.");
+
+			Signature signature;
+			(signature.set(mComponentManager.getComponentType<Ts>()), ...);
+
+			mArchetypeStorage.forEachArchetype(signature, [&](const ArchetypeStorage::Archetype &arch)
+				{
+					for (size_t chunk = 0; chunk < arch.chunkCount(); chunk++)
+					{
+						func(static_cast<size_t>(arch.chunkSize(chunk)),
+							static_cast<const Entity *>(arch.entities(chunk)),
+							arch.column<Ts>(chunk, mComponentManager.getComponentType<Ts>())...);
+					}
+				});
+		}
+
+		// Iterate every entity that has all of Ts, works with either storage
+		// e.g. for (auto [ent, transform, mover] : m_scene->view<Transform2D, Mover2D>())
+		// Every component type must be registered
+		// Ask for components only read as const (view<const Transform2D, Mover2D>), so they aren't marked changed
+		template <typename... Ts>
+		View<Ts...> view()
+		{
+			LB_ASSERT(!SystemManager::inDeclaredSystem() ||
+				((std::is_const_v<Ts> || SystemManager::canWrite(mComponentManager.getComponentType<std::remove_const_t<Ts>>())) && ...),
+				"Writing a component this system didn't declare, view it as const.");
+			LB_ASSERT((SystemManager::canRead(mComponentManager.getComponentType<std::remove_const_t<Ts>>()) && ...),
+				"Reading a component this system didn't declare.");
+
+			if (m_storage == Storage::Archetype)
+			{
+				return View<Ts...>(mArchetypeStorage, { mComponentManager.getComponentType<std::remove_const_t<Ts>>()... });
+			}
+			return View<Ts...>(mComponentManager.getComponentArray<std::remove_const_t<Ts>>()...);
+		}
+
+		// Components are registered on first use too, so not every scene has every type
+		template <typename T>
+		bool isRegistered() const
+		{
+			return mComponentManager.isRegistered<T>();
+		}
+
 		template <typename T>
 		ComponentType getComponentType()
 		{
 			return mComponentManager.getComponentType<T>();
 		}
 
+		// -- Prefabs --
+		// Create an entity with every component of a prefab
+		// The signature is written once and systems are only checked once, unlike a run of addComponent calls.
+		template <typename... Ts>
+		Entity spawn(const Prefab<Ts...> &prefab)
+		{
+			return spawn(prefab, [](Entity, Prefab<Ts...> &) {});
+		}
+
+		// Same, but 'initializer(ent, instance)' can change this entity's copy of the prefab first
+		template <typename... Ts, typename Init>
+		Entity spawn(const Prefab<Ts...> &prefab, Init &&initializer)
+		{
+			LB_ASSERT(!SystemManager::inDeclaredSystem(), "Systems that declare their access have to use queueSpawn.");
+			(registerIfNeeded<Ts>(), ...);
+
+			Entity ent = mEntityManager.createEntity();
+			Prefab<Ts...> instance = prefab;
+			initializer(ent, instance);
+
+			mSystemManager.entityCreated(ent, addPrefabComponents(ent, instance));
+			return ent;
+		}
+
+		// Create 'count' entities from a prefab, 'initializer(ent, index, instance)' is called for each one
+		// Which systems the entities belong to is only worked out once for the whole batch.
+		template <typename... Ts, typename Init>
+		void spawn(const Prefab<Ts...> &prefab, size_t count, Init &&initializer)
+		{
+			LB_ASSERT(!SystemManager::inDeclaredSystem(), "Systems that declare their access have to use queueSpawn.");
+			(registerIfNeeded<Ts>(), ...);
+
+			// Not a member, entityAdded may spawn more entities while we're going through this
+			std::pmr::vector<uint32_t> systems(mFrameArena ? static_cast<std::pmr::memory_resource *>(mFrameArena) : std::pmr::get_default_resource());
+			mSystemManager.matchingSystems(prefabSignature<Ts...>(), systems);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				Entity ent = mEntityManager.createEntity();
+				Prefab<Ts...> instance = prefab;
+				initializer(ent, i, instance);
+
+				addPrefabComponents(ent, instance);
+				mSystemManager.entityCreated(ent, systems);
+			}
+		}
+
+		// Create an entity from a prefab and queue its components, for spawning while systems are running
+		// The queued components are applied together, so this is still one membership pass.
+		template <typename... Ts>
+		Entity queueSpawn(const Prefab<Ts...> &prefab)
+		{
+			return queueSpawn(prefab, [](Entity, Prefab<Ts...> &) {});
+		}
+
+		// From a system that declares its access the entity's ID is only reserved, it's created at the next sync
+		// point along with its components (so it isn't alive yet, and the prefab's components have to be registered).
+		template <typename... Ts, typename Init>
+		Entity queueSpawn(const Prefab<Ts...> &prefab, Init &&initializer)
+		{
+			EntityHandle handle;
+			if (SystemManager::inDeclaredSystem())
+			{
+				handle = mEntityManager.reserveEntity();
+			}
+			else
+			{
+				(registerIfNeeded<Ts>(), ...);
+				handle = mEntityManager.getHandle(createEntity());
+			}
+
+			Prefab<Ts...> instance = prefab;
+			initializer(handle.entity, instance);
+
+			CommandBuffer &commands = commandTarget();
+			std::apply([&](Ts &...components)
+				{ (commands.add(handle, mComponentManager.getComponentType<Ts>(), std::move(components)), ...); },
+				instance.components);
+			return handle.entity;
+		}
+
 		// -- System --
 		// Register a system to be used in this scene
 		// also call its init function
@@ -139,12 +666,40 @@ namespace Engine
 			return mSystemManager.getSystem<T>();
 		}
 
+		// For systems that use another one if the scene has it
+		template <typename T>
+		bool hasSystem() const
+		{
+			return mSystemManager.hasSystem<T>();
+		}
+
 		template <typename T>
-		std::set<Entity> *getSystemEntities()
+		EntitySet *getSystemEntities()
 		{
 			return &mSystemManager.getSystem<T>()->m_entities;
 		}
 
+		// How many system membership checks/transitions happened last frame
+		const SystemManager::MembershipStats &getMembershipStats() const
+		{
+			return mSystemManager.getMembershipStats();
+		}
+
+		// How long each system phase took last frame
+		std::string getPhaseReport() const
+		{
+			return mSystemManager.phaseReport();
+		}
+
+		// Memory held by one component type's storage
+		MemoryUsage getComponentMemory(ComponentType type) const
+		{
+			return m_storage == Storage::Archetype ? mArchetypeStorage.memoryUsage(type) : mComponentManager.memoryUsage(type);
+		}
+
+		// Bytes reserved vs. bytes holding live data, per component type and in total
+		std::string getMemoryReport() const;
+
 		Engine::Game *getGame() const
 		{
 			return m_game;
@@ -156,6 +711,11 @@ namespace Engine
 
 			str += std::string(typeid(*this).name()) + " info:\n";
 
+			if (m_storage == Storage::Archetype)
+			{
+				str += "Archetype storage, " + std::to_string(mArchetypeStorage.archetypeCount()) + " archetypes\n";
+			}
+
 			// Print out all registered components
 			str += "-- Components --\n";
 			for (auto const& name : mComponentManager.debugGetRegisteredComponentNames())
@@ -203,12 +763,12 @@ namespace Engine
 				return;
 			}
 			
-			mSystemManager.update();
+			updateSystems();
 		}
 		
 		virtual void draw()
 		{
-			mSystemManager.draw();
+			drawSystems();
 		}
 
 		void setHitstun(float amt)
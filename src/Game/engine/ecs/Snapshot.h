@@ -0,0 +1,250 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <engine/DebugConsole.h>
+
+namespace Engine
+{
+    // Copy of a scene's entities, components and system membership, see Scene::snapshot.
+    // Everything is laid out back to back in one buffer. Trivially copyable data goes in and out
+    // with memcpy, other components are copy-constructed into the buffer and destroyed with it.
+    class Snapshot
+    {
+        friend class SnapshotWriter;
+        friend class SnapshotReader;
+
+    private:
+        // Objects that have to be destroyed before the buffer is reused
+        struct Destructor
+        {
+            size_t offset = 0;
+            size_t count = 0;
+            void (*destroy)(void *ptr, size_t count) = nullptr;
+        };
+
+        std::unique_ptr<std::max_align_t[]> mBuffer{};
+        size_t mCapacity = 0;
+        size_t mSize = 0;
+
+        std::vector<Destructor> mDestructors{};
+
+        std::byte *data() const
+        {
+            return reinterpret_cast<std::byte *>(mBuffer.get());
+        }
+
+    public:
+        Snapshot() = default;
+        ~Snapshot()
+        {
+            clear();
+        }
+
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+
+        // Throw away the contents and make sure 'size' bytes fit
+        void reset(size_t size)
+        {
+            clear();
+
+            if (size > mCapacity)
+            {
+                size_t count = (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+                mBuffer.reset(new std::max_align_t[count]);
+                mCapacity = count * sizeof(std::max_align_t);
+            }
+            mSize = size;
+        }
+
+        // Destroy the contents, the buffer is kept for the next snapshot
+        void clear()
+        {
+            for (auto const &destructor : mDestructors)
+            {
+                destructor.destroy(data() + destructor.offset, destructor.count);
+            }
+            mDestructors.clear();
+            mSize = 0;
+        }
+
+        bool empty() const
+        {
+            return mSize == 0;
+        }
+
+        // Bytes in use
+        size_t size() const
+        {
+            return mSize;
+        }
+
+        size_t capacity() const
+        {
+            return mCapacity;
+        }
+    };
+
+    // Appends data to a Snapshot
+    // Without a snapshot it only counts bytes, Scene::snapshot does one of those passes
+    // first so the buffer is allocated once and nothing has to move after it's constructed.
+    class SnapshotWriter
+    {
+    private:
+        Snapshot *mSnapshot = nullptr;
+        size_t mOffset = 0;
+
+        template <typename T>
+        std::byte *reserve(size_t count)
+        {
+            mOffset = (mOffset + alignof(T) - 1) / alignof(T) * alignof(T);
+            std::byte *ptr = mSnapshot ? mSnapshot->data() + mOffset : nullptr;
+
+            LB_ASSERT(!mSnapshot || mOffset + count * sizeof(T) <= mSnapshot->mSize, "Snapshot changed size between passes.");
+
+            mOffset += count * sizeof(T);
+            return ptr;
+        }
+
+    public:
+        // Measure only
+        SnapshotWriter() = default;
+
+        explicit SnapshotWriter(Snapshot &snapshot)
+            : mSnapshot(&snapshot)
+        {
+        }
+
+        // Bytes written (or that would have been) so far
+        size_t offset() const
+        {
+            return mOffset;
+        }
+
+        template <typename T>
+        void write(const T *data, size_t count)
+        {
+            std::byte *dst = reserve<T>(count);
+            if (!dst || count == 0)
+            {
+                return;
+            }
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(dst, data, count * sizeof(T));
+            }
+            else
+            {
+                std::uninitialized_copy_n(data, count, reinterpret_cast<T *>(dst));
+                size_t offset = static_cast<size_t>(dst - mSnapshot->data());
+                mSnapshot->mDestructors.push_back({ offset, count, [](void *ptr, size_t n)
+                    { std::destroy_n(static_cast<T *>(ptr), n); } });
+            }
+        }
+
+        template <typename T>
+        void write(const T &value)
+        {
+            write(&value, 1);
+        }
+
+        template <typename T>
+        void writeVector(const std::vector<T> &vector)
+        {
+            write(vector.size());
+            write(vector.data(), vector.size());
+        }
+    };
+
+    // Reads data back out of a Snapshot, in the same order it was written
+    class SnapshotReader
+    {
+    private:
+        const Snapshot &mSnapshot;
+        size_t mOffset = 0;
+
+        // Where the next 'count' objects of type T start
+        template <typename T>
+        const T *next(size_t count)
+        {
+            mOffset = (mOffset + alignof(T) - 1) / alignof(T) * alignof(T);
+            LB_ASSERT(mOffset + count * sizeof(T) <= mSnapshot.mSize, "Reading past the end of a snapshot.");
+
+            const std::byte *src = mSnapshot.data() + mOffset;
+            mOffset += count * sizeof(T);
+            return reinterpret_cast<const T *>(src);
+        }
+
+    public:
+        explicit SnapshotReader(const Snapshot &snapshot)
+            : mSnapshot(snapshot)
+        {
+        }
+
+        // Assign to 'count' existing objects
+        template <typename T>
+        void read(T *data, size_t count)
+        {
+            const T *src = next<T>(count);
+            if (count == 0)
+            {
+                return;
+            }
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(data, src, count * sizeof(T));
+            }
+            else
+            {
+                std::copy_n(src, count, data);
+            }
+        }
+
+        // Copy-construct 'count' objects into uninitialized memory
+        template <typename T>
+        void readConstruct(T *data, size_t count)
+        {
+            const T *src = next<T>(count);
+            if (count == 0)
+            {
+                return;
+            }
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(data, src, count * sizeof(T));
+            }
+            else
+            {
+                std::uninitialized_copy_n(src, count, data);
+            }
+        }
+
+        template <typename T>
+        void read(T &value)
+        {
+            read(&value, 1);
+        }
+
+        // Resizes 'vector' to what was written
+        template <typename T>
+        void readVector(std::vector<T> &vector)
+        {
+            size_t size = 0;
+            read(size);
+            vector.resize(size);
+            read(vector.data(), size);
+        }
+    };
+}
+
+#endif // _SNAPSHOT_H
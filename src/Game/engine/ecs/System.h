@@ -2,7 +2,8 @@
 #define _SYSTEM_H
 
 #include "Types.h"
-#include <set>
+#include "ChangeTick.h"
+#include "EntitySet.h"
 #include <engine/Game.h>
 
 namespace Engine
@@ -19,6 +20,14 @@ namespace Engine
 		// Do not try to access any other way.
 		Signature m_setupSignature;
 
+		// Components update() reads and writes, see setupAccess
+		Signature m_reads;
+		Signature m_writes;
+		bool m_declaredAccess = false;
+
+		// ChangeTick this system's last update ran at, 0 before the first one
+		Tick m_lastRunTick = 0;
+
 	protected:
 		// Reference to the parent scene
 		class Scene *m_scene = nullptr;
@@ -48,7 +57,7 @@ namespace Engine
 		int8_t m_priority = 0;
 
 		// List of entities to work with
-		std::set<Entity> m_entities;
+		EntitySet m_entities;
 
 		System() = default;
 		virtual ~System() = default;
@@ -62,6 +71,15 @@ namespace Engine
 		
 		virtual void update() {}
 		virtual void destroyed() {}
+		// Called after Scene::restore replaced m_entities, rebuild anything kept about them
+		virtual void restored() {}
+
+		// Components written after this tick changed since this system's previous update
+		// (see Scene::changedSince and Scene::forEachChanged). On the first update everything has.
+		Tick lastRunTick() const
+		{
+			return m_lastRunTick;
+		}
 
 		std::string toString() const
 		{
@@ -91,6 +109,23 @@ namespace Engine
 			m_type = type;
 			m_setupSignature = sig;
 		}
+
+		// Declare which components update() reads and writes, so it can run at the same time
+		// as other systems in its phase that don't write what it touches (or touch what it writes).
+		// Systems that don't call this run on their own.
+		//
+		// Only declare access if update() touches nothing but these components, Time and input:
+		// no creating entities, adding/removing components directly, rand(), audio, or scene state like the camera.
+		// Structural changes have to go through the scene's queue* functions.
+		// Data a system keeps in its own members (a grid, a tree, an event buffer) isn't component access,
+		// only what it gets through the scene counts.
+		// Call in init after setup.
+		void setupAccess(const Signature &reads, const Signature &writes)
+		{
+			m_reads = reads;
+			m_writes = writes;
+			m_declaredAccess = true;
+		}
 	};
 }
 
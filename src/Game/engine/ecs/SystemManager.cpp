@@ -2,24 +2,223 @@
 
 #include "Scene.h"
 
+#include <engine/ThreadPool.h>
+
+#include <chrono>
+
 using namespace Engine;
 
-void SystemManager::updateSystems(const SystemVector &systemVector)
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    float msSince(Clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    }
+}
+
+void SystemManager::updatePhase(size_t type)
+{
+    // Copied, so registering a system (or restarting the scene) during an update doesn't disturb this one
+    // The copy lives in frame memory when the scene has it, so this doesn't allocate
+    FrameArena *arena = mScene ? mScene->getFrameArena() : nullptr;
+    const SystemVector &updateList = mSystemUpdateList.at(type);
+    PhaseSystemVector systemVector(updateList.begin(), updateList.end(),
+        arena ? static_cast<std::pmr::memory_resource *>(arena) : std::pmr::get_default_resource());
+
+    PhaseStats &stats = mPhaseStats[type];
+    auto start = Clock::now();
+
+    // Commands have to be applied in one go at the end of the phase for systems to overlap
+    ThreadPool *pool = mScene ? mScene->getThreadPool() : nullptr;
+    if (mParallel && pool && mCommandSync == CommandSync::EndOfPhase)
+    {
+        updatePhaseParallel(type, systemVector, *pool, stats);
+    }
+    else
+    {
+        updateSystems(systemVector, stats);
+    }
+
+    stats.wallMs += msSince(start);
+    stats.systems = static_cast<uint32_t>(systemVector.size());
+}
+
+void SystemManager::updateSystems(const PhaseSystemVector &systemVector, PhaseStats &stats)
 {
     for (auto &system : systemVector)
     {
-        destroySet.clear();
+        // Whatever the system writes is stamped with its own tick, so it doesn't see its own changes next time
+        const Tick tick = ChangeTick::advance();
 
+        auto start = Clock::now();
         system->update();
+        stats.systemMs += msSince(start);
 
-        // Remove any entities that have been queued for deletion
-        while (!destroyQueue.empty())
+        system->m_lastRunTick = tick;
+        ChangeTick::advance();
+        stats.batches++;
+
+        if (mCommandSync == CommandSync::EndOfSystem)
         {
-            Entity ent = destroyQueue.front();
-            system->m_scene->destroyEntity(ent);
-            destroyQueue.pop();
+            flushCommands();
         }
         
         // printf("Alive entities: %d\n", system->m_scene->mEntityManager.livingEntityCount());
     }
-}
\ No newline at end of file
+}
+
+void SystemManager::updatePhaseParallel(size_t type, const PhaseSystemVector &systemVector, ThreadPool &pool, PhaseStats &stats)
+{
+    if (!mParallelState)
+    {
+        mParallelState = std::make_shared<ParallelState>();
+    }
+    if (mScheduleDirty)
+    {
+        buildSchedules(*mParallelState);
+    }
+
+    // Held onto in case a system restarts the scene
+    std::shared_ptr<ParallelState> state = mParallelState;
+
+    const Schedule &schedule = state->schedules[type];
+    LB_ASSERT(schedule.order.size() == systemVector.size(), "System schedule out of date.");
+
+    while (state->commands.size() < systemVector.size())
+    {
+        state->commands.push_back(std::make_unique<CommandBuffer>());
+    }
+    state->systemTimes.assign(systemVector.size(), 0.0f);
+
+    for (size_t batch = 0; batch + 1 < schedule.batchStarts.size(); batch++)
+    {
+        const uint32_t *positions = schedule.order.data() + schedule.batchStarts[batch];
+        const size_t count = schedule.batchStarts[batch + 1] - schedule.batchStarts[batch];
+
+        // A batch shares a tick, its systems never write what another one in it touches
+        const Tick tick = ChangeTick::advance();
+
+        // Single system batches run straight away on this thread
+        pool.parallelFor(count, [&](size_t i)
+            {
+                const uint32_t position = positions[i];
+                System &system = *systemVector[position];
+
+                tCommands = state->commands[position].get();
+                tDeclaredAccess = system.m_declaredAccess;
+                tReads = system.m_reads;
+                tWrites = system.m_writes;
+
+                auto start = Clock::now();
+                system.update();
+                state->systemTimes[position] = msSince(start);
+
+                tCommands = nullptr;
+                tDeclaredAccess = false;
+                tReads.reset();
+                tWrites.reset();
+            });
+
+        for (size_t i = 0; i < count; i++)
+        {
+            systemVector[positions[i]]->m_lastRunTick = tick;
+        }
+        ChangeTick::advance();
+    }
+
+    // The scene was restarted, whatever was queued belonged to the old one
+    if (state != mParallelState)
+    {
+        for (auto &commands : state->commands)
+        {
+            commands->clear();
+        }
+        return;
+    }
+
+    // Hand the recorded commands to the scene in update list order, the same order a serial run records them in
+    for (size_t position = 0; position < systemVector.size(); position++)
+    {
+        mScene->mCommands.append(*state->commands[position]);
+        stats.systemMs += state->systemTimes[position];
+    }
+    stats.batches += static_cast<uint32_t>(schedule.batchStarts.size() - 1);
+}
+
+void SystemManager::buildSchedules(ParallelState &state)
+{
+    std::vector<uint32_t> levels;
+
+    for (size_t type = 0; type < mSystemUpdateList.size(); type++)
+    {
+        const SystemVector &systemVector = mSystemUpdateList[type];
+        Schedule &schedule = state.schedules[type];
+
+        // A system goes in the batch after the last earlier system it conflicts with,
+        // so conflicting systems still run in update list order
+        levels.assign(systemVector.size(), 0);
+        uint32_t levelCount = 0;
+        for (size_t i = 0; i < systemVector.size(); i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                if (levels[j] + 1 > levels[i] && conflicts(*systemVector[j], *systemVector[i]))
+                {
+                    levels[i] = levels[j] + 1;
+                }
+            }
+            levelCount = std::max(levelCount, levels[i] + 1);
+        }
+
+        schedule.order.clear();
+        schedule.batchStarts.clear();
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            schedule.batchStarts.push_back(static_cast<uint32_t>(schedule.order.size()));
+            for (size_t i = 0; i < systemVector.size(); i++)
+            {
+                if (levels[i] == level)
+                {
+                    schedule.order.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+        schedule.batchStarts.push_back(static_cast<uint32_t>(schedule.order.size()));
+    }
+
+    mScheduleDirty = false;
+}
+
+std::string SystemManager::phaseReport() const
+{
+    std::string str = "-- Phases (last frame) --\n";
+
+    char line[128];
+    for (size_t type = 0; type < mLastPhaseStats.size(); type++)
+    {
+        const PhaseStats &stats = mLastPhaseStats[type];
+        if (stats.systems == 0)
+        {
+            continue;
+        }
+
+        float speedup = stats.wallMs > 0.0f ? stats.systemMs / stats.wallMs : 1.0f;
+        snprintf(line, sizeof(line), "    %-10s %2u systems in %2u batches, %.3fms (systems %.3fms, %.2fx)\n",
+            System::typeToString(static_cast<System::Type>(type)).c_str(),
+            stats.systems, stats.batches, stats.wallMs, stats.systemMs, speedup);
+        str += line;
+    }
+
+    str += mParallel ? "    Parallel\n" : "    Serial\n";
+    return str;
+}
+
+void SystemManager::flushCommands()
+{
+    if (mScene)
+    {
+        mScene->flushCommands();
+    }
+}
@@ -1,40 +1,247 @@
 #ifndef _SYSTEM_MANAGER_H
 #define _SYSTEM_MANAGER_H
 
-#include <unordered_map>
+#include <array>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
+#include <chrono>
+#include <string>
 
 #include "Types.h"
+#include "TypeIndex.h"
+#include "CommandBuffer.h"
+#include "Snapshot.h"
 #include "System.h"
 #include <engine/DebugConsole.h>
 
 namespace Engine
 {
     class Scene;
+    class ThreadPool;
+
+    template <typename... Phases>
+    class SystemPipeline;
+
+    // Dense IDs for system types, shared by every scene
+    using SystemTypeIndex = TypeIndex<System>;
 
     class SystemManager
     {
+        // Runs its phases through updateStaticPhase
+        template <typename... Phases>
+        friend class SystemPipeline;
+
+    public:
+        // When commands queued on the scene (Scene::queueDestroy etc.) are applied
+        // Commands are always applied before the first phase and at the end of every phase
+        enum class CommandSync
+        {
+            // At the end of every System::Type phase
+            EndOfPhase,
+            // After every system
+            EndOfSystem,
+        };
+
+        // How much work keeping system membership up to date took
+        struct MembershipStats
+        {
+            // Times a system's signature was tested against an entity's
+            uint32_t checks = 0;
+            // Real transitions into/out of a system
+            uint32_t added = 0;
+            uint32_t removed = 0;
+        };
+
+        // How long a System::Type phase took
+        struct PhaseStats
+        {
+            // Wall clock time of the whole phase
+            float wallMs = 0.0f;
+            // Sum of every system's own update time, about what running them one after another costs
+            float systemMs = 0.0f;
+            // Groups of systems that were run together
+            uint32_t batches = 0;
+            uint32_t systems = 0;
+        };
+
     private:
         // SystemVector is sorted based on the system's 'priority' value.
         // If two systems have ths same priority, they will have an unknown update order
         using SystemVector = std::vector<std::shared_ptr<System>>;
 
-        // Map from system type string pointer to a signature
-        std::unordered_map<const char *, Signature> mSignatures{};
+        // Copy of an update list taken for the duration of a phase, in frame memory
+        using PhaseSystemVector = std::pmr::vector<std::shared_ptr<System>>;
+
+        // Marks a system type ID that hasn't been registered in this manager
+        static constexpr int UNREGISTERED = -1;
+
+        // Registered systems, in the order they were registered
+        std::vector<std::shared_ptr<System>> mSystems{};
+
+        // Signature of each system, parallel to mSystems
+        std::vector<Signature> mSignatures{};
 
-        // Map from system type string pointer to a system pointer
-        std::unordered_map<const char *, std::shared_ptr<System>> mSystems{};
+        // Indexed by SystemTypeIndex, gives the system's index into mSystems
+        std::vector<int> mSystemIndices{};
+
+        // Indexed by component type, the systems (indices into mSystems) whose signature contains it
+        // A component changing can only affect membership of these systems
+        std::array<std::vector<uint32_t>, MAX_COMPONENTS> mSystemsByComponent{};
+
+        // Systems with an empty signature match every entity, so they're checked on every change
+        std::vector<uint32_t> mCatchAllSystems{};
+
+        // Stats for the frame in progress, and the last complete frame
+        MembershipStats mStats{};
+        MembershipStats mLastFrameStats{};
 
         // An array mapping System::Type to SystemVector's
         std::array<SystemVector, static_cast<size_t>(System::Type::Count)> mSystemUpdateList;
 
-        // Entities that have been queued for destruction
-        std::queue<Entity> destroyQueue{};
-        std::unordered_set<Entity> destroySet{};
+        // Scene that owns the systems, so queued commands can be flushed
+        Scene *mScene = nullptr;
+
+        CommandSync mCommandSync = CommandSync::EndOfPhase;
+
+        // Stamp per system (parallel to mSystems) so a system is only checked once per signature change
+        std::vector<uint32_t> mVisited{};
+        uint32_t mVisitStamp = 0;
+
+        // -- Parallel updates --
+        // Order systems of a phase are run in when running in parallel. Systems are grouped
+        // into batches, each batch only starts after the previous one has finished.
+        struct Schedule
+        {
+            // Positions in the phase's update list, batch by batch
+            std::vector<uint32_t> order{};
+            // Where each batch starts in 'order', plus one past the end
+            std::vector<uint32_t> batchStarts{};
+        };
+
+        // Everything a parallel phase works with. Shared so a phase that's in progress keeps it
+        // alive if the scene is restarted from inside a system (which replaces this manager).
+        struct ParallelState
+        {
+            std::array<Schedule, static_cast<size_t>(System::Type::Count)> schedules{};
+
+            // One command buffer per position in a phase's update list, so each system records
+            // its commands separately and they can be applied in the same order as a serial run
+            std::vector<std::unique_ptr<CommandBuffer>> commands{};
+
+            // Update time of each system in the current phase (parallel to its update list)
+            std::vector<float> systemTimes{};
+        };
 
-        void updateSystems(const SystemVector &systemVector);
+        std::shared_ptr<ParallelState> mParallelState{};
+        bool mScheduleDirty = true;
+
+        // Run independent systems at the same time (only with CommandSync::EndOfPhase and a thread pool)
+        bool mParallel = true;
+
+        // Timings for the frame in progress, and the last complete frame
+        std::array<PhaseStats, static_cast<size_t>(System::Type::Count)> mPhaseStats{};
+        std::array<PhaseStats, static_cast<size_t>(System::Type::Count)> mLastPhaseStats{};
+
+        // Set on the thread running a system in parallel mode, see threadCommands
+        static inline thread_local CommandBuffer *tCommands = nullptr;
+        static inline thread_local bool tDeclaredAccess = false;
+        static inline thread_local Signature tReads{};
+        static inline thread_local Signature tWrites{};
+
+        void updateSystems(const PhaseSystemVector &systemVector, PhaseStats &stats);
+
+        // Run a single phase, serially or in parallel
+        void updatePhase(size_t type);
+        void updatePhaseParallel(size_t type, const PhaseSystemVector &systemVector, ThreadPool &pool, PhaseStats &stats);
+
+        // Group each phase's systems into batches that don't conflict with each other
+        void buildSchedules(ParallelState &state);
+
+        // Can't run at the same time, one writes a component the other reads or writes
+        // (a system that hasn't declared its access conflicts with everything)
+        static bool conflicts(const System &ls, const System &rs)
+        {
+            if (!ls.m_declaredAccess || !rs.m_declaredAccess)
+            {
+                return true;
+            }
+            return (ls.m_writes & (rs.m_reads | rs.m_writes)).any() || (rs.m_writes & ls.m_reads).any();
+        }
+
+        // Apply the scene's queued commands
+        void flushCommands();
+
+        // -- Static pipelines --
+        // Run one phase of a SystemPipeline: the same ticks, command syncing and stats as a serial updatePhase,
+        // but every update() is called directly on its concrete type instead of through a copied update list
+        template <typename... Ts>
+        void updateStaticPhase(System::Type type, Ts &...systems)
+        {
+            PhaseStats &stats = mPhaseStats[static_cast<size_t>(type)];
+            auto start = std::chrono::high_resolution_clock::now();
+
+            (updateStatic(systems), ...);
+
+            // Not timed per system, that would cost about as much as the dispatch saves
+            float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            stats.wallMs += ms;
+            stats.systemMs += ms;
+            stats.batches += static_cast<uint32_t>(sizeof...(Ts));
+            stats.systems = static_cast<uint32_t>(sizeof...(Ts));
+
+            // Phase boundary
+            flushCommands();
+        }
+
+        template <typename T>
+        void updateStatic(T &system)
+        {
+            const Tick tick = ChangeTick::advance();
+
+            // Qualified, so it isn't a virtual call
+            system.T::update();
+
+            static_cast<System &>(system).m_lastRunTick = tick;
+            ChangeTick::advance();
+
+            if (mCommandSync == CommandSync::EndOfSystem)
+            {
+                flushCommands();
+            }
+        }
+
+        // Add or remove an entity from a single system, calling entityAdded/entityRemoved on a real change
+        void updateMembership(uint32_t index, const Entity entity, const Signature &entitySignature)
+        {
+            auto const &system = mSystems[index];
+            auto const &systemSignature = mSignatures[index];
+            mStats.checks++;
+
+            if ((entitySignature & systemSignature) == systemSignature)
+            {
+                if (system->m_entities.insert(entity))
+                {
+                    mStats.added++;
+                    system->entityAdded(entity);
+                }
+            }
+            else if (system->m_entities.contains(entity))
+            {
+                // Called before erasing, the entity's components are still there
+                mStats.removed++;
+                system->entityRemoved(entity);
+                system->m_entities.erase(entity);
+            }
+        }
+
+        template <typename T>
+        int systemIndex() const
+        {
+            const size_t id = SystemTypeIndex::get<T>();
+            return id < mSystemIndices.size() ? mSystemIndices[id] : UNREGISTERED;
+        }
 
     public:
         template <typename T>
@@ -43,12 +250,22 @@ namespace Engine
             // NOTE: I'm fine with not creating a "safe" version of this function like in ComponentManager
             // because I want to explicitly register all systems in a scene
 
-            const char *name = typeid(T).name();
-            LB_ASSERT(!mSystems.count(name), "Registering system more than once.");
+            LB_ASSERT(systemIndex<T>() == UNREGISTERED, "Registering system more than once.");
 
             // Create a pointer to the system and return it so it can be used externally
             std::shared_ptr<T> system = std::make_shared<T>();
-            mSystems.insert({name, system});
+
+            const size_t id = SystemTypeIndex::get<T>();
+            if (id >= mSystemIndices.size())
+            {
+                mSystemIndices.resize(id + 1, UNREGISTERED);
+            }
+            mSystemIndices[id] = static_cast<int>(mSystems.size());
+            mSystems.push_back(system);
+            mSignatures.emplace_back();
+            mVisited.push_back(0);
+            mScene = scene;
+            mScheduleDirty = true;
 
             // -- Set the system up --
             {
@@ -60,7 +277,7 @@ namespace Engine
                 system->init();
 
                 // Setup signature using private member var that is never ever used again
-                scene->setSystemSignature<T>(system->m_setupSignature);
+                setSignature<T>(system->m_setupSignature);
             }
 
             // Insert into our update list
@@ -79,9 +296,9 @@ namespace Engine
         // Update single system type
         void updateType(System::Type type)
         {
-            size_t nType = static_cast<size_t>(type);
-            SystemVector systemVector = mSystemUpdateList.at(nType);
-            updateSystems(systemVector);
+            flushCommands();
+            updatePhase(static_cast<size_t>(type));
+            flushCommands();
         }
 
         // Update systems within a range of system types
@@ -90,11 +307,16 @@ namespace Engine
             int start = static_cast<size_t>(typeStart);
             int end = static_cast<size_t>(typeEnd);
 
+            // Apply anything queued outside of systems (scene init/update)
+            flushCommands();
+
             // size_t typeCount = static_cast<size_t>(System::Type::Count);
             for (size_t type = start; type < end; type++)
             {
-                SystemVector systemVector = mSystemUpdateList.at(type);
-                updateSystems(systemVector);
+                updatePhase(type);
+
+                // Phase boundary
+                flushCommands();
             }
         }
 
@@ -113,62 +335,233 @@ namespace Engine
         template <typename T>
         void setSignature(const Signature &signature)
         {
-            const char *name = typeid(T).name();
-            LB_ASSERT(mSystems.count(name), "System used before registered.");
+            const int index = systemIndex<T>();
+            LB_ASSERT(index != UNREGISTERED, "System used before registered.");
 
             // Set the signature for this system
-            mSignatures.insert({name, signature});
+            mSignatures[index] = signature;
+
+            // Rebuild the component -> system lookup for this system
+            const uint32_t systemIndex = static_cast<uint32_t>(index);
+            for (auto &systems : mSystemsByComponent)
+            {
+                systems.erase(std::remove(systems.begin(), systems.end(), systemIndex), systems.end());
+            }
+            mCatchAllSystems.erase(std::remove(mCatchAllSystems.begin(), mCatchAllSystems.end(), systemIndex), mCatchAllSystems.end());
+
+            if (signature.none())
+            {
+                mCatchAllSystems.push_back(systemIndex);
+            }
+            for (ComponentType type = 0; type < MAX_COMPONENTS; type++)
+            {
+                if (signature.test(type))
+                {
+                    mSystemsByComponent[type].push_back(systemIndex);
+                }
+            }
         }
 
         void entityDestroyed(const Entity entity)
         {
             // Erase a destroyed entity from all system lists
-            // m_entities is a set, so no check needed
-            for (auto const &pair : mSystems)
+            for (auto const &system : mSystems)
             {
-                auto const &system = pair.second;
-                
-                if (system->m_entities.count(entity))
+                mStats.checks++;
+                if (system->m_entities.contains(entity))
                 {
                     // Call entity removed func
+                    mStats.removed++;
                     system->entityRemoved(entity);
+                    system->m_entities.erase(entity);
                 }
-            
-                system->m_entities.erase(entity);
             }
         }
 
-        void entitySignatureChanged(const Entity entity, const Signature &entitySignature)
+        // An entity's signature changed because component type 'changed' was added or removed
+        // Only systems that care about that component type are checked
+        void entitySignatureChanged(const Entity entity, const Signature &entitySignature, ComponentType changed)
         {
-            // Notify each system that an entity's signature changed
-            for (auto const &pair : mSystems)
+            for (uint32_t index : mSystemsByComponent[changed])
+            {
+                updateMembership(index, entity, entitySignature);
+            }
+            for (uint32_t index : mCatchAllSystems)
             {
-                auto const &type = pair.first;
-                auto const &system = pair.second;
-                auto const &systemSignature = mSignatures[type];
+                updateMembership(index, entity, entitySignature);
+            }
+        }
 
-                // Entity signature matches system signature - insert into set
-                if ((entitySignature & systemSignature) == systemSignature)
+        // An entity's signature changed in any number of bits at once (applying queued commands)
+        // Every system that cares about one of the changed bits is checked exactly once
+        void entitySignatureChanged(const Entity entity, const Signature &before, const Signature &after)
+        {
+            const Signature changed = before ^ after;
+            if (changed.none())
+            {
+                return;
+            }
+
+            mVisitStamp++;
+            for (ComponentType type = 0; type < MAX_COMPONENTS; type++)
+            {
+                if (!changed.test(type))
                 {
-                    system->m_entities.insert(entity);
+                    continue;
+                }
 
-                    // Call entityAdded func
-                    system->entityAdded(entity);
+                for (uint32_t index : mSystemsByComponent[type])
+                {
+                    if (mVisited[index] != mVisitStamp)
+                    {
+                        mVisited[index] = mVisitStamp;
+                        updateMembership(index, entity, after);
+                    }
                 }
-                else
-                {   
-                    // Entity signature does not match system signature - erase from set
-                    system->m_entities.erase(entity);
+            }
+            for (uint32_t index : mCatchAllSystems)
+            {
+                updateMembership(index, entity, after);
+            }
+        }
+
+        // Systems (indices into mSystems) an entity with this signature belongs to
+        template <typename Vector>
+        void matchingSystems(const Signature &entitySignature, Vector &systems)
+        {
+            for (uint32_t index = 0; index < mSystems.size(); index++)
+            {
+                mStats.checks++;
+                if ((entitySignature & mSignatures[index]) == mSignatures[index])
+                {
+                    systems.push_back(index);
+                }
+            }
+        }
+
+        // A brand new entity got its whole signature at once
+        // Nothing has to be removed, so this is only a pass over the systems looking for matches
+        void entityCreated(const Entity entity, const Signature &entitySignature)
+        {
+            for (uint32_t index = 0; index < mSystems.size(); index++)
+            {
+                mStats.checks++;
+                if ((entitySignature & mSignatures[index]) == mSignatures[index] && mSystems[index]->m_entities.insert(entity))
+                {
+                    mStats.added++;
+                    mSystems[index]->entityAdded(entity);
                 }
             }
         }
 
-        void queueDestroy(const Entity entity)
+        // Put a brand new entity into systems found with matchingSystems, without checking signatures again
+        template <typename Vector>
+        void entityCreated(const Entity entity, const Vector &systems)
         {
-            if (destroySet.count(entity) <= 0)
+            for (uint32_t index : systems)
             {
-                destroyQueue.push(entity);
-                destroySet.insert(entity);
+                auto const &system = mSystems[index];
+                if (system->m_entities.insert(entity))
+                {
+                    mStats.added++;
+                    system->entityAdded(entity);
+                }
+            }
+        }
+
+        void setCommandSync(CommandSync sync)
+        {
+            mCommandSync = sync;
+        }
+
+        // Run systems that don't conflict with each other at the same time (on by default)
+        // Turning it off runs every system one after another on the calling thread
+        void setParallel(bool parallel)
+        {
+            mParallel = parallel;
+        }
+
+        bool getParallel() const
+        {
+            return mParallel;
+        }
+
+        // Buffer that queued commands on this thread should be recorded into, or null to use the scene's own
+        static CommandBuffer *threadCommands()
+        {
+            return tCommands;
+        }
+
+        // True on a thread running a system that declared its access (see System::setupAccess),
+        // which isn't allowed to make structural changes directly
+        static bool inDeclaredSystem()
+        {
+            return tDeclaredAccess;
+        }
+
+        // False on a thread running a system that declared its access but not writes to 'type'
+        // Mutable access marks components changed, that's a write too.
+        static bool canWrite(ComponentType type)
+        {
+            return !tDeclaredAccess || tWrites.test(type);
+        }
+
+        // False on a thread running a system that declared its access but neither reads nor writes 'type'
+        // Reading something undeclared gives the scheduler no reason to keep its writer away.
+        static bool canRead(ComponentType type)
+        {
+            return !tDeclaredAccess || tReads.test(type) || tWrites.test(type);
+        }
+
+        // Roll the membership stats and phase timings over to a new frame
+        void beginFrame()
+        {
+            mLastFrameStats = mStats;
+            mStats = MembershipStats();
+
+            mLastPhaseStats = mPhaseStats;
+            mPhaseStats.fill(PhaseStats());
+        }
+
+        // Phase timings of the last complete frame
+        const PhaseStats &getPhaseStats(System::Type type) const
+        {
+            return mLastPhaseStats.at(static_cast<size_t>(type));
+        }
+
+        // Last frame's phase timings and how much running systems in parallel saved
+        std::string phaseReport() const;
+
+        // Membership stats of the last complete frame
+        const MembershipStats &getMembershipStats() const
+        {
+            return mLastFrameStats;
+        }
+
+        // Every system's entity list, in registration order
+        void save(SnapshotWriter &out) const
+        {
+            out.write(mSystems.size());
+            for (auto const &system : mSystems)
+            {
+                system->m_entities.save(out);
+            }
+        }
+
+        // Entity lists are replaced as they are, without entityAdded/entityRemoved (see System::restored)
+        void load(SnapshotReader &in)
+        {
+            size_t count = 0;
+            in.read(count);
+            LB_ASSERT(count == mSystems.size(), "Snapshot was taken with different systems registered.");
+
+            for (auto const &system : mSystems)
+            {
+                system->m_entities.load(in);
+            }
+            for (auto const &system : mSystems)
+            {
+                system->restored();
             }
         }
 
@@ -180,10 +573,16 @@ namespace Engine
         template <class T>
         T *getSystem()
         {
-            const char *name = typeid(T).name();
-            LB_ASSERT(mSystems.count(name), "System was never registered.");
+            const int index = systemIndex<T>();
+            LB_ASSERT(index != UNREGISTERED, "System was never registered.");
             
-            return static_cast<T*>(mSystems.at(name).get());
+            return static_cast<T*>(mSystems[index].get());
+        }
+
+        template <class T>
+        bool hasSystem() const
+        {
+            return systemIndex<T>() != UNREGISTERED;
         }
     };
 }
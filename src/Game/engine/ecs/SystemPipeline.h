@@ -0,0 +1,175 @@
+#ifndef _SYSTEM_PIPELINE_H
+#define _SYSTEM_PIPELINE_H
+
+#include <array>
+#include <climits>
+#include <tuple>
+#include <utility>
+
+#include "System.h"
+#include "SystemManager.h"
+#include "Scene.h"
+
+namespace Engine
+{
+    // The systems of one System::Type phase of a SystemPipeline, in the order they update
+    template <System::Type PhaseType, typename... Systems>
+    struct Phase
+    {
+        static constexpr System::Type type = PhaseType;
+
+        // One pointer per system, filled in by SystemPipeline::init
+        using Pointers = std::tuple<Systems *...>;
+    };
+
+    // A scene's systems as a list fixed at compile time, instead of SystemManager's update lists.
+    // Phases are listed in System::Type order, and the systems in each phase in the order they update:
+    //     using GamePipeline = SystemPipeline<
+    //         Phase<System::Type::PreUpdate, UpdateUID>,
+    //         Phase<System::Type::Update, UpdateMoveAndCollide2D, UpdateSolids>,
+    //         Phase<System::Type::Draw, DrawShadow, UpdateAndDrawAnimator>>;
+    //
+    // The systems are registered with the scene like any other (membership, getSystem and snapshots don't change),
+    // only running them does: there's no update list to copy, update() isn't called virtually, and get<T>()
+    // doesn't look anything up. Everything runs on the calling thread, declared access doesn't make systems parallel.
+    // Use it through PipelineScene.
+    template <typename... Phases>
+    class SystemPipeline
+    {
+    private:
+        using Pointers = decltype(std::tuple_cat(std::declval<typename Phases::Pointers>()...));
+
+        Pointers mSystems{};
+
+        static constexpr bool phasesInOrder()
+        {
+            const std::array<System::Type, sizeof...(Phases)> types = { Phases::type... };
+            for (size_t i = 1; i < types.size(); i++)
+            {
+                if (types[i - 1] >= types[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(phasesInOrder(), "Pipeline phases have to be listed once each, in System::Type order.");
+
+        template <System::Type PhaseType, typename... Systems>
+        void registerPhase(Scene *scene, Phase<PhaseType, Systems...>)
+        {
+            int lastPriority = INT_MIN;
+            (registerSystem<Systems>(scene, PhaseType, lastPriority), ...);
+        }
+
+        template <typename T>
+        void registerSystem(Scene *scene, System::Type type, int &lastPriority)
+        {
+            T *system = scene->registerSystem<T>().get();
+
+            // The list has to agree with what the system's init set up, otherwise the pipeline
+            // would run it in a different order than the update lists do
+            LB_ASSERT(system->m_type == type, "System is listed in a different pipeline phase than its setup() type.");
+            LB_ASSERT(system->m_priority >= lastPriority, "System is listed after one with a higher priority.");
+            lastPriority = system->m_priority;
+
+            std::get<T *>(mSystems) = system;
+        }
+
+        // Run every phase in [First, Last)
+        template <System::Type First, System::Type Last>
+        void run(SystemManager &manager)
+        {
+            // Apply anything queued outside of systems (scene init/update)
+            manager.flushCommands();
+
+            (runPhase<First, Last>(manager, Phases{}), ...);
+        }
+
+        template <System::Type First, System::Type Last, System::Type PhaseType, typename... Systems>
+        void runPhase(SystemManager &manager, Phase<PhaseType, Systems...>)
+        {
+            if constexpr (PhaseType >= First && PhaseType < Last)
+            {
+                manager.updateStaticPhase(PhaseType, *std::get<Systems *>(mSystems)...);
+            }
+        }
+
+    public:
+        // Register every system with the scene, in pipeline order
+        void init(Scene *scene)
+        {
+            (registerPhase(scene, Phases{}), ...);
+        }
+
+        // Register every system with a scene that runs them through its update lists instead
+        static void registerSystems(Scene *scene)
+        {
+            SystemPipeline pipeline;
+            pipeline.init(scene);
+        }
+
+        // Update phases, see SystemManager::update
+        void update(SystemManager &manager)
+        {
+            run<static_cast<System::Type>(0), System::Type::PreDraw>(manager);
+        }
+
+        // Draw phases, see SystemManager::draw
+        void draw(SystemManager &manager)
+        {
+            run<System::Type::PreDraw, System::Type::Count>(manager);
+        }
+
+        // A system in the pipeline, found at compile time
+        template <typename T>
+        T &get()
+        {
+            T *system = std::get<T *>(mSystems);
+            LB_ASSERT(system, "Pipeline used before init.");
+            return *system;
+        }
+    };
+
+    // Scene that runs its systems through a SystemPipeline
+    // Call registerPipeline() in init after registering components. Systems registered
+    // any other way are still members of the scene, but never updated.
+    template <typename Pipeline>
+    class PipelineScene : public Scene
+    {
+    protected:
+        Pipeline mPipeline;
+
+        void registerPipeline()
+        {
+            mPipeline.init(this);
+        }
+
+        void updateSystems() override
+        {
+            mPipeline.update(mSystemManager);
+        }
+
+        void drawSystems() override
+        {
+            mPipeline.draw(mSystemManager);
+        }
+
+        void restart() override
+        {
+            Scene::restart();
+            mPipeline = Pipeline();
+        }
+
+    public:
+        // Direct reference to a system in the pipeline, instead of getSystem's lookup
+        template <typename T>
+        T &pipelineSystem()
+        {
+            return mPipeline.template get<T>();
+        }
+    };
+}
+
+#endif // _SYSTEM_PIPELINE_H
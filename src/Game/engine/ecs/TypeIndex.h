@@ -0,0 +1,37 @@
+#ifndef _TYPE_INDEX_H
+#define _TYPE_INDEX_H
+
+#include <cstddef>
+#include <limits>
+
+namespace Engine
+{
+    // Hands out a dense integer ID to every type that asks for one, starting at 0.
+    // Each 'Family' has its own counter, so components and systems get separate ranges.
+    // The ID lives in a function-local static, so it's the same in every translation unit
+    // and only costs a load after the first call (unlike hashing typeid(T).name()).
+    template <typename Family>
+    class TypeIndex
+    {
+    private:
+        static inline size_t sNextId = 0;
+
+    public:
+        static constexpr size_t INVALID = std::numeric_limits<size_t>::max();
+
+        template <typename T>
+        static size_t get()
+        {
+            static const size_t id = sNextId++;
+            return id;
+        }
+
+        // Number of IDs handed out so far
+        static size_t count()
+        {
+            return sNextId;
+        }
+    };
+}
+
+#endif // _TYPE_INDEX_H
@@ -2,16 +2,53 @@
 #define _TYPES_H
 
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
 
 namespace Engine
 {
     using Entity = uint32_t;
     using ComponentType = uint8_t;
-    constexpr Entity MAX_ENTITIES = 4096;
     constexpr ComponentType MAX_COMPONENTS = 32;
 
+    // Default cap on living entities, change it per scene with Scene::setMaxEntities
+    // Storage grows on demand, so a high cap costs nothing until entities actually exist
+    constexpr Entity DEFAULT_MAX_ENTITIES = 1 << 20;
+
+    // Tables indexed by entity ID are split into pages of this many entries,
+    // only pages covering IDs that are actually used get allocated
+    constexpr Entity ENTITY_PAGE_SIZE = 1024;
+
     using Signature = std::bitset<MAX_COMPONENTS>;
+
+    // Marks 'no entity'
+    constexpr Entity NULL_ENTITY = UINT32_MAX;
+
+    // Bytes a piece of storage holds on to, and how many of them back live data
+    struct MemoryUsage
+    {
+        size_t reserved = 0;
+        size_t live = 0;
+    };
+
+    // Reference to an entity that can safely outlive it
+    // Entity IDs get reused after they're destroyed, the generation tells the old and new apart.
+    // Get one with Scene::getHandle and check it with Scene::isAlive before use.
+    struct EntityHandle
+    {
+        Entity entity = NULL_ENTITY;
+        uint32_t generation = 0;
+
+        bool operator==(const EntityHandle &rhs) const
+        {
+            return entity == rhs.entity && generation == rhs.generation;
+        }
+
+        bool operator!=(const EntityHandle &rhs) const
+        {
+            return !(*this == rhs);
+        }
+    };
 }
 
 #endif // _TYPES_H
\ No newline at end of file
@@ -0,0 +1,222 @@
+#ifndef _VIEW_H
+#define _VIEW_H
+
+#include "Types.h"
+#include "ComponentArray.h"
+#include "ArchetypeStorage.h"
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Engine
+{
+    // Iterates every entity that has all of Ts, yielding std::tuple<Entity, Ts &...>:
+    //
+    //     for (auto [ent, transform, mover] : m_scene->view<Transform2D, Mover2D>())
+    //
+    // Created through Scene::view. Component storage is resolved once when the view is made,
+    // so the loop body never looks a component type up again.
+    // Components asked for as const (view<const Transform2D>) are only read, so they aren't marked changed.
+    // - Sparse storage: walks the smallest of the component arrays and skips entities missing any of the others.
+    // - Archetype storage: walks the chunks of every archetype containing Ts.
+    //
+    // Entities that gain these components while iterating aren't visited until the next view.
+    // Don't destroy entities or remove components from inside the loop, use Scene::queueDestroy.
+    template <typename... Ts>
+    class View
+    {
+    public:
+        using Value = std::tuple<Entity, Ts &...>;
+
+    private:
+        static constexpr size_t N = sizeof...(Ts);
+
+        // -- Sparse storage --
+        std::tuple<ComponentArray<std::remove_const_t<Ts>> *...> mArrays{};
+        // Dense entity list of the smallest array, and how much of it existed when the view was made
+        const std::vector<Entity> *mDriver = nullptr;
+        size_t mDriverSize = 0;
+
+        // -- Archetype storage --
+        const ArchetypeStorage *mStorage = nullptr;
+        std::array<ComponentType, N> mTypes{};
+        Signature mSignature;
+        // Archetype count when the view was made
+        size_t mArchetypeCount = 0;
+
+        // Entity at a position of the driver list, NULL_ENTITY if the list has shrunk past it since
+        Entity driverEntity(size_t index) const
+        {
+            return index < mDriver->size() ? (*mDriver)[index] : NULL_ENTITY;
+        }
+
+        bool matches(Entity ent) const
+        {
+            return std::apply([ent](auto *...arrays)
+                { return (arrays->has(ent) && ...); }, mArrays);
+        }
+
+        bool matches(size_t archetype) const
+        {
+            const auto &arch = *mStorage->archetypes()[archetype];
+            return arch.size > 0 && (arch.signature & mSignature) == mSignature;
+        }
+
+        // Mutable access marks the component changed, const access doesn't
+        template <typename T>
+        static T &fetch(ComponentArray<std::remove_const_t<T>> *array, Entity ent)
+        {
+            if constexpr (std::is_const_v<T>)
+            {
+                return array->read(ent);
+            }
+            else
+            {
+                return array->get(ent);
+            }
+        }
+
+        template <size_t... I>
+        Value makeValue(const ArchetypeStorage::Archetype &arch, size_t chunk, size_t index, std::index_sequence<I...>) const
+        {
+            return Value(arch.entities(chunk)[index], arch.template column<Ts>(chunk, mTypes[I])[index]...);
+        }
+
+    public:
+        class Iterator
+        {
+        private:
+            const View *mView = nullptr;
+
+            // Sparse: mA is the index into the driver array
+            // Archetype: mA is the archetype, mB the chunk, mC the index inside the chunk
+            size_t mA = 0;
+            size_t mB = 0;
+            size_t mC = 0;
+
+            // Move forward until we're on a matching entity (or at the end)
+            void settle()
+            {
+                if (mView->mStorage)
+                {
+                    const auto &archetypes = mView->mStorage->archetypes();
+                    while (mA < mView->mArchetypeCount)
+                    {
+                        if (mView->matches(mA))
+                        {
+                            const auto &arch = *archetypes[mA];
+                            if (mC >= arch.chunkSize(mB))
+                            {
+                                mB++;
+                                mC = 0;
+                            }
+                            if (mB < arch.chunkCount())
+                            {
+                                return;
+                            }
+                        }
+                        mA++;
+                        mB = 0;
+                        mC = 0;
+                    }
+                }
+                else
+                {
+                    while (mA < mView->mDriverSize && !mView->matches(mView->driverEntity(mA)))
+                    {
+                        mA++;
+                    }
+                }
+            }
+
+        public:
+            Iterator(const View *view, size_t start)
+                : mView(view), mA(start)
+            {
+                settle();
+            }
+
+            Value operator*() const
+            {
+                if (mView->mStorage)
+                {
+                    const auto &arch = *mView->mStorage->archetypes()[mA];
+                    return mView->makeValue(arch, mB, mC, std::index_sequence_for<Ts...>());
+                }
+
+                Entity ent = mView->driverEntity(mA);
+                return std::apply([ent](auto *...arrays)
+                    { return Value(ent, fetch<Ts>(arrays, ent)...); }, mView->mArrays);
+            }
+
+            Iterator &operator++()
+            {
+                if (mView->mStorage)
+                {
+                    mC++;
+                }
+                else
+                {
+                    mA++;
+                }
+                settle();
+                return *this;
+            }
+
+            bool operator==(const Iterator &rhs) const
+            {
+                return mA == rhs.mA && mB == rhs.mB && mC == rhs.mC;
+            }
+
+            bool operator!=(const Iterator &rhs) const
+            {
+                return !(*this == rhs);
+            }
+        };
+
+        // View over sparse storage
+        explicit View(ComponentArray<std::remove_const_t<Ts>> *...arrays)
+            : mArrays(arrays...)
+        {
+            // Drive iteration with the smallest array, every other array only gets has() checks
+            mDriverSize = static_cast<size_t>(-1);
+            (pickDriver(arrays), ...);
+        }
+
+        // View over archetype storage
+        View(const ArchetypeStorage &storage, const std::array<ComponentType, N> &types)
+            : mStorage(&storage), mTypes(types), mArchetypeCount(storage.archetypes().size())
+        {
+            for (ComponentType type : types)
+            {
+                mSignature.set(type);
+            }
+        }
+
+        Iterator begin() const
+        {
+            return Iterator(this, 0);
+        }
+
+        Iterator end() const
+        {
+            return Iterator(this, mStorage ? mArchetypeCount : mDriverSize);
+        }
+
+    private:
+        template <typename T>
+        void pickDriver(const ComponentArray<T> *array)
+        {
+            if (array->size() < mDriverSize)
+            {
+                mDriver = &array->entities();
+                mDriverSize = array->size();
+            }
+        }
+    };
+}
+
+#endif // _VIEW_H
@@ -59,6 +59,7 @@ void TritoneEditorScene::init()
     registerComponent<SampleLoadDialog>();
 
     // Register Systems
+    registerSystem<UpdateTransformHistory>();
     registerSystem<UpdateAndDrawAnimator>();
 
     registerSystem<UpdateTritone>();
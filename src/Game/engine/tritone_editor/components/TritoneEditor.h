@@ -47,7 +47,8 @@ struct TritoneEditor
 
     // Notes that are visible, but not on this track
     // This would have to change if I wanted to show the color of each note based on what track it's from
-    std::unordered_set<const NoteGrid::Note*> visibleGhostNotes;
+    // (A vector, so clearing it every frame keeps its memory)
+    std::vector<const NoteGrid::Note*> visibleGhostNotes{};
 
     // Events that are visible onscreen (will be different based on the mode we're in)
     std::vector<NoteGrid::EventMarker> visibleEvents{};
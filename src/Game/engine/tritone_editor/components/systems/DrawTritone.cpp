@@ -44,14 +44,15 @@ void DrawTritone::update()
         {
             // Draw current track
             Vec2i drawPos = Vec2i(15, m_game->getScreenHeight() - 28);
+            FrameArena &arena = m_scene->frameArena();
             Graphics::drawText(drawPos,
-                               "Track: " + std::to_string(tritone.currentTrack + 1),
+                               arena.format("Track: %d", tritone.currentTrack + 1),
                                measureTextColor,
                                GLUT_BITMAP_9_BY_15);
             // Draw BPM
             drawPos.y -= 20;
             Graphics::drawText(drawPos,
-                               "BPM: " + std::to_string(tritone.bpm),
+                               arena.format("BPM: %d", tritone.bpm),
                                measureTextColor,
                                GLUT_BITMAP_9_BY_15);
         }
@@ -278,7 +279,7 @@ void DrawTritone::drawSaveDialog(TritoneEditor &tritone, NoteGrid &noteGrid)
 {
     Content::sprSaveDialog.DrawEx(tritone.saveDialogPos);
     Graphics::drawText(tritone.saveDialogPos + saveTextOffset,
-                       tritone.filenameBuffer + ".tri",
+                       m_scene->frameArena().format("%s.tri", tritone.filenameBuffer.c_str()),
                        measureTextColor, GLUT_BITMAP_9_BY_15);
 }
 
@@ -1241,7 +1241,8 @@ void UpdateTritone::getVisibleEvents(TritoneEditor &tritone, NoteGrid &noteGrid)
         auto &measureMap = noteGrid.tracks.at(tritone.currentTrack).measureData;
 
         // Used to keep track of which notes we've already added to visibleNotes
-        std::unordered_set<NoteGrid::Note, NoteGrid::Note::Hash> visibleSet{};
+        // Rebuilt every time, so it lives in frame memory
+        std::pmr::unordered_set<NoteGrid::Note, NoteGrid::Note::Hash> visibleSet(&m_scene->frameArena());
 
         for (int i = startMeasure; i <= endMeasure; i++)
         {
@@ -1291,7 +1292,7 @@ void UpdateTritone::getVisibleEvents(TritoneEditor &tritone, NoteGrid &noteGrid)
             auto &measureList = measureMap.at(j);
             for (const NoteGrid::Note &note : measureList)
             {
-                tritone.visibleGhostNotes.insert(&note);
+                tritone.visibleGhostNotes.push_back(&note);
             }
         }
     }
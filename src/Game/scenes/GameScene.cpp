@@ -15,7 +15,8 @@ using namespace GS;
 
 void GameScene::init()
 {
-	registerGameplayComponents(this);
+	registerGameplayComponentTypes(this);
+	registerPipeline();
 
     int sw = m_game->getScreenWidth();
     int sh = m_game->getScreenHeight();
@@ -38,17 +39,24 @@ void GameScene::init()
     {
         int wallWidth = 88;
         int wallHeight = 72;
+
+        // The room's border is baked into a tilemap, the background art already draws it
+        constexpr int tileSize = 8;
+        constexpr uint8_t wall = Tilemap::CellSolid | Tilemap::CellGrapplable;
+
+        Entity room = Factory::tilemap(this, Vec2i(0, 0), tileSize, Vec2i(rw, rh) / tileSize);
+        Tilemap &tilemap = getComponent<Tilemap>(room);
         
         // Left
-        Factory::solidGrapplable(this, Vec2i(0, 0), Vec2i(wallWidth, rh));
+        TilemapCommon::fillRect(tilemap, Recti(0, 0, wallWidth, rh), wall);
         // Right
-        Factory::solidGrapplable(this, Vec2i(rw - wallWidth, 0), Vec2i(wallWidth, rh));
+        TilemapCommon::fillRect(tilemap, Recti(rw - wallWidth, 0, wallWidth, rh), wall);
         // Top 
-        Factory::solidGrapplable(this, Vec2i(0, 0), Vec2i(rw, wallHeight));
+        TilemapCommon::fillRect(tilemap, Recti(0, 0, rw, wallHeight), wall);
         // Bot
-        Factory::solidGrapplable(this, Vec2i(0, rh - wallHeight), Vec2i(rw, wallHeight));
+        TilemapCommon::fillRect(tilemap, Recti(0, rh - wallHeight, rw, wallHeight), wall);
 
-        // Middle walls
+        // Middle walls, off the tile grid so they stay entities
         Factory::solidGrapplable(this, Vec2i(700, 520), Vec2i(520, 40));
         // Factory::solidGrapplable(this, Vec2i(942, 304), Vec2i(36, 472));
         Factory::solidGrapplable(this, Vec2i(890, 472), Vec2i(140, 136));
@@ -63,13 +71,13 @@ void GameScene::update(const float dt)
         //Factory::smokeExplosion(this, m_game->m_input.mousePos(), 5);
     }
 
-    Scene::update(dt);
+    PipelineScene::update(dt);
 }
 
 void GameScene::draw()
 {
-    Content::sprMainBgBehind.DrawEx(-Vec2f(m_camera.m_pos) * 0.2f);
+    Content::sprMainBgBehind.DrawEx(-Vec2f(m_camera.drawPos()) * 0.2f);
     Content::sprMainBg.DrawExCam(Vec2i(0, 0));
 
-    Scene::draw();
+    PipelineScene::draw();
 }
@@ -1,9 +1,11 @@
 #ifndef _GAME_SCENE_H
 #define _GAME_SCENE_H
 
-#include <engine/ecs/Scene.h>
+#include <engine/ecs/SystemPipeline.h>
+#include <GameplayComponents.h>
 
-class GameScene : public Engine::Scene
+// Runs the gameplay systems through GamePipeline
+class GameScene : public Engine::PipelineScene<GS::GamePipeline>
 {
 public:
     void init() override;
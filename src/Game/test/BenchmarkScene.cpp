@@ -0,0 +1,47 @@
+#include "BenchmarkScene.h"
+
+#include <engine/DebugConsole.h>
+
+#include <test/benchmarks/Benchmark.h>
+
+using namespace Engine;
+using namespace GS;
+
+void BenchmarkScene::init()
+{
+    DebugConsole::show();
+
+    printf("==== Benchmarks ====\n");
+
+    Benchmark::componentArray();
+    Benchmark::archetypes();
+    Benchmark::entitySet();
+    Benchmark::entityManager();
+    Benchmark::commandBuffer();
+    Benchmark::parallelSystems();
+    Benchmark::frameAllocations();
+    Benchmark::entityCapacity();
+    Benchmark::snapshot();
+    Benchmark::prefabs();
+    Benchmark::componentMoves();
+    Benchmark::changeTracking();
+    Benchmark::pipeline();
+    Benchmark::spatialGrid();
+    Benchmark::sweptMovement();
+    Benchmark::grappleRaycast();
+    Benchmark::spatialBatch();
+    Benchmark::tilemap();
+    Benchmark::collisionLayers();
+    Benchmark::pairCache();
+    Benchmark::fixedTimestep();
+    Benchmark::activity();
+
+    if (Benchmark::failures > 0)
+    {
+        printf("==== Done, %d FAILED ====\n", Benchmark::failures);
+    }
+    else
+    {
+        printf("==== Done ====\n");
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef _BENCHMARK_SCENE_H
+#define _BENCHMARK_SCENE_H
+
+#include <engine/ecs/Scene.h>
+
+namespace GS
+{
+    // Runs the engine benchmarks once and prints the results to the debug console
+    class BenchmarkScene : public Engine::Scene
+    {
+    public:
+        void init() override;
+    };
+}
+
+#endif // _BENCHMARK_SCENE_H
@@ -11,6 +11,7 @@
 #include <components/Mover2D.h>
 #include <components/Particles2D.h>
 #include <components/Solid.h>
+#include <components/Tilemap.h>
 #include <components/UID.h>
 
 #include <test/components/TestBox.h>
@@ -24,6 +25,33 @@ namespace
     constexpr float minSpd = -4.0f;
     constexpr float maxSpd = 4.0f;
     constexpr float spdMult = 1.0f;
+
+    // Bouncers bounce off whatever they run into
+    class UpdateBouncers : public System
+    {
+    public:
+        UpdateMoveAndCollide2D *m_updateMoveAndCollide = nullptr;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            if (!m_updateMoveAndCollide)
+            {
+                m_updateMoveAndCollide = m_scene->getSystem<UpdateMoveAndCollide2D>();
+            }
+
+            for (const MoverHit &hit : m_updateMoveAndCollide->m_hits)
+            {
+                Mover2DCommon::bounce(m_scene->getComponent<Mover2D>(hit.ent), hit);
+            }
+        }
+    };
     
     void initMovers(Scene *scene)
     {
@@ -76,21 +104,6 @@ namespace
 
         UID uid;
 
-        // Bounce on collision
-        auto xCallback = [scene](Entity ent)
-            {
-                auto &mover = scene->getComponent<Mover2D>(ent);
-                mover.velocity.x = mover.velocityBeforeCollision.x * -1;
-            };
-        auto yCallback = [scene](Entity ent)
-            {
-                auto &mover = scene->getComponent<Mover2D>(ent);
-                mover.velocity.y = mover.velocityBeforeCollision.y * -1;
-            };
-
-        Mover2DCommon::setOnCollideX(mover, xCallback);
-        Mover2DCommon::setOnCollideY(mover, yCallback);
-
         scene->addComponent(ent, mover);
         scene->addComponent(ent, transform);
         scene->addComponent(ent, collider);
@@ -109,11 +122,15 @@ namespace
         scene->registerComponent<Collider2D>();
         scene->registerComponent<Solid>();
         scene->registerComponent<UID>();
+        scene->registerComponent<Tilemap>();
 
         // Systems
+        scene->registerSystem<UpdateTransformHistory>();
         scene->registerSystem<UpdateAndDrawAnimator>();
         scene->registerSystem<UpdateMoveAndCollide2D>();
+        scene->registerSystem<UpdateBouncers>();
         scene->registerSystem<UpdateSolids>();
+        scene->registerSystem<UpdateTilemap>();
         scene->registerSystem<UpdateUID>();
         // scene->registerSystem<DrawCollider2D>();
 
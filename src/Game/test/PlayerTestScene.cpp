@@ -2,6 +2,7 @@
 
 #include <engine/Time.h>
 #include <engine/Audio.h>
+#include <engine/AllocationCounter.h>
 
 #include <GameplayComponents.h>
 #include <Factory.h>
@@ -96,6 +97,42 @@ void PlayerTestScene::update(const float dt)
         }
     }
 
+    // Print how much system membership work happened last frame
+    if (m_game->m_input.keyPressed(App::KEY_2))
+    {
+        auto const &stats = getMembershipStats();
+        printf("Membership checks: %u, added: %u, removed: %u\n", stats.checks, stats.added, stats.removed);
+    }
+
+    // Print last frame's phase timings, heap allocations and ticks
+    if (m_game->m_input.keyPressed(App::KEY_3))
+    {
+        printf("%s", getPhaseReport().c_str());
+        printf("Heap allocations last frame: %llu, frame arena peak: %zu bytes\n",
+            static_cast<unsigned long long>(AllocationCounter::lastFrame()), frameArena().peak());
+        printf("Ticks last frame: %d, %.3fs dropped catching up\n", m_game->getTicksLastFrame(), m_game->getDroppedSeconds());
+        printf("%s", getSystem<UpdateActivity>()->report().c_str());
+    }
+
+    // Switch between running systems in parallel and serially
+    if (m_game->m_input.keyPressed(App::KEY_4))
+    {
+        setParallelSystems(!getParallelSystems());
+        printf("Parallel systems: %s\n", getParallelSystems() ? "on" : "off");
+    }
+
+    // Print how much memory each component type's storage is holding on to
+    if (m_game->m_input.keyPressed(App::KEY_5))
+    {
+        printf("%s", getMemoryReport().c_str());
+    }
+
+    // Print how many pairs each collision layer tested and rejected last frame
+    if (m_game->m_input.keyPressed(App::KEY_6))
+    {
+        printf("%s", getSystem<UpdateCollisions>()->report().c_str());
+    }
+
     // Move camera with arrow keys
     Vec2f inputAxis = m_game->m_input.getAxis(
         App::KEY_LEFT,
@@ -0,0 +1,189 @@
+#include "Benchmark.h"
+
+#include <engine/AabbTree.h>
+#include <engine/Math.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // A busy late game room, grapplable walls and a lot of enemies
+    constexpr int enemyCount = 1500;
+    constexpr int worldSize = 2000;
+    constexpr int enemySize = 12;
+    constexpr int wallCount = 40;
+    constexpr int frames = 20;
+
+    // Aim assist fans rays around the cursor
+    constexpr int rayCount = 64;
+    constexpr int rayLength = 400;
+    constexpr float raySpread = 0.6f;
+
+    struct World
+    {
+        // Rects of every grapplable, for every frame
+        std::vector<std::vector<Recti>> frames;
+        std::vector<std::vector<Linei>> rays;
+        Vec2i pos;
+    };
+
+    World makeWorld()
+    {
+        World world;
+        world.pos = Vec2i(worldSize / 2, worldSize / 2);
+
+        std::mt19937 random(19);
+        std::uniform_int_distribution<int> place(0, worldSize - enemySize);
+        std::uniform_int_distribution<int> wallLength(32, 256);
+        std::uniform_int_distribution<int> step(-3, 3);
+        std::uniform_real_distribution<float> angle(0.0f, 2.0f * Math::pi);
+
+        std::vector<Recti> rects;
+        for (int i = 0; i < wallCount; i++)
+        {
+            const bool horizontal = i % 2 == 0;
+            const int length = wallLength(random);
+            rects.push_back(Recti(place(random), place(random), horizontal ? length : 16, horizontal ? 16 : length));
+        }
+        for (int i = 0; i < enemyCount; i++)
+        {
+            rects.push_back(Recti(place(random), place(random), enemySize, enemySize));
+        }
+
+        for (int frame = 0; frame < frames; frame++)
+        {
+            // Walls stay put, enemies wander
+            for (size_t i = wallCount; i < rects.size(); i++)
+            {
+                rects[i].x += step(random);
+                rects[i].y += step(random);
+            }
+            world.frames.push_back(rects);
+
+            std::vector<Linei> rays;
+            const float aim = angle(random);
+            for (int i = 0; i < rayCount; i++)
+            {
+                const float rayAngle = aim + raySpread * (static_cast<float>(i) / (rayCount - 1) - 0.5f);
+                const Vec2i end = world.pos + Vec2i(static_cast<int>(std::cos(rayAngle) * rayLength), static_cast<int>(std::sin(rayAngle) * rayLength));
+                rays.push_back(Linei(world.pos, end));
+            }
+            world.rays.push_back(rays);
+        }
+        return world;
+    }
+
+    // What UpdatePlayer did before the tree: every grapplable, for every ray
+    RayHit castLinear(const std::vector<Recti> &rects, const Linei &ray, const Vec2i &pos)
+    {
+        RayHit best;
+        for (size_t i = 0; i < rects.size(); i++)
+        {
+            Vec2i point;
+            if (ray.intersectsClosest(pos, rects[i], &point))
+            {
+                float distance = (pos - point).lengthSquared();
+                if (best.distanceSquared < 0.0f || distance < best.distanceSquared)
+                {
+                    best.entity = static_cast<Entity>(i);
+                    best.point = point;
+                    best.distanceSquared = distance;
+                }
+            }
+        }
+        return best;
+    }
+
+    void sync(AabbTree &tree, const std::vector<Recti> &rects)
+    {
+        for (size_t i = 0; i < rects.size(); i++)
+        {
+            tree.update(static_cast<Entity>(i), rects[i]);
+        }
+    }
+
+    // Same point at the same distance, ties between entities can go either way
+    bool sameHits(const std::vector<RayHit> &a, const std::vector<RayHit> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if ((a[i].entity == NULL_ENTITY) != (b[i].entity == NULL_ENTITY) ||
+                a[i].point != b[i].point || a[i].distanceSquared != b[i].distanceSquared)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void Benchmark::grappleRaycast()
+{
+    printf("-- Grapple line of sight (%d grapplables, %d rays a frame, %d frames) --\n", enemyCount + wallCount, rayCount, frames);
+
+    const World world = makeWorld();
+
+    std::vector<RayHit> linearHits;
+    std::vector<RayHit> singleHits;
+    std::vector<RayHit> batchHits;
+
+    float linearMs = time(1, [&]()
+        {
+            for (int frame = 0; frame < frames; frame++)
+            {
+                for (const Linei &ray : world.rays[frame])
+                {
+                    linearHits.push_back(castLinear(world.frames[frame], ray, world.pos));
+                }
+            }
+        });
+
+    AabbTree singleTree;
+    float singleMs = time(1, [&]()
+        {
+            for (int frame = 0; frame < frames; frame++)
+            {
+                sync(singleTree, world.frames[frame]);
+                for (const Linei &ray : world.rays[frame])
+                {
+                    RayHit hit;
+                    singleTree.raycastClosest(ray, world.pos, &hit);
+                    singleHits.push_back(hit);
+                }
+            }
+        });
+
+    AabbTree batchTree;
+    float batchMs = time(1, [&]()
+        {
+            std::vector<RayHit> hits(rayCount);
+            for (int frame = 0; frame < frames; frame++)
+            {
+                sync(batchTree, world.frames[frame]);
+                batchTree.raycastClosest(world.rays[frame].data(), rayCount, world.pos, hits.data());
+                batchHits.insert(batchHits.end(), hits.begin(), hits.end());
+            }
+        });
+
+    report("scan every grapplable -> AABB tree", linearMs / frames, singleMs / frames);
+    report("one ray at a time -> batched rays", singleMs / frames, batchMs / frames);
+    printf("  Tree height %d for %d leaves\n", batchTree.height(), static_cast<int>(batchTree.size()));
+
+    // Every ray has to find the same hit, however it was cast
+    bool match = sameHits(linearHits, singleHits) && sameHits(linearHits, batchHits);
+    printf("  Hits %s\n", match ? "match" : "DON'T MATCH");
+    if (!match)
+    {
+        failures++;
+    }
+}
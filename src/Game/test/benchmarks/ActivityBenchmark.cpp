@@ -0,0 +1,451 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/Time.h>
+
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <components/Activity.h>
+#include <components/Collisions.h>
+#include <components/Mover2D.h>
+#include <components/Solid.h>
+#include <components/Tilemap.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // A level several screens across with waves spread all over it, the camera in the middle
+    constexpr Vec2i screenSize = Vec2i(1280, 720);
+    constexpr int screens = 6;
+    constexpr int enemyCount = 3000;
+    constexpr int coinCount = 600;
+    constexpr int effectCount = 400;
+    constexpr int particlesPerEffect = 24;
+    constexpr int frames = 120;
+
+    // Closes in on the middle of the level like UpdateEnemy does on the player
+    struct Chaser
+    {
+        float speed = 4.0f;
+        float spawnTime = 0.0f;
+    };
+
+    // Like Particles2D, a handful of particles to animate
+    struct Effect
+    {
+        struct Particle
+        {
+            Vec2f pos;
+            Vec2f velocity;
+            float rotation = 0.0f;
+            float time = 0.0f;
+        };
+        std::vector<Particle> particles;
+    };
+
+    class ChaseSystem : public System
+    {
+    public:
+        Vec2i m_target;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Chaser>());
+            sig.set(m_scene->getComponentType<Transform2D>());
+            sig.set(m_scene->getComponentType<Collider2D>());
+            sig.set(m_scene->getComponentType<Activity>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            ActivityCommon::forEachDue(m_scene, m_entities, [&](Entity ent, const Activity &activity)
+            {
+                const Chaser &chaser = m_scene->readComponent<Chaser>(ent);
+                Transform2D &transform = m_scene->getComponent<Transform2D>(ent);
+                Collider2D &collider = m_scene->getComponent<Collider2D>(ent);
+                const float delta = ActivityCommon::delta(activity);
+
+                Vec2f nrm = (m_target - transform.pos).normalized();
+                const Vec2i step(static_cast<int>(nrm.x * chaser.speed * delta), static_cast<int>(nrm.y * chaser.speed * delta));
+                transform.pos += step;
+                collider.rect.x += step.x;
+                collider.rect.y += step.y;
+
+                transform.scale.x = Math::damp(transform.scale.x, nrm.x < 0 ? -1.0f : 1.0f, 0.2f, ActivityCommon::deltaSeconds(activity) * 10.0f);
+                transform.scale.y = 1.0f + Math::sin(Time::seconds * 8.0f - chaser.spawnTime) * 0.1f;
+            });
+        }
+    };
+
+    class EffectSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Effect>());
+            sig.set(m_scene->getComponentType<Activity>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            ActivityCommon::forEachDue(m_scene, m_entities, [&](Entity ent, const Activity &activity)
+            {
+                const float delta = ActivityCommon::delta(activity);
+
+                for (Effect::Particle &particle : m_scene->getComponent<Effect>(ent).particles)
+                {
+                    particle.time += ActivityCommon::deltaSeconds(activity);
+                    particle.velocity += Vec2f(0.0f, 0.1f) * delta;
+                    particle.pos += particle.velocity * delta;
+                    particle.rotation += Math::degToRad(10.0f * delta);
+
+                    // Loops forever instead of running out
+                    if (particle.time > 1.0f)
+                    {
+                        particle.time = 0.0f;
+                        particle.velocity = Vec2f(0.0f, -2.0f);
+                    }
+                }
+            });
+        }
+    };
+
+    // Adds up the ticks each entity's updates covered
+    class CoveredSystem : public System
+    {
+    public:
+        std::vector<int> m_covered;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Activity>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            ActivityCommon::forEachDue(m_scene, m_entities, [&](Entity ent, const Activity &activity)
+            {
+                if (ent >= m_covered.size())
+                {
+                    m_covered.resize(ent + 1, 0);
+                }
+                m_covered[ent] += activity.ticks;
+            });
+        }
+    };
+
+    class WorldScene : public Scene
+    {
+    public:
+        Vec2i m_size;
+
+        WorldScene(int scale, bool activity)
+        {
+            m_size = screenSize * screens * scale;
+
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Solid>();
+            registerComponent<Tilemap>();
+            registerComponent<Activity>();
+            registerComponent<Chaser>();
+            registerComponent<Effect>();
+
+            registerSystem<UpdateTilemap>();
+            registerSystem<UpdateMoveAndCollide2D>();
+            registerSystem<UpdateSolids>();
+            registerSystem<ChaseSystem>();
+            registerSystem<EffectSystem>();
+            registerSystem<CoveredSystem>();
+            // Without it every activity stays awake, which is how everything updated before
+            if (activity)
+            {
+                registerSystem<UpdateActivity>();
+            }
+
+            m_camera.m_size = screenSize;
+            m_camera.m_pos = m_size / 2 - screenSize / 2;
+            getSystem<ChaseSystem>()->m_target = m_size / 2;
+
+            constexpr int wall = 16;
+            addSolid(Recti(0, 0, m_size.x, wall));
+            addSolid(Recti(0, m_size.y - wall, m_size.x, wall));
+            addSolid(Recti(0, 0, wall, m_size.y));
+            addSolid(Recti(m_size.x - wall, 0, wall, m_size.y));
+
+            // Same density whatever the size
+            const int count = scale * scale;
+            std::mt19937 random(47);
+            std::uniform_int_distribution<int> placeX(wall + 1, m_size.x - wall - 40);
+            std::uniform_int_distribution<int> placeY(wall + 1, m_size.y - wall - 40);
+            std::uniform_real_distribution<float> speed(-5.0f, 5.0f);
+
+            for (int i = 0; i < enemyCount * count; i++)
+            {
+                const Vec2i pos(placeX(random), placeY(random));
+                Entity ent = add(pos, Recti(pos, Vec2i(24, 24)), Activity::Level::Slow);
+                addComponent(ent, Chaser{ 2.0f + (i % 4), static_cast<float>(i % 7) });
+            }
+            for (int i = 0; i < coinCount * count; i++)
+            {
+                const Vec2i pos(placeX(random), placeY(random));
+                Entity ent = add(pos, Recti(pos, Vec2i(12, 12)), Activity::Level::Asleep);
+                Mover2D mover;
+                mover.velocity = Vec2f(speed(random), speed(random));
+                addComponent(ent, mover);
+            }
+            for (int i = 0; i < effectCount * count; i++)
+            {
+                Entity ent = createEntity();
+                Transform2D transform;
+                transform.pos = Vec2i(placeX(random), placeY(random));
+                addComponent(ent, transform);
+                Activity activity;
+                activity.deepest = Activity::Level::Slow;
+                addComponent(ent, activity);
+                Effect effect;
+                effect.particles.resize(particlesPerEffect);
+                addComponent(ent, std::move(effect));
+            }
+        }
+
+        Entity add(const Vec2i &pos, const Recti &rect, Activity::Level deepest)
+        {
+            Entity ent = createEntity();
+            Transform2D transform;
+            transform.pos = pos;
+            addComponent(ent, transform);
+            addComponent(ent, Collider2D{ rect });
+            Activity activity;
+            activity.deepest = deepest;
+            addComponent(ent, activity);
+            return ent;
+        }
+
+        void addSolid(const Recti &rect)
+        {
+            Entity ent = createEntity();
+            Transform2D transform;
+            transform.pos = rect.position();
+            addComponent(ent, transform);
+            addComponent(ent, Collider2D{ rect });
+            addComponent(ent, Solid());
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+    };
+
+    // Two colliders and the systems to wake one with the other
+    class WakeScene : public Scene
+    {
+    public:
+        WakeScene()
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Activity>();
+
+            registerSystem<UpdateActivity>();
+            registerSystem<UpdateCollisions>();
+
+            m_camera.m_size = screenSize;
+        }
+
+        Entity add(const Vec2i &pos)
+        {
+            Entity ent = createEntity();
+            Transform2D transform;
+            transform.pos = pos;
+            addComponent(ent, transform);
+            addComponent(ent, Collider2D{ Recti(pos, Vec2i(16, 16)) });
+            addComponent(ent, Activity());
+            return ent;
+        }
+
+        void moveTo(Entity ent, const Vec2i &pos)
+        {
+            getComponent<Transform2D>(ent).pos = pos;
+            getComponent<Collider2D>(ent).rect = Recti(pos, Vec2i(16, 16));
+        }
+
+        void remove(Entity ent)
+        {
+            destroyEntity(ent);
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+    };
+
+    float timeFrames(WorldScene &scene)
+    {
+        // The first ticks sort everything out and grow the pair lists
+        for (int i = 0; i < 4; i++)
+        {
+            scene.step();
+        }
+        return Benchmark::time(frames, [&]() { scene.step(); });
+    }
+
+    void check(bool ok, const char *what)
+    {
+        printf("  %s: %s\n", what, ok ? "ok" : "FAIL");
+        if (!ok)
+        {
+            Benchmark::failures++;
+        }
+    }
+}
+
+void Benchmark::activity()
+{
+    printf("-- Activity (%d enemies, %d coins, %d effects over %dx%d screens) --\n", enemyCount, coinCount, effectCount, screens, screens);
+
+    const float delta = Time::delta;
+    const float deltaSeconds = Time::deltaSeconds;
+    Time::delta = 1.0f;
+    Time::deltaSeconds = 1.0f / 60.0f;
+
+    float everyTickMs = 0.0f;
+    float activityMs = 0.0f;
+    {
+        WorldScene everything(1, false);
+        WorldScene nearby(1, true);
+        everyTickMs = timeFrames(everything);
+        activityMs = timeFrames(nearby);
+        report("update everything -> only near the camera", everyTickMs, activityMs);
+        printf("%s", nearby.getSystem<UpdateActivity>()->report().c_str());
+
+        // Slow entities skip ticks but never lose them, their updates cover every tick up to the last one
+        const std::vector<int> &covered = nearby.getSystem<CoveredSystem>()->m_covered;
+        bool allCovered = true;
+        int behind = 0;
+        for (auto [ent, state] : nearby.view<const Activity>())
+        {
+            if (state.deepest == Activity::Level::Slow)
+            {
+                allCovered = allCovered && covered[ent] == static_cast<int>(state.lastTick);
+                behind += state.level != Activity::Level::Awake;
+            }
+        }
+        check(allCovered && behind > 0, "Slow entities cover every tick");
+
+        // Skipped movers aren't written to, so the systems following changes don't see them either
+        const Tick before = ChangeTick::current();
+        nearby.step();
+        int asleep = 0;
+        int touched = 0;
+        for (auto [ent, state, mover] : nearby.view<const Activity, const Mover2D>())
+        {
+            if (state.level == Activity::Level::Asleep)
+            {
+                asleep++;
+                touched += nearby.changedSince<Transform2D>(ent, before) || nearby.changedSince<Collider2D>(ent, before)
+                    || nearby.changedSince<Mover2D>(ent, before);
+            }
+        }
+        check(asleep > 0 && touched == 0, "Sleeping movers aren't marked changed");
+
+        // Everything the camera moves onto is awake on the next tick
+        nearby.m_camera.m_pos = Vec2i(0, 0);
+        nearby.step();
+        bool inViewAwake = true;
+        for (auto [ent, state, transform] : nearby.view<const Activity, const Transform2D>())
+        {
+            if (nearby.m_camera.getRect().contains(transform.pos) && (state.level != Activity::Level::Awake || state.ticks == 0))
+            {
+                inViewAwake = false;
+            }
+        }
+        check(inViewAwake, "Camera wakes what it moves onto");
+    }
+
+    // Twice as much level with the same density, what's near the camera stays the same
+    {
+        WorldScene everything(2, false);
+        WorldScene nearby(2, true);
+        const float everyTickBigMs = timeFrames(everything);
+        const float activityBigMs = timeFrames(nearby);
+        printf("  4x the level and population: updating everything x%.2f the time, only near the camera x%.2f\n",
+            everyTickBigMs / everyTickMs, activityBigMs / activityMs);
+    }
+
+    // Resting entities keep their slice while others come and go, so each is still checked every slow interval.
+    // A sleeper's lastTick is the tick it was last checked on.
+    {
+        WakeScene scene;
+        const uint32_t interval = static_cast<uint32_t>(scene.getSystem<UpdateActivity>()->m_slowInterval);
+
+        // Far off screen and spaced out, so everything sleeps and nothing collides
+        constexpr int spacing = 40;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 2000; i++)
+        {
+            entities.push_back(scene.add(Vec2i(10000 + (i % 50) * spacing, 10000 + (i / 50) * spacing)));
+        }
+
+        std::mt19937 random(11);
+        std::uniform_int_distribution<size_t> pick(0, entities.size() - 1);
+        bool checkedInTime = true;
+        for (uint32_t tick = 1; tick <= 200; tick++)
+        {
+            // Replace a few, shuffling where the others are kept
+            for (int i = 0; i < 20; i++)
+            {
+                const size_t index = pick(random);
+                const Vec2i pos = scene.readComponent<Transform2D>(entities[index]).pos;
+                scene.remove(entities[index]);
+                entities[index] = scene.add(pos);
+            }
+            scene.step();
+
+            for (auto [ent, state] : scene.view<const Activity>())
+            {
+                if (state.level == Activity::Level::Asleep && tick - state.lastTick >= interval)
+                {
+                    checkedInTime = false;
+                }
+            }
+        }
+        check(checkedInTime, "Resting entities are checked every slow interval");
+    }
+
+    // A sleeping entity is woken by something awake running into it
+    {
+        WakeScene scene;
+        Entity sleeper = scene.add(Vec2i(5000, 5000));
+        Entity visitor = scene.add(Vec2i(6000, 6000));
+        scene.getSystem<UpdateActivity>()->wake(visitor, 1000);
+
+        scene.step();
+        const bool slept = scene.readComponent<Activity>(sleeper).level == Activity::Level::Asleep;
+
+        // One tick for the overlap pass to see it, one for the activity to read the event
+        scene.moveTo(visitor, Vec2i(5004, 5004));
+        scene.step();
+        scene.step();
+        const bool woken = scene.readComponent<Activity>(sleeper).level == Activity::Level::Awake;
+        check(slept && woken, "Collisions with awake things wake sleepers");
+    }
+
+    Time::delta = delta;
+    Time::deltaSeconds = deltaSeconds;
+}
@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <engine/components/Animator.h>
+#include <components/Mover2D.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int iterations = 200;
+    constexpr Entity moverCount = 4096;
+
+    // Fill a scene with moverCount movers, every third one also has an Animator
+    // so there's more than one archetype to walk through
+    std::vector<Entity> createMovers(Scene *scene)
+    {
+        scene->registerComponent<Transform2D>();
+        scene->registerComponent<Collider2D>();
+        scene->registerComponent<Mover2D>();
+        scene->registerComponent<Animator>();
+
+        std::vector<Entity> entities;
+        for (Entity i = 0; i < moverCount; i++)
+        {
+            Entity ent = scene->createEntity();
+
+            Transform2D transform;
+            transform.pos = Vec2i(i % 64, i / 64);
+
+            Collider2D collider;
+            collider.rect = Recti(transform.pos, Vec2i(8, 8));
+
+            Mover2D mover;
+            mover.velocity = Vec2f(1.5f, -0.5f);
+
+            scene->addComponent(ent, transform);
+            scene->addComponent(ent, collider);
+            scene->addComponent(ent, mover);
+
+            if (i % 3 == 0)
+            {
+                scene->addComponent(ent, Animator());
+            }
+
+            entities.push_back(ent);
+        }
+        return entities;
+    }
+
+    // Same integration as UpdateMover2D, without collision
+    void step(Transform2D &transform, Collider2D &collider, Mover2D &mover)
+    {
+        Vec2f total = mover.remainder + mover.velocity;
+        Vec2i toMove = Vec2i(static_cast<int>(total.x), static_cast<int>(total.y));
+        mover.remainder = total - toMove;
+
+        transform.pos += toMove;
+        collider.rect.x = transform.pos.x;
+        collider.rect.y = transform.pos.y;
+    }
+
+    // What systems do today: walk an entity list and look every component up
+    void updateByLookup(Scene *scene, const std::vector<Entity> &entities)
+    {
+        for (Entity ent : entities)
+        {
+            step(scene->getComponent<Transform2D>(ent),
+                scene->getComponent<Collider2D>(ent),
+                scene->getComponent<Mover2D>(ent));
+        }
+    }
+
+    void updateByView(Scene *scene)
+    {
+        for (auto [ent, transform, collider, mover] : scene->view<Transform2D, Collider2D, Mover2D>())
+        {
+            step(transform, collider, mover);
+        }
+    }
+
+    void updateByChunk(Scene *scene)
+    {
+        scene->forEachChunk<Transform2D, Collider2D, Mover2D>(
+            [](size_t count, const Entity *, Transform2D *transforms, Collider2D *colliders, Mover2D *movers)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    step(transforms[i], colliders[i], movers[i]);
+                }
+            });
+    }
+}
+
+void Benchmark::archetypes()
+{
+    printf("-- Archetype storage (%d movers) --\n", static_cast<int>(moverCount));
+
+    auto sparseScene = std::make_unique<Scene>();
+    std::vector<Entity> sparseEntities = createMovers(sparseScene.get());
+
+    auto archetypeScene = std::make_unique<Scene>();
+    archetypeScene->setStorage(Scene::Storage::Archetype);
+    std::vector<Entity> archetypeEntities = createMovers(archetypeScene.get());
+
+    float sparseMs = time(iterations, [&]() { updateByLookup(sparseScene.get(), sparseEntities); });
+
+    report("getComponent: sparse -> archetype",
+        sparseMs,
+        time(iterations, [&]() { updateByLookup(archetypeScene.get(), archetypeEntities); }));
+
+    report("sparse: getComponent -> view",
+        sparseMs,
+        time(iterations, [&]() { updateByView(sparseScene.get()); }));
+
+    report("sparse lookups -> archetype view",
+        sparseMs,
+        time(iterations, [&]() { updateByView(archetypeScene.get()); }));
+
+    report("sparse lookups -> archetype chunks",
+        sparseMs,
+        time(iterations, [&]() { updateByChunk(archetypeScene.get()); }));
+
+    sink = sparseScene->getComponent<Transform2D>(sparseEntities.back()).pos.x +
+        archetypeScene->getComponent<Transform2D>(archetypeEntities.back()).pos.x;
+}
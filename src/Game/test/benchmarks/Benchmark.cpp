@@ -0,0 +1,32 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+
+using namespace GS;
+
+void Benchmark::report(const char *name, float ms)
+{
+    printf("  %-40s %10.4f ms\n", name, ms);
+}
+
+void Benchmark::reportAllocations(const char *name, uint64_t allocations, int frames)
+{
+    if (!Engine::AllocationCounter::enabled)
+    {
+        printf("  %-40s allocation counter compiled out\n", name);
+        return;
+    }
+
+    if (allocations != 0)
+    {
+        failures++;
+    }
+    printf("  %-40s %10llu allocations over %d frames  %s\n", name,
+        static_cast<unsigned long long>(allocations), frames, allocations == 0 ? "(ok)" : "(FAILED)");
+}
+
+void Benchmark::report(const char *name, float baselineMs, float candidateMs)
+{
+    float speedup = candidateMs > 0.0f ? baselineMs / candidateMs : 0.0f;
+    printf("  %-40s %10.4f ms -> %10.4f ms  (x%.2f)\n", name, baselineMs, candidateMs, speedup);
+}
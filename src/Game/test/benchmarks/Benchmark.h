@@ -0,0 +1,113 @@
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+
+#include <engine/AllocationCounter.h>
+
+// Small timing helpers for comparing engine internals against each other.
+// Run them through BenchmarkScene, results are printed to the debug console.
+
+namespace GS
+{
+    namespace Benchmark
+    {
+        // Written to by benchmarks so the optimizer can't throw their work away
+        inline volatile uint64_t sink = 0;
+
+        // Checks that failed during this run (see expectNoAllocations)
+        inline int failures = 0;
+
+        // Run 'func' a number of times, returns the average time of one run in milliseconds
+        template <class F>
+        float time(int iterations, F &&func)
+        {
+            auto timeStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < iterations; i++)
+            {
+                func();
+            }
+            std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - timeStart;
+            return duration.count() / iterations;
+        }
+
+        // Print an allocation count, counts as a failure if it isn't zero
+        void reportAllocations(const char *name, uint64_t allocations, int frames);
+
+        // Run 'frame' 'warmup' times so caches and pools can grow, then 'frames' more times,
+        // failing the run if any of those later frames allocated. Returns the number of allocations.
+        template <class F>
+        uint64_t expectNoAllocations(const char *name, int warmup, int frames, F &&frame)
+        {
+            for (int i = 0; i < warmup; i++)
+            {
+                frame();
+            }
+
+            uint64_t start = Engine::AllocationCounter::total();
+            for (int i = 0; i < frames; i++)
+            {
+                frame();
+            }
+            uint64_t allocations = Engine::AllocationCounter::total() - start;
+
+            reportAllocations(name, allocations, frames);
+            return allocations;
+        }
+
+        // Print a single timing
+        void report(const char *name, float ms);
+        // Print a baseline timing next to a candidate timing and the speedup between them
+        void report(const char *name, float baselineMs, float candidateMs);
+
+        // -- Benchmarks --
+        // Sparse-set ComponentArray vs. the old unordered_map layout
+        void componentArray();
+        // Per-component arrays vs. archetype chunks on a scene full of movers
+        void archetypes();
+        // std::set vs. EntitySet for system membership
+        void entitySet();
+        // Queue-based entity IDs vs. generational handles with a free list
+        void entityManager();
+        // Spawning with immediate addComponent vs. queued commands
+        void commandBuffer();
+        // Running every system one after another vs. independent systems at the same time
+        void parallelSystems();
+        // Heap allocations in steady state frames, fails the run if there are any
+        void frameAllocations();
+        // Memory of paged component storage vs. the old fixed arrays, and a scene past the old entity cap
+        void entityCapacity();
+        // Rebuilding a scene from scratch vs. restoring a snapshot of it
+        void snapshot();
+
+        // addComponent one at a time vs. spawning a prefab, one by one and in bulk
+        void prefabs();
+        // Removing components with heap memory of their own by copy vs. by move, and that released slots are destroyed
+        void componentMoves();
+        // Sorting every entity by depth each frame vs. only when change tracking says something moved
+        void changeTracking();
+        // Systems run through SystemManager's update lists vs. a compile-time SystemPipeline
+        void pipeline();
+        // Movers colliding against every solid vs. only the solids in nearby grid cells
+        void spatialGrid();
+        // Movers stepping one pixel at a time vs. sweeping to the first solid in the way, and recorded traces through both
+        void sweptMovement();
+        // Grapple line of sight against every grapplable vs. an AABB tree, one ray at a time and batched
+        void grappleRaycast();
+        // Rect and line tests one pair at a time vs. SIMD kernels over rects stored one array per field
+        void spatialBatch();
+        // Level walls as one solid entity per cell vs. a baked tilemap, for movement and line of sight
+        void tilemap();
+        // One collision pass testing every overlapping pair vs. skipping pairs whose layers don't interact
+        void collisionLayers();
+        // Testing every collider every frame vs. keeping the pairs of colliders that didn't change, and movers with hit callbacks vs. a hit buffer
+        void pairCache();
+        // Updating with each frame's delta vs. in fixed ticks, for the same frames cut up differently
+        void fixedTimestep();
+        // Updating every enemy, coin and effect every tick vs. only near the camera, slowing down and sleeping the rest
+        void activity();
+    }
+}
+
+#endif // _BENCHMARK_H
@@ -0,0 +1,208 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int entityCount = 4000;
+    // Enemies and the player, everything else is solids and idle pickups
+    constexpr int movingCount = 40;
+    constexpr int iterations = 200;
+
+    struct Depth
+    {
+        int depth = 0;
+    };
+
+    struct Moving
+    {
+        int speed = 1;
+    };
+
+    struct DrawEntry
+    {
+        Entity ent;
+        int depth;
+    };
+
+    // Moves a few entities every frame
+    class MoveSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Depth>());
+            sig.set(m_scene->getComponentType<Moving>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            for (auto [ent, depth, moving] : m_scene->view<Depth, const Moving>())
+            {
+                depth.depth = (depth.depth + moving.speed * 37) % entityCount;
+            }
+        }
+    };
+
+    // What UpdateAndDrawAnimator used to do: gather everything and sort it every frame
+    class FullSortSystem : public System
+    {
+    public:
+        std::vector<DrawEntry> m_order;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Depth>());
+            setup(0, Type::Draw, sig);
+        }
+
+        void update() override
+        {
+            m_order.clear();
+            for (auto [ent, depth] : m_scene->view<const Depth>())
+            {
+                m_order.push_back({ ent, depth.depth });
+            }
+            std::sort(m_order.begin(), m_order.end(), [](const DrawEntry &ls, const DrawEntry &rs)
+                { return ls.depth < rs.depth || (ls.depth == rs.depth && ls.ent < rs.ent); });
+        }
+    };
+
+    // Keeps its order between frames and only sorts again when something changed
+    class TrackedSortSystem : public System
+    {
+    public:
+        std::vector<DrawEntry> m_order;
+        bool m_dirty = true;
+        // Entities seen changing during the last update
+        size_t m_changed = 0;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Depth>());
+            setup(0, Type::Draw, sig);
+        }
+
+        void entityAdded(Entity const &ent) override
+        {
+            m_order.push_back({ ent, 0 });
+            m_dirty = true;
+        }
+
+        void update() override
+        {
+            m_changed = 0;
+            m_scene->forEachChanged<Depth>(lastRunTick(), [this](Entity)
+                { m_changed++; });
+            if (m_changed == 0 && !m_dirty)
+            {
+                return;
+            }
+
+            for (auto &entry : m_order)
+            {
+                entry.depth = m_scene->readComponent<Depth>(entry.ent).depth;
+            }
+            for (size_t i = 1; i < m_order.size(); i++)
+            {
+                DrawEntry entry = m_order[i];
+                size_t j = i;
+                while (j > 0 && (m_order[j - 1].depth > entry.depth || (m_order[j - 1].depth == entry.depth && m_order[j - 1].ent > entry.ent)))
+                {
+                    m_order[j] = m_order[j - 1];
+                    j--;
+                }
+                m_order[j] = entry;
+            }
+            m_dirty = false;
+        }
+    };
+
+    template <class SortSystem>
+    class DepthScene : public Scene
+    {
+    public:
+        explicit DepthScene(int moving)
+        {
+            registerComponent<Depth>();
+            registerComponent<Moving>();
+
+            registerSystem<MoveSystem>();
+            registerSystem<SortSystem>();
+
+            for (int i = 0; i < entityCount; i++)
+            {
+                Entity ent = createEntity();
+                addComponent(ent, Depth{ (i * 7919) % entityCount });
+                if (i < moving)
+                {
+                    addComponent(ent, Moving{ 1 + i % 3 });
+                }
+            }
+        }
+
+        // One frame, moving in update and sorting in draw
+        void step()
+        {
+            mSystemManager.update();
+            mSystemManager.draw();
+        }
+
+        SortSystem *sorter()
+        {
+            return getSystem<SortSystem>();
+        }
+    };
+
+    // Time frames of both sorting systems with 'moving' entities changing depth every frame
+    bool compare(const char *name, int moving)
+    {
+        DepthScene<FullSortSystem> full(moving);
+        DepthScene<TrackedSortSystem> tracked(moving);
+
+        full.step();
+        tracked.step();
+
+        float fullMs = Benchmark::time(iterations, [&]() { full.step(); });
+        float trackedMs = Benchmark::time(iterations, [&]() { tracked.step(); });
+        Benchmark::report(name, fullMs, trackedMs);
+
+        // Both have to end up drawing in the same order
+        auto const &a = full.sorter()->m_order;
+        auto const &b = tracked.sorter()->m_order;
+        bool match = a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const DrawEntry &l, const DrawEntry &r)
+            { return l.ent == r.ent && l.depth == r.depth; });
+
+        // Only the entities that moved should have shown up as changed
+        bool changedOk = tracked.sorter()->m_changed == static_cast<size_t>(moving);
+        printf("  Order %s, %zu changed last frame%s\n", match ? "matches" : "DOESN'T MATCH", tracked.sorter()->m_changed, changedOk ? "" : " (WRONG)");
+        return match && changedOk;
+    }
+}
+
+void Benchmark::changeTracking()
+{
+    printf("-- Change tracking (%d entities sorted by depth) --\n", entityCount);
+
+    bool ok = compare("static: sort -> changed only", 0);
+
+    char name[64];
+    snprintf(name, sizeof(name), "%d moving: sort -> changed only", movingCount);
+    ok = compare(name, movingCount) && ok;
+    if (!ok)
+    {
+        failures++;
+    }
+}
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+
+#include <engine/components/Collider2D.h>
+#include <components/Collisions.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // A late game swarm closing in on the player, with the coins dead enemies left behind
+    constexpr int enemyCount = 1500;
+    constexpr int coinCount = 300;
+    constexpr int wallCount = 200;
+    constexpr int swarmSize = 900;
+    constexpr int frames = 20;
+
+    // Enemies wander a little every frame
+    class SwarmSystem : public System
+    {
+    public:
+        std::mt19937 m_random{ 17 };
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Collider2D>());
+            setup(0, Type::PreUpdate, sig);
+        }
+
+        void update() override
+        {
+            std::uniform_int_distribution<int> step(-2, 2);
+            for (auto [ent, collider] : m_scene->view<Collider2D>())
+            {
+                if (collider.layer == Layer::Enemy)
+                {
+                    collider.rect.x += step(m_random);
+                    collider.rect.y += step(m_random);
+                }
+            }
+        }
+    };
+
+    class SwarmScene : public Scene
+    {
+    public:
+        explicit SwarmScene(bool layered)
+        {
+            registerComponent<Collider2D>();
+
+            registerSystem<SwarmSystem>();
+            registerSystem<UpdateCollisions>();
+
+            // Without layers everything is tested against everything, like one pass with no filtering
+            if (layered)
+            {
+                CollisionsCommon::setupLayers(m_collisionMatrix);
+            }
+
+            std::mt19937 random(29);
+            std::uniform_int_distribution<int> swarm(0, swarmSize);
+            std::uniform_int_distribution<int> room(-200, swarmSize + 200);
+
+            add(Recti(swarmSize / 2, swarmSize / 2, 22, 26), Layer::Player);
+            for (int i = 0; i < enemyCount; i++)
+            {
+                add(Recti(swarm(random), swarm(random), 24, 24), Layer::Enemy);
+            }
+            for (int i = 0; i < coinCount; i++)
+            {
+                add(Recti(swarm(random), swarm(random), 10, 10), Layer::Coin);
+            }
+            for (int i = 0; i < wallCount; i++)
+            {
+                add(Recti(room(random), room(random), 32, 32), Layer::Wall);
+            }
+        }
+
+        void add(const Recti &rect, uint8_t layer)
+        {
+            Entity ent = createEntity();
+            Collider2D collider;
+            collider.rect = rect;
+            collider.layer = layer;
+            addComponent(ent, collider);
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+
+        UpdateCollisions *collisions()
+        {
+            return getSystem<UpdateCollisions>();
+        }
+    };
+}
+
+void Benchmark::collisionLayers()
+{
+    printf("-- Collision layers (%d enemies, %d coins, %d walls, %d frames) --\n", enemyCount, coinCount, wallCount, frames);
+
+    SwarmScene everything(false);
+    SwarmScene layered(true);
+
+    float everythingMs = time(frames, [&]() { everything.step(); });
+    float layeredMs = time(frames, [&]() { layered.step(); });
+    report("every pair -> layer matrix", everythingMs, layeredMs);
+
+    // The layered pass has to find exactly the unfiltered contacts whose layers interact
+    CollisionMatrix matrix;
+    CollisionsCommon::setupLayers(matrix);
+
+    std::vector<Contact> expected;
+    for (const Contact &contact : everything.collisions()->contacts())
+    {
+        const uint8_t a = everything.readComponent<Collider2D>(contact.ent).layer;
+        const uint8_t b = everything.readComponent<Collider2D>(contact.other).layer;
+        if (matrix.interacts(a, b))
+        {
+            expected.push_back(contact);
+        }
+    }
+
+    const std::vector<Contact> &found = layered.collisions()->contacts();
+    bool match = expected.size() == found.size();
+    for (size_t i = 0; match && i < found.size(); i++)
+    {
+        match = expected[i].ent == found[i].ent && expected[i].other == found[i].other;
+    }
+
+    printf("%s", layered.collisions()->report().c_str());
+    printf("  Contacts %s (%d)\n", match ? "match" : "DON'T MATCH", static_cast<int>(found.size()));
+    if (!match)
+    {
+        failures++;
+    }
+}
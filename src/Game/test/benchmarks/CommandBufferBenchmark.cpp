@@ -0,0 +1,118 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <engine/components/Animator.h>
+#include <components/Mover2D.h>
+
+#include <cstdio>
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int spawnCount = 50;
+    constexpr int iterations = 500;
+    // About as many systems as GameScene has
+    constexpr int systemCount = 16;
+
+    // Systems that only exist to have entities join and leave them
+    template <int N>
+    class MembershipSystem : public System
+    {
+    public:
+        Signature m_signature;
+
+        void init() override
+        {
+            setup(0, Type::Update, m_signature);
+        }
+    };
+
+    class CommandScene : public Scene
+    {
+    public:
+        using Scene::flushCommands;
+        using Scene::destroyEntity;
+
+        CommandScene()
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Animator>();
+
+            // A spread of signatures, like the gameplay systems
+            Signature transform;
+            transform.set(getComponentType<Transform2D>());
+
+            Signature mover = transform;
+            mover.set(getComponentType<Mover2D>());
+
+            Signature collider = mover;
+            collider.set(getComponentType<Collider2D>());
+
+            Signature animator = transform;
+            animator.set(getComponentType<Animator>());
+
+            registerSystems(std::make_integer_sequence<int, systemCount>(), { transform, mover, collider, animator });
+        }
+
+        // Register systemCount systems, cycling through the signatures
+        template <int... N>
+        void registerSystems(std::integer_sequence<int, N...>, const std::array<Signature, 4> &signatures)
+        {
+            (registerSystem<MembershipSystem<N>>(), ...);
+            (setSystemSignature<MembershipSystem<N>>(signatures[N % signatures.size()]), ...);
+        }
+    };
+
+    template <bool Queued>
+    void spawn(CommandScene *scene, std::vector<Entity> &entities)
+    {
+        entities.clear();
+        for (int i = 0; i < spawnCount; i++)
+        {
+            Entity ent = scene->createEntity();
+            if (Queued)
+            {
+                scene->queueAddComponent(ent, Transform2D());
+                scene->queueAddComponent(ent, Collider2D());
+                scene->queueAddComponent(ent, Mover2D());
+                scene->queueAddComponent(ent, Animator());
+            }
+            else
+            {
+                scene->addComponent(ent, Transform2D());
+                scene->addComponent(ent, Collider2D());
+                scene->addComponent(ent, Mover2D());
+                scene->addComponent(ent, Animator());
+            }
+            entities.push_back(ent);
+        }
+        scene->flushCommands();
+
+        for (Entity ent : entities)
+        {
+            scene->destroyEntity(ent);
+        }
+    }
+}
+
+void Benchmark::commandBuffer()
+{
+    printf("-- Command buffer (%d entities, 4 components each) --\n", spawnCount);
+
+    auto scene = std::make_unique<CommandScene>();
+    std::vector<Entity> entities;
+
+    report("addComponent -> queueAddComponent",
+        time(iterations, [&]() { spawn<false>(scene.get(), entities); }),
+        time(iterations, [&]() { spawn<true>(scene.get(), entities); }));
+}
@@ -0,0 +1,146 @@
+#include "Benchmark.h"
+
+#include <engine/ecs/ComponentArray.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int entityCount = 1024;
+    constexpr int lookupsPerEntity = 6;
+    constexpr int iterations = 200;
+    // Entity IDs are scattered across the range of the old fixed entity cap
+    constexpr Entity idRange = 4096;
+
+    // Roughly the size of the components we look up every frame
+    struct BenchComponent
+    {
+        int x = 0;
+        int y = 0;
+        float scale = 1.0f;
+        float rotation = 0.0f;
+    };
+
+    // The ComponentArray layout we had before the sparse set, kept here for comparison
+    template <typename T>
+    class LegacyComponentArray
+    {
+    private:
+        std::array<T, idRange> mData;
+        std::unordered_map<Entity, size_t> mEntityToIndex;
+        std::unordered_map<size_t, Entity> mIndexToEntity;
+        size_t mSize = 0;
+
+    public:
+        void insert(const Entity entity, const T &component)
+        {
+            size_t newIndex = mSize;
+            mEntityToIndex[entity] = newIndex;
+            mIndexToEntity[newIndex] = entity;
+            mData[newIndex] = component;
+            mSize++;
+        }
+
+        void remove(const Entity entity)
+        {
+            size_t indexOfRemovedEntity = mEntityToIndex[entity];
+            size_t indexLast = mSize - 1;
+            Entity entityLast = mIndexToEntity[indexLast];
+
+            mData[indexOfRemovedEntity] = mData[indexLast];
+
+            mEntityToIndex[entityLast] = indexOfRemovedEntity;
+            mIndexToEntity[indexOfRemovedEntity] = entityLast;
+
+            mEntityToIndex.erase(entity);
+            mIndexToEntity.erase(indexLast);
+            mSize--;
+        }
+
+        T &get(const Entity entity)
+        {
+            return mData[mEntityToIndex[entity]];
+        }
+
+        bool has(const Entity entity)
+        {
+            return mEntityToIndex.find(entity) != mEntityToIndex.end();
+        }
+    };
+
+    template <class Array>
+    void fill(Array &array, const std::vector<Entity> &entities)
+    {
+        for (Entity ent : entities)
+        {
+            BenchComponent c;
+            c.x = static_cast<int>(ent);
+            array.insert(ent, c);
+        }
+    }
+
+    // Mimics a system loop that fetches a handful of components per entity
+    template <class Array>
+    void lookups(Array &array, const std::vector<Entity> &entities)
+    {
+        uint64_t sum = 0;
+        for (Entity ent : entities)
+        {
+            for (int i = 0; i < lookupsPerEntity; i++)
+            {
+                if (array.has(ent))
+                {
+                    sum += array.get(ent).x;
+                }
+            }
+        }
+        Benchmark::sink = sum;
+    }
+
+    // Destroy and re-create every entity, like particles being spawned and finished
+    template <class Array>
+    void churn(Array &array, const std::vector<Entity> &entities)
+    {
+        for (Entity ent : entities)
+        {
+            array.remove(ent);
+        }
+        fill(array, entities);
+    }
+}
+
+void Benchmark::componentArray()
+{
+    printf("-- ComponentArray (%d entities, %d lookups each) --\n", entityCount, lookupsPerEntity);
+
+    // Scatter the entity IDs so neither layout gets a lucky access pattern
+    std::vector<Entity> entities(idRange);
+    std::iota(entities.begin(), entities.end(), 0);
+    std::shuffle(entities.begin(), entities.end(), std::mt19937(1234));
+    entities.resize(entityCount);
+
+    // Both are too big for the stack
+    auto legacy = std::make_unique<LegacyComponentArray<BenchComponent>>();
+    auto sparse = std::make_unique<ComponentArray<BenchComponent>>();
+
+    fill(*legacy, entities);
+    fill(*sparse, entities);
+
+    report("get/has",
+        time(iterations, [&]() { lookups(*legacy, entities); }),
+        time(iterations, [&]() { lookups(*sparse, entities); }));
+
+    report("remove + insert",
+        time(iterations, [&]() { churn(*legacy, entities); }),
+        time(iterations, [&]() { churn(*sparse, entities); }));
+}
@@ -0,0 +1,179 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/ecs/ComponentArray.h>
+#include <components/Particles2D.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int emitterCount = 1000;
+    // A smoke explosion's worth of particles still alive
+    constexpr int particlesPerEmitter = 64;
+    constexpr int iterations = 20;
+
+    // How ComponentArray removed components before it moved them, kept here for comparison
+    template <typename T>
+    class CopyingComponentArray
+    {
+    private:
+        std::vector<T> mData;
+        std::vector<Entity> mDenseEntities;
+        std::vector<uint32_t> mSparse = std::vector<uint32_t>(emitterCount);
+        size_t mSize = 0;
+
+    public:
+        CopyingComponentArray()
+        {
+            mData.resize(emitterCount);
+        }
+
+        void insert(const Entity entity, const T &component)
+        {
+            mData[mSize] = component;
+            mSparse[entity] = static_cast<uint32_t>(mSize);
+            mDenseEntities.push_back(entity);
+            mSize++;
+        }
+
+        void remove(const Entity entity)
+        {
+            uint32_t indexOfRemovedEntity = mSparse[entity];
+            uint32_t indexLast = static_cast<uint32_t>(mSize - 1);
+            Entity entityLast = mDenseEntities[indexLast];
+
+            mData[indexOfRemovedEntity] = mData[indexLast];
+
+            mSparse[entityLast] = indexOfRemovedEntity;
+            mDenseEntities[indexOfRemovedEntity] = entityLast;
+            mDenseEntities.pop_back();
+            mSize--;
+        }
+    };
+
+    Particles2D makeEmitter()
+    {
+        Particles2D emitter;
+        emitter.particles.resize(particlesPerEmitter);
+        emitter.spritePool.resize(4);
+        return emitter;
+    }
+
+    // Average time of removing every emitter in 'order', leaving out refilling the array between runs
+    template <class Array>
+    float timeRemoval(const std::vector<Entity> &order)
+    {
+        std::chrono::duration<float, std::milli> total{};
+        for (int i = 0; i < iterations; i++)
+        {
+            Array array;
+            for (Entity ent = 0; ent < emitterCount; ent++)
+            {
+                array.insert(ent, makeEmitter());
+            }
+
+            auto timeStart = std::chrono::high_resolution_clock::now();
+            for (Entity ent : order)
+            {
+                array.remove(ent);
+            }
+            total += std::chrono::high_resolution_clock::now() - timeStart;
+        }
+        return total.count() / iterations;
+    }
+
+    // Move-only component that counts how many of it are alive
+    struct Tracked
+    {
+        static inline int live = 0;
+
+        std::unique_ptr<int> value;
+
+        explicit Tracked(int v)
+            : value(std::make_unique<int>(v))
+        {
+            live++;
+        }
+
+        Tracked(Tracked &&other) noexcept
+            : value(std::move(other.value))
+        {
+            live++;
+        }
+
+        Tracked &operator=(Tracked &&other) noexcept = default;
+
+        ~Tracked()
+        {
+            live--;
+        }
+    };
+
+    class MoveScene : public Scene
+    {
+    public:
+        using Scene::destroyEntity;
+    };
+
+    // Every Tracked the scene made has to be gone once its entities are, with the right values surviving along the way
+    bool checkReleasedSlots(Scene::Storage storage)
+    {
+        bool ok = true;
+        {
+            MoveScene scene;
+            scene.setStorage(storage);
+
+            std::vector<Entity> entities;
+            for (int i = 0; i < 100; i++)
+            {
+                Entity ent = scene.createEntity();
+                scene.emplaceComponent<Tracked>(ent, i);
+                entities.push_back(ent);
+            }
+
+            // Every other one, so the survivors get moved around
+            for (size_t i = 0; i < entities.size(); i += 2)
+            {
+                scene.destroyEntity(entities[i]);
+            }
+
+            ok = Tracked::live == 50;
+            for (size_t i = 1; i < entities.size(); i += 2)
+            {
+                ok = ok && *scene.getComponent<Tracked>(entities[i]).value == static_cast<int>(i);
+            }
+        }
+        return ok && Tracked::live == 0;
+    }
+}
+
+void Benchmark::componentMoves()
+{
+    printf("-- Component moves (%d emitters, %d particles each) --\n", emitterCount, particlesPerEmitter);
+
+    bool ok = checkReleasedSlots(Scene::Storage::Sparse) && checkReleasedSlots(Scene::Storage::Archetype);
+    printf("  Released slots %s\n", ok ? "destroyed" : "LEAKED");
+    if (!ok)
+    {
+        failures++;
+    }
+
+    // Finished emitters die in no particular order
+    std::vector<Entity> order(emitterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+
+    report("remove: copy -> move",
+        timeRemoval<CopyingComponentArray<Particles2D>>(order),
+        timeRemoval<ComponentArray<Particles2D>>(order));
+}
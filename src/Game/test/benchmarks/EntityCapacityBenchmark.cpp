@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/components/Transform2D.h>
+#include <engine/components/Animator.h>
+#include <components/Mover2D.h>
+#include <components/CameraController.h>
+
+#include <cstdio>
+#include <memory>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // The entity cap every component array used to reserve a slot per entity for
+    constexpr size_t legacyMaxEntities = 4096;
+
+    constexpr uint32_t manyEntities = 1 << 20;
+    constexpr int iterations = 20;
+
+    // What one component type cost with the old fixed arrays: a component, a dense entity ID and a sparse entry per entity
+    template <typename T>
+    size_t legacyBytes()
+    {
+        return legacyMaxEntities * (sizeof(T) + sizeof(Entity) + sizeof(uint32_t));
+    }
+
+    template <typename T>
+    void reportSingle(Scene &scene, const char *name)
+    {
+        MemoryUsage usage = scene.getComponentMemory(scene.getComponentType<T>());
+        printf("  %-18s legacy %8zu bytes, paged %8zu bytes reserved (%zu live)\n",
+            name, legacyBytes<T>(), usage.reserved, usage.live);
+    }
+}
+
+void Benchmark::entityCapacity()
+{
+    printf("-- Entity capacity --\n");
+
+    // Components only one entity ever has, like the camera controller
+    {
+        auto scene = std::make_unique<Scene>();
+        Entity ent = scene->createEntity();
+        scene->addComponent(ent, Transform2D());
+        scene->addComponent(ent, Animator());
+        scene->addComponent(ent, Mover2D());
+        scene->addComponent(ent, CameraController());
+
+        reportSingle<Transform2D>(*scene, "Transform2D");
+        reportSingle<Animator>(*scene, "Animator");
+        reportSingle<Mover2D>(*scene, "Mover2D");
+        reportSingle<CameraController>(*scene, "CameraController");
+    }
+
+    // Far past the old cap
+    auto scene = std::make_unique<Scene>();
+    scene->setMaxEntities(manyEntities);
+    scene->registerComponent<Transform2D>();
+
+    float createMs = time(1, [&]()
+        {
+            for (uint32_t i = 0; i < manyEntities; i++)
+            {
+                Transform2D transform;
+                transform.pos = Vec2i(static_cast<int>(i % 1024), static_cast<int>(i / 1024));
+                scene->addComponent(scene->createEntity(), transform);
+            }
+        });
+
+    float iterateMs = time(iterations, [&]()
+        {
+            int64_t sum = 0;
+            for (auto [ent, transform] : scene->view<Transform2D>())
+            {
+                sum += transform.pos.x + transform.pos.y;
+            }
+            sink += static_cast<uint64_t>(sum);
+        });
+
+    printf("  %u entities alive (cap %u)\n", scene->getLivingEntityCount(), scene->getMaxEntities());
+    report("create", createMs);
+    report("iterate", iterateMs);
+    printf("%s", scene->getMemoryReport().c_str());
+}
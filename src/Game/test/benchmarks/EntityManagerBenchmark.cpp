@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+
+#include <engine/ecs/EntityManager.h>
+
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int iterations = 200;
+    constexpr int churnCount = 1024;
+    // The fixed entity cap the legacy manager was built around
+    constexpr Entity legacyMaxEntities = 4096;
+
+    // The EntityManager we had before generational handles, kept here for comparison
+    class LegacyEntityManager
+    {
+    private:
+        std::queue<Entity> mAvailableEntries{};
+        std::array<Signature, legacyMaxEntities> mSignatures{};
+        uint32_t mLivingEntityCount = 0;
+
+    public:
+        LegacyEntityManager()
+        {
+            for (Entity entity = 0; entity < legacyMaxEntities; entity++)
+            {
+                mAvailableEntries.push(entity);
+            }
+        }
+
+        Entity createEntity()
+        {
+            Entity id = mAvailableEntries.front();
+            mAvailableEntries.pop();
+            mLivingEntityCount++;
+            return id;
+        }
+
+        void destroyEntity(Entity entity)
+        {
+            mSignatures[entity].reset();
+            mAvailableEntries.push(entity);
+            mLivingEntityCount--;
+        }
+    };
+
+    // Create and destroy a batch of entities, checking liveness the way each one can
+    // (legacy needs a map like UpdateUID's, handles just compare generations)
+    void churnLegacy(LegacyEntityManager &manager, std::unordered_map<uint32_t, Entity> &alive)
+    {
+        uint64_t count = 0;
+        for (uint32_t i = 0; i < churnCount; i++)
+        {
+            alive.insert({ i, manager.createEntity() });
+        }
+        for (uint32_t i = 0; i < churnCount; i++)
+        {
+            count += alive.count(i);
+            manager.destroyEntity(alive.at(i));
+            alive.erase(i);
+        }
+        Benchmark::sink = count;
+    }
+
+    void churnHandles(EntityManager &manager, std::array<EntityHandle, churnCount> &handles)
+    {
+        uint64_t count = 0;
+        for (uint32_t i = 0; i < churnCount; i++)
+        {
+            handles[i] = manager.getHandle(manager.createEntity());
+        }
+        for (uint32_t i = 0; i < churnCount; i++)
+        {
+            count += manager.isAlive(handles[i]);
+            manager.destroyEntity(handles[i].entity);
+        }
+        Benchmark::sink = count;
+    }
+}
+
+void Benchmark::entityManager()
+{
+    printf("-- EntityManager --\n");
+
+    report("construct (scene restart)",
+        time(iterations, []() { auto manager = std::make_unique<LegacyEntityManager>(); Benchmark::sink = manager->createEntity(); }),
+        time(iterations, []() { auto manager = std::make_unique<EntityManager>(); Benchmark::sink = manager->createEntity(); }));
+
+    auto legacy = std::make_unique<LegacyEntityManager>();
+    auto manager = std::make_unique<EntityManager>();
+    std::unordered_map<uint32_t, Entity> alive;
+    std::array<EntityHandle, churnCount> handles;
+
+    report("create + liveness check + destroy",
+        time(iterations, [&]() { churnLegacy(*legacy, alive); }),
+        time(iterations, [&]() { churnHandles(*manager, handles); }));
+}
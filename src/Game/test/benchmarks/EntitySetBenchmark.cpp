@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+
+#include <engine/ecs/EntitySet.h>
+
+#include <cstdio>
+#include <set>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // Roughly what a smoke explosion touches: a burst of particle entities
+    // going in and out of every system's membership list
+    constexpr int systemCount = 17;
+    constexpr int burstSize = 50;
+    constexpr int residentCount = 1024;
+    constexpr int iterations = 500;
+
+    template <class Set>
+    void fill(std::vector<Set> &systems)
+    {
+        for (auto &set : systems)
+        {
+            for (Entity ent = 0; ent < residentCount; ent++)
+            {
+                set.insert(ent);
+            }
+        }
+    }
+
+    template <class Set>
+    void burst(std::vector<Set> &systems)
+    {
+        for (auto &set : systems)
+        {
+            for (Entity ent = residentCount; ent < residentCount + burstSize; ent++)
+            {
+                set.insert(ent);
+            }
+        }
+        for (auto &set : systems)
+        {
+            for (Entity ent = residentCount; ent < residentCount + burstSize; ent++)
+            {
+                set.erase(ent);
+            }
+        }
+    }
+
+    template <class Set>
+    void iterate(std::vector<Set> &systems)
+    {
+        uint64_t sum = 0;
+        for (auto &set : systems)
+        {
+            for (Entity ent : set)
+            {
+                sum += ent;
+            }
+        }
+        Benchmark::sink = sum;
+    }
+}
+
+void Benchmark::entitySet()
+{
+    printf("-- System membership (%d systems, %d entities) --\n", systemCount, residentCount);
+
+    std::vector<std::set<Entity>> trees(systemCount);
+    std::vector<EntitySet> sets(systemCount);
+    fill(trees);
+    fill(sets);
+
+    report("insert + erase burst",
+        time(iterations, [&]() { burst(trees); }),
+        time(iterations, [&]() { burst(sets); }));
+
+    report("iterate",
+        time(iterations, [&]() { iterate(trees); }),
+        time(iterations, [&]() { iterate(sets); }));
+}
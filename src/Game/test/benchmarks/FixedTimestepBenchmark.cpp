@@ -0,0 +1,234 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/Time.h>
+#include <engine/FixedTimestep.h>
+
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <components/Mover2D.h>
+#include <components/Solid.h>
+#include <components/Tilemap.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int moverCount = 400;
+    constexpr int roomSize = 1200;
+    constexpr float tickRate = 60.0f;
+    constexpr int seconds = 4;
+
+    // Movers bounce off the walls
+    class BounceSystem : public System
+    {
+    public:
+        UpdateMoveAndCollide2D *m_updateMoveAndCollide = nullptr;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            if (!m_updateMoveAndCollide)
+            {
+                m_updateMoveAndCollide = m_scene->getSystem<UpdateMoveAndCollide2D>();
+            }
+
+            for (const MoverHit &hit : m_updateMoveAndCollide->m_hits)
+            {
+                Mover2DCommon::bounce(m_scene->getComponent<Mover2D>(hit.ent), hit);
+            }
+        }
+    };
+
+    class RoomScene : public Scene
+    {
+    public:
+        RoomScene()
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Solid>();
+            registerComponent<Tilemap>();
+
+            registerSystem<UpdateMoveAndCollide2D>();
+            registerSystem<BounceSystem>();
+            registerSystem<UpdateSolids>();
+            registerSystem<UpdateTilemap>();
+
+            constexpr int wall = 16;
+            addSolid(Recti(0, 0, roomSize, wall));
+            addSolid(Recti(0, roomSize - wall, roomSize, wall));
+            addSolid(Recti(0, 0, wall, roomSize));
+            addSolid(Recti(roomSize - wall, 0, wall, roomSize));
+
+            std::mt19937 random(41);
+            std::uniform_int_distribution<int> place(wall + 1, roomSize - wall - 20);
+            std::uniform_real_distribution<float> speed(-6.0f, 6.0f);
+            for (int i = 0; i < moverCount; i++)
+            {
+                const Vec2i pos(place(random), place(random));
+                Entity ent = createEntity();
+                Transform2D transform;
+                transform.pos = pos;
+                addComponent(ent, transform);
+                addComponent(ent, Collider2D{ Recti(pos, Vec2i(8, 8)) });
+                Mover2D mover;
+                mover.velocity = Vec2f(speed(random), speed(random));
+                addComponent(ent, mover);
+            }
+        }
+
+        void addSolid(const Recti &rect)
+        {
+            Entity ent = createEntity();
+            Transform2D transform;
+            transform.pos = rect.position();
+            addComponent(ent, transform);
+            addComponent(ent, Collider2D{ rect });
+            addComponent(ent, Solid());
+        }
+
+        void step(float deltaSeconds)
+        {
+            Time::deltaSeconds = deltaSeconds;
+            Time::delta = deltaSeconds / Time::deltaTarget;
+            mSystemManager.update();
+        }
+
+        std::vector<Vec2i> positions()
+        {
+            std::vector<Vec2i> result;
+            for (auto [ent, transform, mover] : view<const Transform2D, const Mover2D>())
+            {
+                result.push_back(transform.pos);
+            }
+            return result;
+        }
+    };
+
+    // Frame lengths in milliseconds adding up to 'seconds', steady or all over the place with the odd hitch
+    std::vector<float> makeFrames(bool jittery)
+    {
+        std::vector<float> frames;
+        std::mt19937 random(43);
+        std::uniform_real_distribution<float> length(4.0f, 30.0f);
+
+        float left = seconds * 1000.0f;
+        while (left > 0.0f)
+        {
+            float frame = 1000.0f / tickRate;
+            if (jittery)
+            {
+                frame = frames.size() % 40 == 39 ? 55.0f : length(random);
+            }
+            frame = std::min(frame, left);
+            frames.push_back(frame);
+            left -= frame;
+        }
+        return frames;
+    }
+
+    struct Run
+    {
+        std::vector<Vec2i> positions;
+        int updates = 0;
+        float worstFrameMs = 0.0f;
+    };
+
+    // Play the frames through a scene, one update a frame with that frame's delta or in fixed ticks
+    Run play(const std::vector<float> &frames, bool fixed)
+    {
+        RoomScene scene;
+        FixedTimestep timestep(tickRate, 4);
+        Run run;
+
+        for (float frame : frames)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            if (fixed)
+            {
+                const int ticks = timestep.advance(frame / 1000.0f);
+                for (int i = 0; i < ticks; i++)
+                {
+                    scene.step(timestep.tickSeconds());
+                }
+                run.updates += ticks;
+            }
+            else
+            {
+                scene.step(frame / 1000.0f);
+                run.updates++;
+            }
+            std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+            run.worstFrameMs = std::max(run.worstFrameMs, duration.count());
+        }
+
+        // Float rounding can leave the last tick a hair short of due, finish it so both runs cover the same ticks
+        if (fixed && timestep.interpolation() > 0.5f)
+        {
+            scene.step(timestep.tickSeconds());
+            run.updates++;
+        }
+
+        run.positions = scene.positions();
+        return run;
+    }
+
+    int countDifferent(const std::vector<Vec2i> &a, const std::vector<Vec2i> &b)
+    {
+        int different = 0;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            different += a[i] != b[i];
+        }
+        return different;
+    }
+}
+
+void Benchmark::fixedTimestep()
+{
+    printf("-- Fixed timestep (%d movers, %ds of steady 60fps vs. jittery frames) --\n", moverCount, seconds);
+
+    const float delta = Time::delta;
+    const float deltaSeconds = Time::deltaSeconds;
+
+    const std::vector<float> steadyFrames = makeFrames(false);
+    const std::vector<float> jitteryFrames = makeFrames(true);
+
+    Run variableSteady = play(steadyFrames, false);
+    Run variableJittery = play(jitteryFrames, false);
+    Run fixedSteady = play(steadyFrames, true);
+    Run fixedJittery = play(jitteryFrames, true);
+
+    // Ticks don't make frames cheaper, but a frame can never cost more than maxTicksPerFrame of them
+    printf("  Worst jittery frame: %.4f ms with frame delta, %.4f ms in ticks\n", variableJittery.worstFrameMs, fixedJittery.worstFrameMs);
+    printf("  Updates: %d steady, %d jittery with frame delta; %d and %d ticks\n",
+        variableSteady.updates, variableJittery.updates, fixedSteady.updates, fixedJittery.updates);
+    printf("  Frame delta: %d of %d movers end up somewhere else when the frame rate changes\n",
+        countDifferent(variableSteady.positions, variableJittery.positions), moverCount);
+
+    // Same ticks have to give the same result, however the frames were cut up
+    bool match = fixedSteady.updates == fixedJittery.updates && fixedSteady.positions == fixedJittery.positions;
+    printf("  Ticks: positions %s\n", match ? "match" : "DON'T MATCH");
+    if (!match)
+    {
+        failures++;
+    }
+
+    Time::delta = delta;
+    Time::deltaSeconds = deltaSeconds;
+}
@@ -0,0 +1,182 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/FrameArena.h>
+#include <engine/ThreadPool.h>
+#include <engine/components/Transform2D.h>
+#include <components/Mover2D.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int entityCount = 1000;
+    // Entities destroyed and respawned every frame
+    constexpr int churnCount = 20;
+    // Freed entity IDs are only reused once enough are waiting, so membership tables
+    // keep growing until then
+    constexpr int warmupFrames = 200;
+    constexpr int frames = 300;
+
+    class MoveSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Transform2D>());
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::Update, sig);
+
+            setupAccess(Signature(), sig);
+        }
+
+        void update() override
+        {
+            for (auto [ent, transform, mover] : m_scene->view<Transform2D, Mover2D>())
+            {
+                mover.remainder += mover.velocity;
+                Vec2i toMove = Vec2i(static_cast<int>(mover.remainder.x), static_cast<int>(mover.remainder.y));
+                mover.remainder -= toMove;
+                transform.pos += toMove;
+            }
+        }
+    };
+
+    using MoverPrefab = Prefab<Transform2D, Mover2D>;
+
+    // Destroys a few entities and spawns replacements, like effects coming and going
+    // Only makes queued changes, so it runs alongside MoveSystem in the parallel scene.
+    class ChurnSystem : public System
+    {
+    public:
+        int m_frame = 0;
+        MoverPrefab m_prefab;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(1, Type::Update, sig);
+
+            setupAccess(Signature(), Signature());
+            m_prefab.get<Mover2D>().velocity = Vec2f(0.5f, -0.25f);
+        }
+
+        void update() override
+        {
+            m_frame++;
+            for (int i = 0; i < churnCount; i++)
+            {
+                m_scene->queueDestroy(m_entities[(m_frame * churnCount + i) % m_entities.size()]);
+
+                m_scene->queueSpawn(m_prefab, [&](Entity, MoverPrefab &mover)
+                    {
+                        mover.get<Transform2D>().pos = Vec2i(i * 16, m_frame % 480);
+                    });
+            }
+        }
+    };
+
+    // Same shape as UpdateAndDrawAnimator's depth sort plus a line of HUD text
+    class SortSystem : public System
+    {
+    public:
+        struct Entry
+        {
+            const Transform2D *transform = nullptr;
+        };
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Transform2D>());
+            setup(0, Type::Draw, sig);
+        }
+
+        void update() override
+        {
+            std::pmr::vector<Entry> sorted(&m_scene->frameArena());
+            sorted.reserve(m_entities.size());
+
+            for (auto [ent, transform] : m_scene->view<const Transform2D>())
+            {
+                sorted.push_back({ &transform });
+            }
+
+            std::sort(sorted.begin(), sorted.end(), [](const Entry &ls, const Entry &rs)
+                { return ls.transform->pos.y < rs.transform->pos.y; });
+
+            const char *text = m_scene->frameArena().format("Entities: %zu, first: %d", sorted.size(), sorted.front().transform->pos.y);
+            Benchmark::sink += static_cast<uint64_t>(text[0]);
+        }
+    };
+
+    class FrameScene : public Scene
+    {
+    public:
+        using Scene::beginFrame;
+
+        FrameArena m_arena;
+
+        FrameScene(ThreadPool *pool)
+        {
+            setFrameArena(&m_arena);
+            setThreadPool(pool);
+
+            registerComponent<Transform2D>();
+            registerComponent<Mover2D>();
+
+            registerSystem<MoveSystem>();
+            registerSystem<ChurnSystem>();
+            registerSystem<SortSystem>();
+
+            for (int i = 0; i < entityCount; i++)
+            {
+                Entity ent = createEntity();
+                addComponent(ent, Transform2D());
+                addComponent(ent, Mover2D());
+            }
+        }
+
+        // What Game::update and Game::draw do
+        void frame()
+        {
+            m_arena.reset();
+            beginFrame();
+            mSystemManager.update();
+            mSystemManager.draw();
+        }
+    };
+}
+
+void Benchmark::frameAllocations()
+{
+    printf("-- Frame allocations (%d entities, %d respawned per frame) --\n", entityCount, churnCount);
+
+    ThreadPool pool;
+    auto serial = std::make_unique<FrameScene>(nullptr);
+    auto parallel = std::make_unique<FrameScene>(&pool);
+
+    expectNoAllocations("serial frame", warmupFrames, frames, [&]() { serial->frame(); });
+    expectNoAllocations("parallel frame", warmupFrames, frames, [&]() { parallel->frame(); });
+
+    // Every destroyed entity was replaced, including by ChurnSystem running in parallel
+    const bool respawned = serial->getSystemEntities<MoveSystem>()->size() == entityCount &&
+                           parallel->getSystemEntities<MoveSystem>()->size() == entityCount &&
+                           parallel->getLivingEntityCount() == entityCount;
+    printf("  Spawning from a system that declares its access: %s\n", respawned ? "ok" : "FAIL");
+    if (!respawned)
+    {
+        failures++;
+    }
+
+    report("frame", time(frames, [&]() { serial->frame(); }));
+    printf("  Frame arena peak: %zu bytes\n", serial->m_arena.peak());
+}
@@ -0,0 +1,220 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/EventBuffer.h>
+
+#include <engine/components/Collider2D.h>
+#include <components/Collisions.h>
+#include <components/Mover2D.h>
+
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // A level full of things that never move (walls, hooks, coins on the floor) with a few hundred that do
+    constexpr int staticCount = 3000;
+    constexpr int moverCount = 300;
+    constexpr int levelSize = 2400;
+    constexpr int frames = 30;
+
+    constexpr int copyCount = 5000;
+    constexpr int hitCount = 2000;
+
+    // Movers wander a little every frame, nothing else is touched
+    class WanderSystem : public System
+    {
+    public:
+        std::mt19937 m_random{ 23 };
+        std::vector<Entity> m_movers;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Collider2D>());
+            setup(0, Type::PreUpdate, sig);
+        }
+
+        void update() override
+        {
+            std::uniform_int_distribution<int> step(-3, 3);
+            for (Entity ent : m_movers)
+            {
+                Collider2D &collider = m_scene->getComponent<Collider2D>(ent);
+                collider.rect.x += step(m_random);
+                collider.rect.y += step(m_random);
+            }
+        }
+    };
+
+    class LevelScene : public Scene
+    {
+    public:
+        explicit LevelScene(UpdateCollisions::PassMode mode)
+        {
+            registerComponent<Collider2D>();
+
+            registerSystem<WanderSystem>();
+            registerSystem<UpdateCollisions>();
+            getSystem<UpdateCollisions>()->m_passMode = mode;
+
+            std::mt19937 random(31);
+            std::uniform_int_distribution<int> place(0, levelSize);
+            std::uniform_int_distribution<int> size(8, 40);
+
+            for (int i = 0; i < staticCount; i++)
+            {
+                add(Recti(place(random), place(random), size(random), size(random)));
+            }
+            for (int i = 0; i < moverCount; i++)
+            {
+                getSystem<WanderSystem>()->m_movers.push_back(add(Recti(place(random), place(random), 24, 24)));
+            }
+        }
+
+        Entity add(const Recti &rect)
+        {
+            Entity ent = createEntity();
+            addComponent(ent, Collider2D{ rect });
+            return ent;
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+
+        UpdateCollisions *collisions()
+        {
+            return getSystem<UpdateCollisions>();
+        }
+    };
+
+    bool sameEvents(const EventBuffer<CollisionEvent> &a, const EventBuffer<CollisionEvent> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].type != b[i].type || a[i].ent != b[i].ent || a[i].other != b[i].other)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // What Mover2D used to look like, with a callback per axis to find out it hit something
+    struct CallbackMover
+    {
+        Vec2f remainder;
+        Vec2f velocity;
+        Vec2f velocityBeforeCollision;
+
+        std::function<void(Entity ent)> onCollideX;
+        std::function<void(Entity ent)> onCollideY;
+    };
+}
+
+void Benchmark::pairCache()
+{
+    printf("-- Overlap pair cache (%d static colliders, %d moving, %d frames) --\n", staticCount, moverCount, frames);
+
+    // Each mode times its own frames, then both run the same frames side by side to compare events
+    {
+        LevelScene full(UpdateCollisions::PassMode::Full);
+        LevelScene incremental(UpdateCollisions::PassMode::Incremental);
+
+        // The first pass tests everything either way
+        full.step();
+        incremental.step();
+
+        float fullMs = time(frames, [&]() { full.step(); });
+        float incrementalMs = time(frames, [&]() { incremental.step(); });
+        report("test every pair -> keep unchanged pairs", fullMs, incrementalMs);
+    }
+
+    LevelScene full(UpdateCollisions::PassMode::Full);
+    LevelScene incremental(UpdateCollisions::PassMode::Incremental);
+
+    bool match = true;
+    int entered = 0;
+    int exited = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        full.step();
+        incremental.step();
+        match = match && sameEvents(full.collisions()->m_events, incremental.collisions()->m_events);
+
+        for (const CollisionEvent &event : incremental.collisions()->m_events)
+        {
+            entered += event.type == CollisionEvent::Type::Enter;
+            exited += event.type == CollisionEvent::Type::Exit;
+        }
+    }
+
+    printf("%s", incremental.collisions()->report().c_str());
+    printf("  Events %s (%d enters, %d exits)\n", match ? "match" : "DON'T MATCH", entered, exited);
+    if (!match)
+    {
+        failures++;
+    }
+
+    // Movers get copied whenever they're spawned from a prefab, snapshotted or moved between slots.
+    // With callbacks each copy also copies two std::functions, and allocates if they captured much.
+    {
+        struct Captures
+        {
+            void *pointers[9] = {};
+        } captures;
+
+        std::vector<CallbackMover> callbackMovers(copyCount);
+        for (CallbackMover &mover : callbackMovers)
+        {
+            // Like the player's reeling callback, which captured the system and the whole PlayerEntity
+            mover.onCollideX = [captures](Entity) { sink = sink + reinterpret_cast<uintptr_t>(captures.pointers[0]); };
+            mover.onCollideY = mover.onCollideX;
+        }
+        std::vector<Mover2D> movers(copyCount);
+
+        float callbackMs = time(frames, [&]()
+            {
+                std::vector<CallbackMover> copy = callbackMovers;
+                sink = sink + copy.size();
+            });
+        float plainMs = time(frames, [&]()
+            {
+                std::vector<Mover2D> copy = movers;
+                sink = sink + copy.size();
+            });
+        report("copy movers with callbacks -> hit buffer", callbackMs, plainMs);
+        printf("  Mover2D %d -> %d bytes\n", static_cast<int>(sizeof(CallbackMover)), static_cast<int>(sizeof(Mover2D)));
+
+        // Once the buffer has grown to fit a frame's hits, emitting and reading them never allocates
+        EventBuffer<MoverHit> hits;
+        std::vector<Vec2f> velocities(moverCount, Vec2f(1.0f, 1.0f));
+        expectNoAllocations("hit buffer", 1, frames, [&]()
+            {
+                hits.clear();
+                for (int i = 0; i < hitCount; i++)
+                {
+                    hits.push(MoverHit{ static_cast<Entity>(i % moverCount), NULL_ENTITY, (i & 1) ? Vec2i(0, 1) : Vec2i(1, 0), Vec2f(1.0f, 1.0f) });
+                }
+
+                for (const MoverHit &hit : hits)
+                {
+                    Mover2D mover;
+                    mover.velocity = velocities[hit.ent];
+                    Mover2DCommon::bounce(mover, hit);
+                    velocities[hit.ent] = mover.velocity;
+                }
+            });
+    }
+}
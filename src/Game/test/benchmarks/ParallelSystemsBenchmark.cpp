@@ -0,0 +1,219 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/ThreadPool.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int entityCount = 4000;
+    constexpr int frames = 60;
+    // Math per entity per system, enough that a system costs about as much as a heavy gameplay one
+    constexpr int workPerEntity = 48;
+
+    template <int N>
+    struct Work
+    {
+        float value = 0.0f;
+    };
+
+    // Marker added and removed by ChurnSystem through queued commands
+    struct Tagged
+    {
+        int frame = 0;
+    };
+
+    template <int N>
+    void doWork(Work<N> &work)
+    {
+        float value = work.value;
+        for (int i = 0; i < workPerEntity; i++)
+        {
+            value = value * 0.999f + std::sin(value + static_cast<float>(N));
+        }
+        work.value = value;
+    }
+
+    // Independent of each other, these can all run at once
+    template <int N>
+    class WorkSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Work<N>>());
+            setup(0, Type::Update, sig);
+
+            setupAccess(Signature(), sig);
+        }
+
+        void update() override
+        {
+            for (auto [ent, work] : m_scene->view<Work<N>>())
+            {
+                doWork(work);
+            }
+        }
+    };
+
+    // Reads what two WorkSystems write, so it has to wait for both
+    class CombineSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature reads;
+            reads.set(m_scene->getComponentType<Work<0>>());
+            reads.set(m_scene->getComponentType<Work<1>>());
+
+            Signature writes;
+            writes.set(m_scene->getComponentType<Work<4>>());
+
+            setup(0, Type::Update, reads | writes);
+            setupAccess(reads, writes);
+        }
+
+        void update() override
+        {
+            for (auto [ent, a, b, out] : m_scene->view<const Work<0>, const Work<1>, Work<4>>())
+            {
+                out.value += a.value * 0.5f + b.value * 0.25f;
+                doWork(out);
+            }
+        }
+    };
+
+    // Queues structural changes while running alongside the others
+    class ChurnSystem : public System
+    {
+    public:
+        int m_frame = 0;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Work<2>>());
+            setup(0, Type::Update, sig);
+
+            Signature reads = sig;
+            reads.set(m_scene->getComponentType<Tagged>());
+            setupAccess(reads, Signature());
+        }
+
+        void update() override
+        {
+            m_frame++;
+            for (auto [ent, work] : m_scene->view<const Work<2>>())
+            {
+                if (ent % 7 != static_cast<Entity>(m_frame % 7))
+                {
+                    continue;
+                }
+
+                if (m_scene->hasComponent<Tagged>(ent))
+                {
+                    m_scene->queueRemoveComponent<Tagged>(ent);
+                }
+                else
+                {
+                    m_scene->queueAddComponent(ent, Tagged{ m_frame });
+                }
+            }
+        }
+    };
+
+    class ParallelScene : public Scene
+    {
+    public:
+        using Scene::beginFrame;
+
+        ParallelScene(ThreadPool *pool, bool parallel)
+        {
+            setThreadPool(pool);
+            setParallelSystems(parallel);
+
+            registerComponent<Work<0>>();
+            registerComponent<Work<1>>();
+            registerComponent<Work<2>>();
+            registerComponent<Work<3>>();
+            registerComponent<Work<4>>();
+            registerComponent<Tagged>();
+
+            registerSystem<WorkSystem<0>>();
+            registerSystem<WorkSystem<1>>();
+            registerSystem<CombineSystem>();
+            registerSystem<WorkSystem<2>>();
+            registerSystem<ChurnSystem>();
+            registerSystem<WorkSystem<3>>();
+
+            for (int i = 0; i < entityCount; i++)
+            {
+                Entity ent = createEntity();
+                float seed = static_cast<float>(i) * 0.01f;
+                addComponent(ent, Work<0>{ seed });
+                addComponent(ent, Work<1>{ seed + 1.0f });
+                addComponent(ent, Work<2>{ seed + 2.0f });
+                addComponent(ent, Work<3>{ seed + 3.0f });
+                if (i % 2 == 0)
+                {
+                    addComponent(ent, Work<4>{ seed + 4.0f });
+                }
+            }
+        }
+
+        void frame()
+        {
+            beginFrame();
+            mSystemManager.update();
+        }
+
+        // Everything the systems wrote, for comparing runs bit for bit
+        uint64_t checksum()
+        {
+            uint64_t sum = 0;
+            auto mix = [&sum](uint64_t value) { sum = sum * 1099511628211ull + value; };
+            auto bits = [](float value) { uint32_t out; std::memcpy(&out, &value, sizeof(out)); return out; };
+
+            for (Entity ent = 0; ent < entityCount; ent++)
+            {
+                mix(bits(getComponent<Work<0>>(ent).value));
+                mix(bits(getComponent<Work<1>>(ent).value));
+                mix(bits(getComponent<Work<2>>(ent).value));
+                mix(bits(getComponent<Work<3>>(ent).value));
+                mix(hasComponent<Work<4>>(ent) ? bits(getComponent<Work<4>>(ent).value) : 0);
+                mix(hasComponent<Tagged>(ent) ? static_cast<uint64_t>(getComponent<Tagged>(ent).frame) : 0);
+            }
+            return sum;
+        }
+    };
+
+    // Run every frame, returns the average frame time
+    float run(ParallelScene &scene)
+    {
+        return Benchmark::time(frames, [&]() { scene.frame(); });
+    }
+}
+
+void Benchmark::parallelSystems()
+{
+    ThreadPool pool;
+    printf("-- Parallel systems (%d entities, 6 systems, %zu worker threads) --\n", entityCount, pool.threadCount());
+
+    auto serial = std::make_unique<ParallelScene>(&pool, false);
+    auto parallel = std::make_unique<ParallelScene>(&pool, true);
+
+    float serialMs = run(*serial);
+    float parallelMs = run(*parallel);
+    report("serial -> parallel update", serialMs, parallelMs);
+
+    printf("  Results %s\n", serial->checksum() == parallel->checksum() ? "match" : "DIFFER");
+    printf("%s", parallel->getPhaseReport().c_str());
+}
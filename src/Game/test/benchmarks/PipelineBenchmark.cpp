@@ -0,0 +1,162 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/FrameArena.h>
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // About what a room of GameScene has alive
+    constexpr int entityCount = 64;
+    constexpr int iterations = 20000;
+
+    struct Counter
+    {
+        int value = 0;
+    };
+
+    // Order systems ran in during the last frame
+    std::vector<int> gRunOrder;
+
+    // A small gameplay system, a few entities and not much to do with each
+    template <int N, System::Type PhaseType, int Priority>
+    class CountSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Counter>());
+            setup(Priority, PhaseType, sig);
+        }
+
+        void update() override
+        {
+            gRunOrder.push_back(N);
+            for (auto [ent, counter] : m_scene->view<Counter>())
+            {
+                counter.value += N;
+            }
+        }
+    };
+
+    template <int N>
+    using UpdateSystem = CountSystem<N, System::Type::Update, 0>;
+
+    // In update order, DynamicScene registers the same systems out of order and lets priorities sort them
+    using CountPipeline = SystemPipeline<
+        Phase<System::Type::PreUpdate, CountSystem<0, System::Type::PreUpdate, 0>>,
+        Phase<System::Type::Update,
+            UpdateSystem<1>, UpdateSystem<2>, UpdateSystem<3>, UpdateSystem<4>, UpdateSystem<5>, UpdateSystem<6>,
+            UpdateSystem<7>, UpdateSystem<8>, UpdateSystem<9>, UpdateSystem<10>, UpdateSystem<11>>,
+        Phase<System::Type::Draw,
+            CountSystem<12, System::Type::Draw, -1>,
+            CountSystem<13, System::Type::Draw, 0>,
+            CountSystem<14, System::Type::Draw, 5>,
+            CountSystem<15, System::Type::Draw, 20>>>;
+
+    template <class Base>
+    class CountScene : public Base
+    {
+    public:
+        FrameArena m_arena;
+
+        void populate()
+        {
+            this->setFrameArena(&m_arena);
+
+            for (int i = 0; i < entityCount; i++)
+            {
+                Entity ent = this->createEntity();
+                this->addComponent(ent, Counter());
+            }
+        }
+
+        // What Game::update and Game::draw do
+        void step()
+        {
+            m_arena.reset();
+            this->beginFrame();
+            gRunOrder.clear();
+            this->updateSystems();
+            this->drawSystems();
+        }
+
+        int total()
+        {
+            int sum = 0;
+            for (auto [ent, counter] : this->template view<const Counter>())
+            {
+                sum += counter.value;
+            }
+            return sum;
+        }
+    };
+
+    class DynamicScene : public CountScene<Scene>
+    {
+    public:
+        DynamicScene()
+        {
+            registerComponent<Counter>();
+
+            // Backwards, so the update lists have to sort them
+            registerSystem<CountSystem<15, System::Type::Draw, 20>>();
+            registerSystem<CountSystem<14, System::Type::Draw, 5>>();
+            registerSystem<CountSystem<13, System::Type::Draw, 0>>();
+            registerSystem<CountSystem<12, System::Type::Draw, -1>>();
+            registerSystem<CountSystem<0, System::Type::PreUpdate, 0>>();
+            registerUpdateSystems(std::make_integer_sequence<int, 12>());
+
+            populate();
+        }
+
+        template <int... N>
+        void registerUpdateSystems(std::integer_sequence<int, 0, N...>)
+        {
+            (registerSystem<UpdateSystem<N>>(), ...);
+        }
+    };
+
+    class StaticScene : public CountScene<PipelineScene<CountPipeline>>
+    {
+    public:
+        StaticScene()
+        {
+            registerComponent<Counter>();
+            registerPipeline();
+
+            populate();
+        }
+    };
+}
+
+void Benchmark::pipeline()
+{
+    printf("-- System pipeline (16 systems, %d entities) --\n", entityCount);
+
+    DynamicScene dynamicScene;
+    StaticScene staticScene;
+
+    dynamicScene.step();
+    std::vector<int> dynamicOrder = gRunOrder;
+    staticScene.step();
+
+    // Same systems in the same order, doing the same work
+    bool match = gRunOrder == dynamicOrder && dynamicScene.total() == staticScene.total();
+    printf("  Update order %s\n", match ? "matches" : "DOESN'T MATCH");
+    if (!match)
+    {
+        failures++;
+    }
+
+    float dynamicMs = time(iterations, [&]() { dynamicScene.step(); });
+    float staticMs = time(iterations, [&]() { staticScene.step(); });
+    report("update lists -> static pipeline", dynamicMs, staticMs);
+}
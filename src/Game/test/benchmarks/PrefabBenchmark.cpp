@@ -0,0 +1,190 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <engine/components/Animator.h>
+#include <components/Mover2D.h>
+
+#include <cstdio>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // An enemy wave or a big explosion in one frame
+    constexpr int spawnCount = 500;
+    constexpr int iterations = 100;
+    // About as many systems as GameScene has
+    constexpr int systemCount = 16;
+
+    using MoverPrefab = Prefab<Transform2D, Collider2D, Mover2D, Animator>;
+
+    // Systems that only exist to have entities join them
+    template <int N>
+    class MembershipSystem : public System
+    {
+    public:
+        void init() override
+        {
+            setup(0, Type::Update, Signature());
+        }
+    };
+
+    class PrefabScene : public Scene
+    {
+    public:
+        using Scene::destroyEntity;
+
+        explicit PrefabScene(Storage storage)
+        {
+            setStorage(storage);
+
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Animator>();
+
+            // A spread of signatures, like the gameplay systems
+            Signature transform;
+            transform.set(getComponentType<Transform2D>());
+
+            Signature mover = transform;
+            mover.set(getComponentType<Mover2D>());
+
+            Signature collider = mover;
+            collider.set(getComponentType<Collider2D>());
+
+            Signature animator = transform;
+            animator.set(getComponentType<Animator>());
+
+            registerSystems(std::make_integer_sequence<int, systemCount>(), { transform, mover, collider, animator });
+        }
+
+        // Register systemCount systems, cycling through the signatures
+        template <int... N>
+        void registerSystems(std::integer_sequence<int, N...>, const std::array<Signature, 4> &signatures)
+        {
+            (registerSystem<MembershipSystem<N>>(), ...);
+            (setSystemSignature<MembershipSystem<N>>(signatures[N % signatures.size()]), ...);
+        }
+
+        // Entities across every system's list
+        template <int... N>
+        size_t membershipTotal(std::integer_sequence<int, N...>)
+        {
+            return (getSystemEntities<MembershipSystem<N>>()->size() + ...);
+        }
+
+        size_t membershipTotal()
+        {
+            return membershipTotal(std::make_integer_sequence<int, systemCount>());
+        }
+
+        void destroyAll()
+        {
+            std::vector<Entity> entities;
+            for (Entity ent : *getSystemEntities<MembershipSystem<0>>())
+            {
+                entities.push_back(ent);
+            }
+            for (Entity ent : entities)
+            {
+                destroyEntity(ent);
+            }
+        }
+    };
+
+    void spawnAddComponent(PrefabScene *scene)
+    {
+        for (int i = 0; i < spawnCount; i++)
+        {
+            Entity ent = scene->createEntity();
+
+            Transform2D transform;
+            transform.pos = Vec2i(i, 0);
+            scene->addComponent(ent, transform);
+            scene->addComponent(ent, Collider2D());
+            scene->addComponent(ent, Mover2D());
+            scene->addComponent(ent, Animator());
+        }
+    }
+
+    void spawnPrefab(PrefabScene *scene, const MoverPrefab &prefab)
+    {
+        for (int i = 0; i < spawnCount; i++)
+        {
+            scene->spawn(prefab, [i](Entity, MoverPrefab &mover) { mover.get<Transform2D>().pos = Vec2i(i, 0); });
+        }
+    }
+
+    void spawnBulk(PrefabScene *scene, const MoverPrefab &prefab)
+    {
+        scene->spawn(prefab, spawnCount, [](Entity, size_t i, MoverPrefab &mover)
+            { mover.get<Transform2D>().pos = Vec2i(static_cast<int>(i), 0); });
+    }
+
+    // Average time of 'spawn' in milliseconds, leaving out destroying everything between runs
+    template <class F>
+    float timeSpawn(PrefabScene *scene, F &&spawn)
+    {
+        std::chrono::duration<float, std::milli> total{};
+        for (int i = 0; i < iterations; i++)
+        {
+            auto timeStart = std::chrono::high_resolution_clock::now();
+            spawn();
+            total += std::chrono::high_resolution_clock::now() - timeStart;
+
+            scene->destroyAll();
+        }
+        return total.count() / iterations;
+    }
+
+    void compare(const char *name, Scene::Storage storage)
+    {
+        printf("  %s storage\n", name);
+
+        auto scene = std::make_unique<PrefabScene>(storage);
+        const MoverPrefab prefab;
+
+        // Every way of spawning has to end up with the same system membership
+        spawnAddComponent(scene.get());
+        const size_t expected = scene->membershipTotal();
+        scene->destroyAll();
+
+        spawnPrefab(scene.get(), prefab);
+        bool match = scene->membershipTotal() == expected;
+        scene->destroyAll();
+
+        spawnBulk(scene.get(), prefab);
+        match = match && scene->membershipTotal() == expected;
+        scene->destroyAll();
+
+        printf("  System membership %s\n", match ? "matches" : "DOESN'T MATCH");
+        if (!match)
+        {
+            Benchmark::failures++;
+        }
+
+        float addComponentMs = timeSpawn(scene.get(), [&]() { spawnAddComponent(scene.get()); });
+        float prefabMs = timeSpawn(scene.get(), [&]() { spawnPrefab(scene.get(), prefab); });
+        float bulkMs = timeSpawn(scene.get(), [&]() { spawnBulk(scene.get(), prefab); });
+
+        Benchmark::report("addComponent -> spawn(prefab)", addComponentMs, prefabMs);
+        Benchmark::report("addComponent -> spawn(prefab, count)", addComponentMs, bulkMs);
+    }
+}
+
+void Benchmark::prefabs()
+{
+    printf("-- Prefabs (%d entities, 4 components each, %d systems) --\n", spawnCount, systemCount);
+
+    compare("Sparse", Scene::Storage::Sparse);
+    compare("Archetype", Scene::Storage::Archetype);
+}
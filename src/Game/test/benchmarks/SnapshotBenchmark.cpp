@@ -0,0 +1,125 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <engine/components/Animator.h>
+#include <components/Mover2D.h>
+
+#include <cstdio>
+#include <memory>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int entityCount = 1000;
+    constexpr int iterations = 50;
+
+    class MoveSystem : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Transform2D>());
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::Update, sig);
+        }
+
+        void update() override
+        {
+            for (auto [ent, transform, mover] : m_scene->view<Transform2D, Mover2D>())
+            {
+                transform.pos += Vec2i(static_cast<int>(mover.velocity.x), static_cast<int>(mover.velocity.y));
+            }
+        }
+    };
+
+    // Roughly what GameScene's init does: register everything, then spawn through addComponent
+    class SnapshotScene : public Scene
+    {
+    public:
+        SnapshotScene()
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Animator>();
+
+            registerSystem<MoveSystem>();
+
+            for (int i = 0; i < entityCount; i++)
+            {
+                Entity ent = createEntity();
+
+                Transform2D transform;
+                transform.pos = Vec2i(i % 64, i / 64);
+                addComponent(ent, transform);
+
+                Collider2D collider;
+                collider.rect = Recti(transform.pos, Vec2i(8, 8));
+                addComponent(ent, collider);
+
+                Mover2D mover;
+                mover.velocity = Vec2f(1.0f, static_cast<float>(i % 3));
+                addComponent(ent, mover);
+
+                if (i % 3 == 0)
+                {
+                    addComponent(ent, Animator());
+                }
+            }
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+
+        uint64_t checksum()
+        {
+            uint64_t sum = getLivingEntityCount();
+            for (auto [ent, transform] : view<Transform2D>())
+            {
+                sum = sum * 31 + static_cast<uint64_t>(ent) * 7 + static_cast<uint64_t>(transform.pos.x * 1000 + transform.pos.y);
+            }
+            return sum + getSystemEntities<MoveSystem>()->size();
+        }
+    };
+}
+
+void Benchmark::snapshot()
+{
+    printf("-- Scene snapshot (%d entities) --\n", entityCount);
+
+    auto scene = std::make_unique<SnapshotScene>();
+    Snapshot snapshot;
+
+    float snapshotMs = time(iterations, [&]() { scene->snapshot(snapshot); });
+    const uint64_t expected = scene->checksum();
+
+    // Move everything and churn a few entities, then go back
+    for (int i = 0; i < 10; i++)
+    {
+        scene->step();
+    }
+    scene->queueDestroy(0);
+    scene->queueDestroy(1);
+    scene->addComponent(scene->createEntity(), Transform2D());
+    scene->step();
+
+    scene->restore(snapshot);
+    printf("  Restored state %s\n", scene->checksum() == expected ? "matches" : "DOESN'T MATCH");
+    if (scene->checksum() != expected)
+    {
+        failures++;
+    }
+
+    report("rebuild -> restore",
+        time(iterations, [&]() { sink += SnapshotScene().checksum(); }),
+        time(iterations, [&]() { scene->restore(snapshot); }));
+    report("snapshot", snapshotMs);
+    printf("  Snapshot size: %zu bytes\n", snapshot.size());
+}
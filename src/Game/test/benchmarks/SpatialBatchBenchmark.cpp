@@ -0,0 +1,168 @@
+#include "Benchmark.h"
+
+#include <engine/SpatialBatch.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    constexpr int rectCount = 4096;
+    constexpr int queryCount = 256;
+    constexpr int iterations = 20;
+
+    // What the game loops do today, one rect at a time into the same kind of mask
+    template <class F>
+    void scalarMask(size_t count, std::vector<uint64_t> &mask, F &&test)
+    {
+        mask.assign(SpatialBatch::maskWords(count), 0);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (test(i))
+            {
+                mask[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+    }
+}
+
+void Benchmark::spatialBatch()
+{
+    printf("-- Batched rect and line tests (%d rects, %d queries, %d lanes) --\n", rectCount, queryCount, SpatialBatch::NativeLanes::width);
+
+    std::mt19937 random(23);
+    std::uniform_int_distribution<int> pos(0, 1900);
+    std::uniform_int_distribution<int> size(4, 64);
+
+    std::vector<Recti> rects;
+    RectBatch batch;
+    for (int i = 0; i < rectCount; i++)
+    {
+        Recti rect(pos(random), pos(random), size(random), size(random));
+        rects.push_back(rect);
+        batch.push(rect);
+    }
+
+    std::vector<Recti> queries;
+    std::vector<Linei> lines;
+    for (int i = 0; i < queryCount; i++)
+    {
+        queries.push_back(Recti(pos(random), pos(random), size(random), size(random)));
+        const Vec2i start(pos(random), pos(random));
+        lines.push_back(Linei(start, start + Vec2i(size(random) * 4 - 128, size(random) * 4 - 128)));
+    }
+
+    std::vector<uint64_t> scalar;
+    std::vector<uint64_t> batched;
+    bool match = true;
+
+    // Rect overlaps
+    {
+        float scalarMs = time(iterations, [&]()
+            {
+                for (const Recti &query : queries)
+                {
+                    scalarMask(rects.size(), scalar, [&](size_t i) { return query.overlaps(rects[i]); });
+                    sink += scalar[0];
+                }
+            });
+        float batchMs = time(iterations, [&]()
+            {
+                for (const Recti &query : queries)
+                {
+                    SpatialBatch::overlaps(query, batch, batched);
+                    sink += batched[0];
+                }
+            });
+        report("Rect::overlaps -> batched", scalarMs, batchMs);
+
+        for (const Recti &query : queries)
+        {
+            scalarMask(rects.size(), scalar, [&](size_t i) { return query.overlaps(rects[i]); });
+            SpatialBatch::overlaps(query, batch, batched);
+            match = match && scalar == batched;
+        }
+    }
+
+    // Line against rects
+    {
+        float scalarMs = time(iterations, [&]()
+            {
+                for (const Linei &line : lines)
+                {
+                    scalarMask(rects.size(), scalar, [&](size_t i) { return line.intersects(rects[i]); });
+                    sink += scalar[0];
+                }
+            });
+        float batchMs = time(iterations, [&]()
+            {
+                for (const Linei &line : lines)
+                {
+                    SpatialBatch::intersects(line, batch, batched);
+                    sink += batched[0];
+                }
+            });
+        report("Line::intersects(Rect) -> batched", scalarMs, batchMs);
+
+        for (const Linei &line : lines)
+        {
+            scalarMask(rects.size(), scalar, [&](size_t i) { return line.intersects(rects[i]); });
+            SpatialBatch::intersects(line, batch, batched);
+            match = match && scalar == batched;
+        }
+    }
+
+    // Closest hit, the way the grapple picks its target
+    {
+        auto closestScalar = [&](const Linei &line)
+        {
+            int closest = -1;
+            float closestLength = -1;
+            for (size_t i = 0; i < rects.size(); i++)
+            {
+                Vec2i point;
+                if (line.intersectsClosest(line.a, rects[i], &point))
+                {
+                    float length = (line.a - point).lengthSquared();
+                    if (closestLength < 0 || length < closestLength)
+                    {
+                        closestLength = length;
+                        closest = static_cast<int>(i);
+                    }
+                }
+            }
+            return closest;
+        };
+
+        float scalarMs = time(iterations, [&]()
+            {
+                for (const Linei &line : lines)
+                {
+                    sink += closestScalar(line);
+                }
+            });
+        float batchMs = time(iterations, [&]()
+            {
+                for (const Linei &line : lines)
+                {
+                    sink += SpatialBatch::intersectsClosest(line, line.a, batch, batched);
+                }
+            });
+        report("Line::intersectsClosest -> batched", scalarMs, batchMs);
+
+        for (const Linei &line : lines)
+        {
+            match = match && closestScalar(line) == SpatialBatch::intersectsClosest(line, line.a, batch, batched);
+        }
+    }
+
+    printf("  Results %s\n", match ? "match" : "DON'T MATCH");
+    if (!match)
+    {
+        failures++;
+    }
+}
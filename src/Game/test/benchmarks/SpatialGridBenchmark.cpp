@@ -0,0 +1,396 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/Time.h>
+#include <engine/Graphics.h>
+#include <engine/Math.h>
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <components/Mover2D.h>
+#include <components/Solid.h>
+#include <components/Tilemap.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // Every enemy turned into a solid, and then some
+    constexpr int solidCount = 2000;
+    constexpr int columns = 50;
+    constexpr int spacing = 24;
+    constexpr int size = 12;
+    constexpr int frames = 20;
+
+    // Fewer, further apart and grapple fast
+    constexpr int fastCount = 200;
+    constexpr int fastSpacing = 160;
+    constexpr int fastSpeed = 40;
+
+    // Gives movers that bumped into something a new direction, so everything keeps moving
+    class WanderSystem : public System
+    {
+    public:
+        std::mt19937 m_random{ 7 };
+        int m_maxSpeed = 3;
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::PreUpdate, sig);
+        }
+
+        float speed()
+        {
+            // Up to m_maxSpeed pixels a frame, in either direction
+            std::uniform_int_distribution<int> dist(-m_maxSpeed, m_maxSpeed);
+            return static_cast<float>(dist(m_random)) / Graphics::resMult;
+        }
+
+        void update() override
+        {
+            for (auto [ent, mover] : m_scene->view<Mover2D>())
+            {
+                if (mover.velocity.x == 0.0f)
+                {
+                    mover.velocity.x = speed();
+                }
+                if (mover.velocity.y == 0.0f)
+                {
+                    mover.velocity.y = speed();
+                }
+            }
+        }
+    };
+
+    // How UpdateMoveAndCollide2D collided before the grid: every solid, for every pixel moved
+    class LinearMoveAndCollide : public System
+    {
+    public:
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Transform2D>());
+            sig.set(m_scene->getComponentType<Collider2D>());
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::Update, sig);
+        }
+
+        bool checkCollision(Entity self, const Recti &rect)
+        {
+            for (auto [otherEnt, solid, otherCollider, otherTransform] : m_scene->view<const Solid, const Collider2D, const Transform2D>())
+            {
+                if (otherEnt != self && rect.overlaps(otherCollider.rect))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void update() override
+        {
+            for (auto [ent, transform, collider, mover] : m_scene->view<Transform2D, Collider2D, Mover2D>())
+            {
+                Vec2f total = mover.remainder + (mover.velocity * Graphics::resMult) * Time::delta;
+                Vec2i toMove = Vec2i(static_cast<int>(total.x), static_cast<int>(total.y));
+                mover.remainder = total - toMove;
+
+                for (int axis = 0; axis < 2; axis++)
+                {
+                    int amt = axis == 0 ? toMove.x : toMove.y;
+                    int sign = Math::sign(amt);
+                    Vec2i step = axis == 0 ? Vec2i(sign, 0) : Vec2i(0, sign);
+                    while (amt != 0)
+                    {
+                        if (checkCollision(ent, collider.rect + step))
+                        {
+                            if (axis == 0)
+                            {
+                                mover.velocity.x = 0;
+                                mover.remainder.x = 0;
+                            }
+                            else
+                            {
+                                mover.velocity.y = 0;
+                                mover.remainder.y = 0;
+                            }
+                            break;
+                        }
+                        amt -= sign;
+                        transform.pos += step;
+                        collider.rect = collider.rect + step;
+                    }
+                }
+            }
+        }
+    };
+
+    template <class MoveSystem>
+    class SolidScene : public Scene
+    {
+    public:
+        SolidScene(int count = solidCount, int gap = spacing, int maxSpeed = 3)
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Solid>();
+            registerComponent<Tilemap>();
+
+            registerSystem<WanderSystem>();
+            registerSystem<MoveSystem>();
+            registerSystem<UpdateSolids>();
+            registerSystem<UpdateTilemap>();
+            getSystem<WanderSystem>()->m_maxSpeed = maxSpeed;
+
+            const int rows = (count + columns - 1) / columns;
+            const Vec2i area(columns * gap, rows * gap);
+
+            // Walls around the crowd
+            addWall(Recti(-gap, -gap, area.x + gap * 2, gap));
+            addWall(Recti(-gap, area.y, area.x + gap * 2, gap));
+            addWall(Recti(-gap, 0, gap, area.y));
+            addWall(Recti(area.x, 0, gap, area.y));
+
+            for (int i = 0; i < count; i++)
+            {
+                Vec2i pos((i % columns) * gap, (i / columns) * gap);
+
+                Entity ent = createEntity();
+                Transform2D transform;
+                transform.pos = pos;
+                addComponent(ent, transform);
+                addComponent(ent, Collider2D{ Recti(pos, Vec2i(size, size)) });
+                addComponent(ent, Mover2D());
+                addComponent(ent, Solid());
+            }
+        }
+
+        void addWall(const Recti &rect)
+        {
+            Entity ent = createEntity();
+            Transform2D transform;
+            transform.pos = Vec2i(rect.x, rect.y);
+            addComponent(ent, transform);
+            addComponent(ent, Collider2D{ rect });
+            addComponent(ent, Solid());
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+
+        std::vector<Vec2i> positions()
+        {
+            std::vector<Vec2i> result;
+            for (auto [ent, transform] : view<const Transform2D>())
+            {
+                result.push_back(transform.pos);
+            }
+            return result;
+        }
+    };
+
+    // Same room as GameScene: the outer walls baked into a tilemap, the two middle blocks as solids.
+    // A single mover is driven by a recorded trace of velocities, one per frame.
+    class TraceScene : public Scene
+    {
+    public:
+        Entity m_mover = NULL_ENTITY;
+
+        TraceScene(UpdateMoveAndCollide2D::MoveMode mode, const Recti &start)
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Solid>();
+            registerComponent<Tilemap>();
+
+            registerSystem<UpdateMoveAndCollide2D>();
+            registerSystem<UpdateSolids>();
+            registerSystem<UpdateTilemap>();
+            getSystem<UpdateMoveAndCollide2D>()->m_moveMode = mode;
+
+            Tilemap tilemap;
+            TilemapCommon::resize(tilemap, Vec2i(0, 0), 8, 1920 / 8, 1080 / 8);
+            TilemapCommon::fillRect(tilemap, Recti(0, 0, 88, 1080), Tilemap::CellSolid);
+            TilemapCommon::fillRect(tilemap, Recti(1832, 0, 88, 1080), Tilemap::CellSolid);
+            TilemapCommon::fillRect(tilemap, Recti(0, 0, 1920, 72), Tilemap::CellSolid);
+            TilemapCommon::fillRect(tilemap, Recti(0, 1008, 1920, 72), Tilemap::CellSolid);
+            Entity map = createEntity();
+            addComponent(map, std::move(tilemap));
+
+            addBlock(Recti(700, 520, 520, 40));
+            addBlock(Recti(890, 472, 140, 136));
+
+            m_mover = createEntity();
+            Transform2D transform;
+            transform.pos = Vec2i(start.x, start.y);
+            addComponent(m_mover, transform);
+            addComponent(m_mover, Collider2D{ start });
+            addComponent(m_mover, Mover2D());
+        }
+
+        void addBlock(const Recti &rect)
+        {
+            Entity ent = createEntity();
+            Transform2D transform;
+            transform.pos = Vec2i(rect.x, rect.y);
+            addComponent(ent, transform);
+            addComponent(ent, Collider2D{ rect });
+            addComponent(ent, Solid());
+        }
+
+        // Move through one frame of the trace (in pixels), returns what the mover ran into
+        std::vector<MoverHit> step(const Vec2f &velocity)
+        {
+            getComponent<Mover2D>(m_mover).velocity = velocity / Graphics::resMult;
+            mSystemManager.update();
+
+            const EventBuffer<MoverHit> &hits = getSystem<UpdateMoveAndCollide2D>()->m_hits;
+            return std::vector<MoverHit>(hits.begin(), hits.end());
+        }
+    };
+
+    bool sameHits(const std::vector<MoverHit> &a, const std::vector<MoverHit> &b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const MoverHit &l, const MoverHit &r)
+            {
+                return l.ent == r.ent && l.other == r.other && l.dir == r.dir && l.velocity == r.velocity;
+            });
+    }
+
+    // Runs a trace through a scene in each move mode, they have to agree every frame
+    bool traceMatches(const Recti &start, const std::vector<Vec2f> &trace)
+    {
+        TraceScene pixel(UpdateMoveAndCollide2D::MoveMode::Pixel, start);
+        TraceScene swept(UpdateMoveAndCollide2D::MoveMode::Swept, start);
+
+        for (const Vec2f &velocity : trace)
+        {
+            if (!sameHits(pixel.step(velocity), swept.step(velocity)))
+            {
+                return false;
+            }
+
+            const Mover2D &pixelMover = pixel.readComponent<Mover2D>(pixel.m_mover);
+            const Mover2D &sweptMover = swept.readComponent<Mover2D>(swept.m_mover);
+            if (pixel.readComponent<Transform2D>(pixel.m_mover).pos != swept.readComponent<Transform2D>(swept.m_mover).pos ||
+                pixel.readComponent<Collider2D>(pixel.m_mover).rect != swept.readComponent<Collider2D>(swept.m_mover).rect ||
+                pixelMover.remainder != sweptMover.remainder || pixelMover.velocity != sweptMover.velocity)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void expectTraceMatches(const char *name, const Recti &start, const std::vector<Vec2f> &trace)
+    {
+        bool match = traceMatches(start, trace);
+        printf("  Trace \"%s\" %s\n", name, match ? "matches" : "DOESN'T MATCH");
+        if (!match)
+        {
+            Benchmark::failures++;
+        }
+    }
+}
+
+void Benchmark::spatialGrid()
+{
+    printf("-- Solid broadphase (%d moving solids, %d frames) --\n", solidCount, frames);
+
+    const float delta = Time::delta;
+    Time::delta = 1.0f;
+
+    SolidScene<LinearMoveAndCollide> linear;
+    SolidScene<UpdateMoveAndCollide2D> grid;
+    // Only the broadphase differs, see sweptMovement for the rest
+    grid.getSystem<UpdateMoveAndCollide2D>()->m_moveMode = UpdateMoveAndCollide2D::MoveMode::Pixel;
+
+    float linearMs = time(frames, [&]() { linear.step(); });
+    float gridMs = time(frames, [&]() { grid.step(); });
+    report("scan every solid -> spatial grid", linearMs, gridMs);
+
+    // Both have to have moved everything to the same place
+    bool match = linear.positions() == grid.positions();
+    printf("  Positions %s\n", match ? "match" : "DON'T MATCH");
+    if (!match)
+    {
+        failures++;
+    }
+
+    Time::delta = delta;
+}
+
+void Benchmark::sweptMovement()
+{
+    printf("-- Swept movement (%d solids moving up to %dpx a frame, %d frames) --\n", fastCount, fastSpeed, frames);
+
+    const float delta = Time::delta;
+    Time::delta = 1.0f;
+
+    SolidScene<UpdateMoveAndCollide2D> pixel(fastCount, fastSpacing, fastSpeed);
+    SolidScene<UpdateMoveAndCollide2D> swept(fastCount, fastSpacing, fastSpeed);
+    pixel.getSystem<UpdateMoveAndCollide2D>()->m_moveMode = UpdateMoveAndCollide2D::MoveMode::Pixel;
+    swept.getSystem<UpdateMoveAndCollide2D>()->m_moveMode = UpdateMoveAndCollide2D::MoveMode::Swept;
+
+    float pixelMs = time(frames, [&]() { pixel.step(); });
+    float sweptMs = time(frames, [&]() { swept.step(); });
+    report("pixel steps -> swept", pixelMs, sweptMs);
+
+    // Has to be exactly the same movement, just found faster
+    bool match = pixel.positions() == swept.positions();
+    printf("  Positions %s\n", match ? "match" : "DON'T MATCH");
+    if (!match)
+    {
+        failures++;
+    }
+
+    // Recorded traces against walls and blocks, checking hits, remainders and velocities too
+    {
+        // Shot at the right wall, reeled in at full speed, bounced off
+        std::vector<Vec2f> trace;
+        for (int i = 0; i < 50; i++)
+        {
+            trace.push_back(Vec2f(39.7f, -3.25f));
+        }
+        for (int i = 0; i < 10; i++)
+        {
+            trace.push_back(Vec2f(-12.5f, 6.1f));
+        }
+        expectTraceMatches("grapple into wall", Recti(200, 300, 24, 40), trace);
+    }
+    {
+        // Falling with gravity onto the middle block, sliding along its top
+        std::vector<Vec2f> trace;
+        float fall = 0.0f;
+        for (int i = 0; i < 90; i++)
+        {
+            fall += 0.35f;
+            trace.push_back(Vec2f(i < 45 ? 1.3f : -2.7f, fall));
+        }
+        expectTraceMatches("falling onto block", Recti(900, 100, 24, 40), trace);
+    }
+    {
+        // Slow enough that the remainder does most of the work
+        std::vector<Vec2f> trace;
+        for (int i = 0; i < 200; i++)
+        {
+            trace.push_back(Vec2f(-0.37f * (i % 7), 0.55f - 0.2f * (i % 5)));
+        }
+        expectTraceMatches("sub-pixel speeds", Recti(96, 80, 24, 40), trace);
+    }
+    // Spawned overlapping the block, neither mode may move it further in
+    expectTraceMatches("starting inside solid", Recti(880, 500, 24, 40), { Vec2f(5.0f, 0.0f), Vec2f(0.0f, -5.0f), Vec2f(-8.0f, 8.0f) });
+
+    Time::delta = delta;
+}
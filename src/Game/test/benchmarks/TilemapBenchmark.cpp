@@ -0,0 +1,268 @@
+#include "Benchmark.h"
+
+#include <engine/Ecs.h>
+#include <engine/Time.h>
+#include <engine/Graphics.h>
+#include <engine/AabbTree.h>
+
+#include <engine/components/Transform2D.h>
+#include <engine/components/Collider2D.h>
+#include <components/Mover2D.h>
+#include <components/Solid.h>
+#include <components/Tilemap.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Engine;
+using namespace GS;
+
+namespace
+{
+    // A big cave level, the kind that would take thousands of wall entities
+    constexpr int cells = 128;
+    constexpr int tileSize = 8;
+    constexpr int wallChance = 20;
+    constexpr int moverCount = 300;
+    constexpr int moverSize = 6;
+    constexpr int frames = 20;
+
+    constexpr int rayCount = 2000;
+    constexpr int rayLength = 400;
+
+    // Which cells are walls, the border always is
+    std::vector<bool> makeLevel()
+    {
+        std::mt19937 random(21);
+        std::uniform_int_distribution<int> chance(0, 99);
+
+        std::vector<bool> walls(cells * cells);
+        for (int y = 0; y < cells; y++)
+        {
+            for (int x = 0; x < cells; x++)
+            {
+                const bool border = x == 0 || y == 0 || x == cells - 1 || y == cells - 1;
+                walls[y * cells + x] = border || chance(random) < wallChance;
+            }
+        }
+        return walls;
+    }
+
+    // Gives movers that bumped into something a new direction, so everything keeps moving
+    class WanderSystem : public System
+    {
+    public:
+        std::mt19937 m_random{ 13 };
+
+        void init() override
+        {
+            Signature sig;
+            sig.set(m_scene->getComponentType<Mover2D>());
+            setup(0, Type::PreUpdate, sig);
+        }
+
+        float speed()
+        {
+            std::uniform_int_distribution<int> dist(-6, 6);
+            return static_cast<float>(dist(m_random)) / Graphics::resMult;
+        }
+
+        void update() override
+        {
+            for (auto [ent, mover] : m_scene->view<Mover2D>())
+            {
+                if (mover.velocity.x == 0.0f)
+                {
+                    mover.velocity.x = speed();
+                }
+                if (mover.velocity.y == 0.0f)
+                {
+                    mover.velocity.y = speed();
+                }
+            }
+        }
+    };
+
+    class LevelScene : public Scene
+    {
+    public:
+        LevelScene(const std::vector<bool> &walls, bool baked)
+        {
+            registerComponent<Transform2D>();
+            registerComponent<Collider2D>();
+            registerComponent<Mover2D>();
+            registerComponent<Solid>();
+            registerComponent<Tilemap>();
+
+            registerSystem<WanderSystem>();
+            registerSystem<UpdateMoveAndCollide2D>();
+            registerSystem<UpdateSolids>();
+            registerSystem<UpdateTilemap>();
+
+            if (baked)
+            {
+                Entity ent = createEntity();
+                Tilemap tilemap;
+                TilemapCommon::resize(tilemap, Vec2i(0, 0), tileSize, cells, cells);
+                for (int i = 0; i < cells * cells; i++)
+                {
+                    if (walls[i])
+                    {
+                        TilemapCommon::setCell(tilemap, i % cells, i / cells, Tilemap::CellSolid);
+                    }
+                }
+                addComponent(ent, std::move(tilemap));
+            }
+            else
+            {
+                // An entity per wall cell
+                for (int i = 0; i < cells * cells; i++)
+                {
+                    if (walls[i])
+                    {
+                        const Vec2i pos((i % cells) * tileSize, (i / cells) * tileSize);
+                        Entity ent = createEntity();
+                        Transform2D transform;
+                        transform.pos = pos;
+                        addComponent(ent, transform);
+                        addComponent(ent, Collider2D{ Recti(pos, Vec2i(tileSize, tileSize)) });
+                        addComponent(ent, Solid());
+                    }
+                }
+            }
+
+            // Movers start in open cells, and don't collide with each other
+            std::mt19937 random(5);
+            std::uniform_int_distribution<int> cell(0, cells * cells - 1);
+            for (int placed = 0; placed < moverCount;)
+            {
+                const int i = cell(random);
+                if (walls[i])
+                {
+                    continue;
+                }
+
+                const Vec2i pos((i % cells) * tileSize + 1, (i / cells) * tileSize + 1);
+                Entity ent = createEntity();
+                Transform2D transform;
+                transform.pos = pos;
+                addComponent(ent, transform);
+                addComponent(ent, Collider2D{ Recti(pos, Vec2i(moverSize, moverSize)) });
+                addComponent(ent, Mover2D());
+                placed++;
+            }
+        }
+
+        void step()
+        {
+            mSystemManager.update();
+        }
+
+        std::vector<Vec2i> positions()
+        {
+            std::vector<Vec2i> result;
+            for (auto [ent, transform, mover] : view<const Transform2D, const Mover2D>())
+            {
+                result.push_back(transform.pos);
+            }
+            return result;
+        }
+    };
+}
+
+void Benchmark::tilemap()
+{
+    const std::vector<bool> walls = makeLevel();
+    int wallCount = 0;
+    for (bool wall : walls)
+    {
+        wallCount += wall;
+    }
+
+    printf("-- Tilemap level (%d wall cells, %d movers, %d frames) --\n", wallCount, moverCount, frames);
+
+    const float delta = Time::delta;
+    Time::delta = 1.0f;
+
+    // Movement
+    {
+        LevelScene entities(walls, false);
+        LevelScene baked(walls, true);
+
+        float entityMs = time(frames, [&]() { entities.step(); });
+        float bakedMs = time(frames, [&]() { baked.step(); });
+        report("solid entities -> tilemap", entityMs, bakedMs);
+
+        bool match = entities.positions() == baked.positions();
+        printf("  Positions %s\n", match ? "match" : "DON'T MATCH");
+        if (!match)
+        {
+            failures++;
+        }
+    }
+
+    Time::delta = delta;
+
+    // Line of sight, grapplable walls in a tree against walking the cells
+    {
+        Tilemap tilemap;
+        TilemapCommon::resize(tilemap, Vec2i(0, 0), tileSize, cells, cells);
+        AabbTree tree;
+        for (int i = 0; i < cells * cells; i++)
+        {
+            if (walls[i])
+            {
+                TilemapCommon::setCell(tilemap, i % cells, i / cells, Tilemap::CellGrapplable);
+                tree.insert(static_cast<Entity>(i), TilemapCommon::cellRect(tilemap, i % cells, i / cells));
+            }
+        }
+
+        std::mt19937 random(3);
+        std::uniform_int_distribution<int> place(0, cells * tileSize - 1);
+        std::uniform_int_distribution<int> reach(-rayLength, rayLength);
+        std::vector<Linei> rays;
+        for (int i = 0; i < rayCount; i++)
+        {
+            const Vec2i start(place(random), place(random));
+            rays.push_back(Linei(start, start + Vec2i(reach(random), reach(random))));
+        }
+
+        std::vector<RayHit> treeHits(rayCount);
+        std::vector<RayHit> cellHits(rayCount);
+
+        float treeMs = time(frames, [&]()
+            {
+                for (int i = 0; i < rayCount; i++)
+                {
+                    tree.raycastClosest(rays[i], rays[i].a, &treeHits[i]);
+                }
+            });
+        float cellMs = time(frames, [&]()
+            {
+                for (int i = 0; i < rayCount; i++)
+                {
+                    Vec2i point;
+                    cellHits[i] = RayHit();
+                    if (TilemapCommon::raycast(tilemap, rays[i], rays[i].a, Tilemap::CellGrapplable, &point))
+                    {
+                        cellHits[i].point = point;
+                        cellHits[i].distanceSquared = (rays[i].a - point).lengthSquared();
+                    }
+                }
+            });
+        report("wall AABB tree -> tilemap DDA", treeMs, cellMs);
+
+        // Same point at the same distance
+        bool match = true;
+        for (int i = 0; i < rayCount; i++)
+        {
+            match = match && treeHits[i].point == cellHits[i].point && treeHits[i].distanceSquared == cellHits[i].distanceSquared;
+        }
+        printf("  Hits %s\n", match ? "match" : "DON'T MATCH");
+        if (!match)
+        {
+            failures++;
+        }
+    }
+}